@@ -8,6 +8,9 @@
 
 #include "App.h"
 
+#include <sstream>
+#include <unistd.h>
+
 
 Ref<Frontend> App::getFrontend()
 {
@@ -21,34 +24,535 @@ Ref<Frontend> App::getFrontend()
 	//
 	//return new WAVStream(input);
 	
+	string origin = config()->get("location_name", "unknown")->asString();
+	
 	if (options().args().size() > 0) {
-		string fileName = options().args()[0];
-		LOG_INFO("Using WAV frontend, reading " << fileName << "...");
-		return new WAVStream(new FileInput(fileName));
+		int threads = config()->get("wav_threads", "1")->asInteger();
+		if (threads < 1) threads = sysconf(_SC_NPROCESSORS_ONLN);
+		
+		// The replay is paced by a single thread.
+		bool replay = (config()->get("wav_replay", "0")->asInteger() != 0);
+		if (replay) threads = 1;
+		
+		Ref<Frontend> frontend = getFileFrontend(options().args()[0], "", threads);
+		
+		if (replay) {
+			float speed = config()->get("wav_replay_speed", "1")->asFloat();
+			if (speed > 0) {
+				LOG_INFO("Replaying at " << speed << "x real time.");
+			} else {
+				LOG_INFO("Replaying at unlimited speed.");
+			}
+			
+			ReplayClock *clock = new ReplayClock(speed);
+			Clock::setDefault(clock);
+			frontend->setPacingClock(clock);
+		}
+		
+		// Time of the first sample in UTC.
+		string startTime = config()->get("wav_start_time", "")->asString();
+		if (!startTime.empty()) {
+			WFTime time;
+			if (WFTime::parse(startTime, &time)) {
+				frontend->setStartTime(time);
+			} else {
+				LOG_ERROR("Invalid WAV start time \"" << startTime <<
+						"\" (expected YYYY-MM-DD HH:MM:SS).");
+			}
+		}
+		
+		return frontend;
+	} else if (!config()->get("iq_input", "")->asString().empty()) {
+		return getRawIQFrontend(origin);
+	} else if (!config()->get("sample_bus_input", "")->asString().empty()) {
+		return getSampleBusFrontend(origin);
+	} else if (config()->get("udp_port", "0")->asInteger() > 0) {
+		return getUDPFrontend(origin);
+	} else if (!config()->get("generator_signals", "")->asString().empty()) {
+		return getGeneratorFrontend(origin);
 	} else {
 		LOG_INFO("Using JACK frontend.");
-		return new JackFrontend(
-			config()->get("jack_left_port",  "system:capture_1")->asString().c_str(),
-			config()->get("jack_right_port", "system:capture_2")->asString().c_str()
+		return getJackFrontend(origin);
+	}
+}
+
+
+Ref<Frontend> App::getRawIQFrontend(string origin)
+{
+	Ref<Config> cfg = config();
+	
+	string input = cfg->get("iq_input", "-")->asString();
+	string formatName = cfg->get("iq_format", "u8")->asString();
+	
+	SampleFormat format;
+	if (!RawIQFrontend::parseFormat(formatName, &format)) {
+		LOG_ERROR("Unknown IQ sample format \"" << formatName <<
+				"\" (expected u8, s16 or cf32), using u8.");
+		format = SAMPLE_COMPLEX_UINT8;
+	}
+	
+	LOG_INFO("Using raw IQ frontend, reading " << formatName << " samples from " <<
+		    input << "...");
+	
+	RawIQFrontend *frontend = new RawIQFrontend(
+		input,
+		format,
+		cfg->get("iq_sample_rate", "2048000")->asInteger(),
+		cfg->get("iq_block_size", "65536")->asInteger()
+	);
+	frontend->setRealTime(cfg->get("iq_real_time", "1")->asInteger() != 0);
+	
+	// Time of the first sample in UTC.
+	string startTime = cfg->get("iq_start_time", "")->asString();
+	if (!startTime.empty()) {
+		WFTime time;
+		if (WFTime::parse(startTime, &time)) {
+			frontend->setStartTime(time);
+		} else {
+			LOG_ERROR("Invalid IQ start time \"" << startTime <<
+					"\" (expected YYYY-MM-DD HH:MM:SS).");
+		}
+	}
+	
+	frontend->setBackend(getLiveBackend(origin));
+	return frontend;
+}
+
+
+Ref<Frontend> App::getUDPFrontend(string origin)
+{
+	Ref<Config> cfg = config();
+	
+	string address = cfg->get("udp_address", "0.0.0.0")->asString();
+	int port = cfg->get("udp_port", "0")->asInteger();
+	string formatName = cfg->get("udp_format", "s16")->asString();
+	int sampleRate = cfg->get("udp_sample_rate", "48000")->asInteger();
+	
+	SampleFormat format;
+	if (!RawIQFrontend::parseFormat(formatName, &format)) {
+		LOG_ERROR("Unknown UDP sample format \"" << formatName <<
+				"\" (expected u8, s16 or cf32), using s16.");
+		format = SAMPLE_COMPLEX_INT16;
+	}
+	
+	LOG_INFO("Using UDP frontend, receiving " << formatName << " samples on " <<
+		    address << ":" << port << "...");
+	
+	UDPFrontend *frontend = new UDPFrontend(
+		address,
+		port,
+		format,
+		sampleRate,
+		cfg->get("udp_ring_packets", "1024")->asInteger()
+	);
+	frontend->setSocketBufferSize(cfg->get("udp_socket_buffer", "33554432")->asInteger());
+	frontend->setMaxGapFill((long)(cfg->get("udp_max_gap", "1.0")->asFloat() * sampleRate));
+	frontend->setTimeout(cfg->get("udp_timeout", "0")->asFloat());
+	
+	// Time of the first sample in UTC.
+	string startTime = cfg->get("udp_start_time", "")->asString();
+	if (!startTime.empty()) {
+		WFTime time;
+		if (WFTime::parse(startTime, &time)) {
+			frontend->setStartTime(time);
+		} else {
+			LOG_ERROR("Invalid UDP start time \"" << startTime <<
+					"\" (expected YYYY-MM-DD HH:MM:SS).");
+		}
+	}
+	
+	frontend->setBackend(getLiveBackend(origin));
+	return frontend;
+}
+
+
+Ref<Frontend> App::getSampleBusFrontend(string origin)
+{
+	Ref<Config> cfg = config();
+	
+	// The name of the bus of another instance, e.g. "waterfall_svakov".
+	string name = cfg->get("sample_bus_input", "")->asString();
+	if (name[0] != '/') name = "/" + name;
+	
+	LOG_INFO("Using sample bus frontend, reading samples from \"" << name << "\".");
+	
+	SampleBusFrontend *frontend = new SampleBusFrontend(name);
+	frontend->setTimeout(cfg->get("sample_bus_timeout", "0")->asFloat());
+	frontend->setReportInterval(cfg->get("sample_bus_report", "60")->asFloat());
+	frontend->setPollInterval(cfg->get("sample_bus_poll", "1000")->asInteger());
+	
+	frontend->setBackend(getBackend(origin, "", true));
+	return frontend;
+}
+
+
+Ref<Frontend> App::getGeneratorFrontend(string origin)
+{
+	Ref<Config> cfg = config();
+	
+	string signals = cfg->get("generator_signals", "")->asString();
+	
+	GeneratorFrontend *frontend = new GeneratorFrontend(
+		cfg->get("generator_sample_rate", "48000")->asInteger(),
+		cfg->get("generator_block_size", "65536")->asInteger()
+	);
+	if (!frontend->addSignals(signals)) {
+		LOG_ERROR("Invalid generator signals \"" << signals << "\".");
+	}
+	frontend->setDuration(cfg->get("generator_duration", "0")->asFloat());
+	frontend->setRealTime(cfg->get("generator_real_time", "1")->asInteger() != 0);
+	frontend->setSeed(cfg->get("generator_seed", "1")->asInteger());
+	
+	LOG_INFO("Using generator frontend (" << signals << ").");
+	
+	frontend->setBackend(getLiveBackend(origin));
+	return frontend;
+}
+
+
+/**
+ * Returns a frontend reading a WAV file, with the snapshots written to
+ * \c directory (the working directory if empty).
+ */
+Ref<Frontend> App::getFileFrontend(string fileName, string directory, int threads)
+{
+	string origin = config()->get("location_name", "unknown")->asString();
+	Ref<Frontend> frontend;
+	
+	if (config()->get("wav_reader", "mmap")->asString() == "stream") {
+		LOG_INFO("Using WAV frontend, reading " << fileName << "...");
+		frontend = new WAVStream(new FileInput(fileName), fileName);
+		frontend->setBackend(getBackend(origin, directory));
+	} else if (threads > 1) {
+		LOG_INFO("Using parallel memory-mapped WAV frontend with " <<
+			    threads << " threads, reading " << fileName << "...");
+		ParallelWAVFrontend *parallel = new ParallelWAVFrontend(
+			fileName,
+			config()->get("wav_block_size", "65536")->asInteger()
+		);
+		frontend = parallel;
+		for (int i = 0; i < threads; i++)
+			parallel->addBackend(getBackend(origin, directory));
+	} else {
+		LOG_INFO("Using memory-mapped WAV frontend, reading " << fileName << "...");
+		frontend = new MappedWAVFrontend(
+			fileName,
+			config()->get("wav_block_size", "65536")->asInteger()
 		);
+		frontend->setBackend(getBackend(origin, directory));
+	}
+	
+	// Part of the file to be processed.
+	StreamPosition start, end;
+	string startText = config()->get("wav_start", "")->asString();
+	string endText   = config()->get("wav_end", "")->asString();
+	if (!StreamPosition::parse(startText, &start)) {
+		LOG_ERROR("Invalid WAV start position \"" << startText << "\".");
+	} else if (!StreamPosition::parse(endText, &end)) {
+		LOG_ERROR("Invalid WAV end position \"" << endText << "\".");
+	} else {
+		frontend->setRange(start, end);
 	}
+	
+	return frontend;
+}
+
+
+/**
+ * Creates the pipeline of a file of a batch. The files of a batch are
+ * processed in parallel, so each of them is read by a single thread.
+ */
+Ref<Frontend> App::createFrontend(const string &fileName, const string &outputDirectory)
+{
+	MutexLock lock(&factoryMutex_);
+	
+	return getFileFrontend(fileName, outputDirectory, 1);
+}
+
+
+/**
+ * Returns whether the command line arguments are a batch of files rather
+ * than a single file.
+ */
+bool App::isBatch()
+{
+	const vector<string> &args = options().args();
+	return (args.size() > 1) || ((args.size() == 1) && Batch::isBatchInput(args[0]));
 }
 
 
-Ref<Backend> App::getBackend()
+int App::runBatch()
+{
+	int threads = config()->get("batch_threads", "0")->asInteger();
+	if (threads < 1) threads = sysconf(_SC_NPROCESSORS_ONLN);
+	
+	Ref<Batch> batch = new Batch(
+		this,
+		threads,
+		config()->get("batch_output", ".")->asString()
+	);
+	
+	const vector<string> &args = options().args();
+	for (unsigned i = 0; i < args.size(); i++)
+		batch->addInput(args[i]);
+	
+	return (batch->run() > 0) ? 1 : 0;
+}
+
+
+/**
+ * Returns the renderer of the PNG images of the snapshots.
+ */
+SpectrogramRenderer App::getRenderer()
 {
 	Ref<Config> cfg = config();
 	
-	return new WaterfallBackend(
-		cfg->get("fft_bins",    "32768")->asInteger(),
-		cfg->get("fft_overlap", "24576")->asInteger(),
+	SpectrogramRenderer renderer;
+	
+	string scale = cfg->get("render_scale", "log")->asString();
+	SpectrogramScale scaleValue;
+	if (SpectrogramRenderer::parseScale(scale, &scaleValue)) {
+		renderer.setScale(scaleValue);
+	} else {
+		LOG_ERROR("Unknown render scale \"" << scale << "\" (expected id or log).");
+	}
+	
+	string colormap = cfg->get("render_colormap", "gray")->asString();
+	SpectrogramColormap colormapValue;
+	if (SpectrogramRenderer::parseColormap(colormap, &colormapValue)) {
+		renderer.setColormap(colormapValue);
+	} else {
+		LOG_ERROR("Unknown render colour map \"" << colormap <<
+				"\" (expected gray or hot).");
+	}
+	
+	// Cut-offs of the values, the minimum and maximum of a snapshot by
+	// default.
+	if (!cfg->get("render_min", "")->asString().empty())
+		renderer.setMin(cfg->get("render_min", "0")->asFloat());
+	if (!cfg->get("render_max", "")->asString().empty())
+		renderer.setMax(cfg->get("render_max", "0")->asFloat());
+	
+	renderer.setWidth(cfg->get("render_width", "0")->asInteger());
+	
+	return renderer;
+}
+
+
+/**
+ * Returns whether the snapshots given on the command line are to be
+ * rendered ("waterfall render FILE...").
+ */
+bool App::isRender()
+{
+	const vector<string> &args = options().args();
+	return (args.size() > 0) && (args[0] == "render");
+}
+
+
+int App::runRender()
+{
+	int threads = config()->get("render_threads", "0")->asInteger();
+	if (threads < 1) threads = sysconf(_SC_NPROCESSORS_ONLN);
+	
+	Ref<RenderBatch> batch = new RenderBatch(getRenderer(), threads);
+	
+	const vector<string> &args = options().args();
+	for (unsigned i = 1; i < args.size(); i++)
+		batch->addInput(args[i]);
+	
+	if (batch->getFileCount() == 0) {
+		LOG_ERROR("No FITS files to render.");
+		return 1;
+	}
+	
+	return (batch->run() > 0) ? 1 : 0;
+}
+
+
+Ref<Frontend> App::getJackFrontend(string origin)
+{
+	Ref<Config> cfg = config();
+	
+	JackFrontend *frontend = new JackFrontend(
+		cfg->get("jack_left_port",  "system:capture_1")->asString().c_str(),
+		cfg->get("jack_right_port", "system:capture_2")->asString().c_str(),
+		cfg->get("jack_ring_length", "2.0")->asFloat()
+	);
+	
+	// Fractions of the JACK period used by the process callback.
+	DeadlineMonitor &deadlines = frontend->getDeadlineMonitor();
+	deadlines.setNearMissThreshold(cfg->get("jack_near_miss", "0.8")->asFloat());
+	deadlines.setWarningThreshold(cfg->get("jack_deadline_warning", "0.5")->asFloat());
+	
+	// Several IQ port pairs, each in the form NAME LEFT_PORT RIGHT_PORT [CPU],
+	// separated by commas.
+	string channels = cfg->get("jack_channels", "")->asString();
+	
+	istringstream channelsStream(channels);
+	string channel;
+	while (getline(channelsStream, channel, ',')) {
+		istringstream channelStream(channel);
+		string name, leftPort, rightPort;
+		int    cpu = -1;
+		
+		if (!(channelStream >> name >> leftPort >> rightPort)) {
+			if (!name.empty()) {
+				LOG_ERROR("Invalid JACK channel \"" << channel <<
+						"\" (expected NAME LEFT_PORT RIGHT_PORT [CPU]).");
+			}
+			continue;
+		}
+		if (!(channelStream >> cpu)) cpu = -1;
 		
-		config()->get("location_name",         "unknown")->asString(),
+		LOG_INFO("Adding JACK channel \"" << name << "\" (" << leftPort <<
+			    ", " << rightPort << ").");
+		frontend->addChannel(
+			new JackChannel(name, leftPort, rightPort, cpu),
+			getLiveBackend(origin + "_" + name)
+		);
+	}
+	
+	if (frontend->getChannelCount() == 0)
+		frontend->setBackend(getLiveBackend(origin));
+	
+	return frontend;
+}
+
+
+/**
+ * Returns the backend of a live frontend, publishing the samples to a
+ * sample bus for other instances if configured.
+ */
+Ref<Backend> App::getLiveBackend(string origin)
+{
+	Ref<Config> cfg = config();
+	
+	string bus = cfg->get("sample_bus", "")->asString();
+	if (bus.empty()) return getBackend(origin, "", true);
+	
+	// Only publishing, the processing is left to the readers.
+	Ref<Backend> next;
+	if (!cfg->get("sample_bus_only", "0")->asInteger())
+		next = getBackend(origin, "", true);
+	
+	return new SampleBusBackend(
+		"/" + bus + "_" + origin,
+		cfg->get("sample_bus_length", "2")->asFloat(),
+		cfg->get("sample_bus_block",  "4096")->asInteger(),
+		next
+	);
+}
+
+
+/**
+ * Returns the processing of a stream. The outputs for local viewers (see
+ * SharedSpectrumSink) are added to the live streams only: the segments
+ * of files processed in parallel and the batch workers would publish
+ * under the same name.
+ */
+Ref<Backend> App::getBackend(string origin, string directory, bool live)
+{
+	Ref<Config> cfg = config();
+	
+	string resolutions = cfg->get("fft_resolutions", "")->asString();
+	
+	if (resolutions.empty()) {
+		return getWaterfallBackend(
+			cfg->get("fft_bins",    "32768")->asInteger(),
+			cfg->get("fft_overlap", "24576")->asInteger(),
+			origin,
+			directory,
+			live
+		);
+	}
+	
+	// Several resolutions, each in the form BINS/OVERLAP, separated by commas.
+	MultiBackend *backend = new MultiBackend(
+		cfg->get("fft_history_blocks", "256")->asInteger()
+	);
+	
+	istringstream resolutionsStream(resolutions);
+	string resolution;
+	while (getline(resolutionsStream, resolution, ',')) {
+		istringstream resolutionStream(resolution);
+		int  bins, overlap;
+		char separator;
+		
+		if (!(resolutionStream >> bins >> separator >> overlap) ||
+		    (separator != '/') || (bins < 1)) {
+			LOG_ERROR("Invalid FFT resolution \"" << resolution <<
+					"\" (expected BINS/OVERLAP).");
+			continue;
+		}
+		
+		ostringstream suffixed;
+		suffixed << origin << "_" << bins;
+		
+		LOG_INFO("Adding FFT resolution " << bins << "/" << overlap << ".");
+		backend->addBackend(getWaterfallBackend(bins, overlap, suffixed.str(), directory,
+		                                        live));
+	}
+	
+	return backend;
+}
+
+
+Ref<Backend> App::getWaterfallBackend(int bins, int overlap, string origin,
+                                      string directory, bool live)
+{
+	Ref<Config> cfg = config();
+	
+	WaterfallBackend *backend = new WaterfallBackend(bins, overlap);
+	
+	SnapshotSink *sink = new SnapshotSink(
+		origin,
 		// config()->get("waterfall_buffer_size", "10000")->asInteger(),
-		config()->get("waterfall_snapshot_length", "1")->asFloat(),
-		config()->get("waterfall_left_freq",   "0")->asFloat(),
-		config()->get("waterfall_right_freq",  "0")->asFloat()
+		cfg->get("waterfall_snapshot_length", "1")->asFloat(),
+		cfg->get("waterfall_left_freq",   "0")->asFloat(),
+		cfg->get("waterfall_right_freq",  "0")->asFloat(),
+		directory
 	);
+	
+	// PNG images rendered by the sink threads, without reading the
+	// snapshots back.
+	if (cfg->get("snapshot_png", "0")->asInteger())
+		sink->setRenderer(getRenderer());
+	
+	backend->addSink(sink, cfg->get("waterfall_queue_length", "10")->asFloat());
+	
+	// Downsampled levels of the waterfall for browsing long periods.
+	if (cfg->get("tile_pyramid", "0")->asInteger()) {
+		backend->addSink(
+			new TileSink(
+				origin,
+				cfg->get("tile_size",   "256")->asInteger(),
+				cfg->get("tile_levels", "8")->asInteger(),
+				cfg->get("waterfall_left_freq",   "0")->asFloat(),
+				cfg->get("waterfall_right_freq",  "0")->asFloat(),
+				directory
+			),
+			cfg->get("waterfall_queue_length", "10")->asFloat()
+		);
+	}
+	
+	// Live rows for local viewers, in a shared-memory ring named after the
+	// origin.
+	string shared = cfg->get("shm_spectrum", "")->asString();
+	if (live && !shared.empty()) {
+		backend->addSink(
+			new SharedSpectrumSink(
+				"/" + shared + "_" + origin,
+				origin,
+				cfg->get("shm_spectrum_length",   "10")->asFloat(),
+				cfg->get("waterfall_left_freq",   "0")->asFloat(),
+				cfg->get("waterfall_right_freq",  "0")->asFloat()
+			),
+			cfg->get("waterfall_queue_length", "10")->asFloat()
+		);
+	}
+	
+	return backend;
 }
 
 
@@ -80,12 +584,51 @@ int App::onRun()
 	// 	setOutput(new FileOutput(input_->getFileNameWithExt("png")));
 	// }
 	
+	// Hardware counters of the stages are written with the metrics.
+	if (config()->get("perf_counters", "0")->asInteger())
+		PerfCounters::enable();
+	
+	// Metrics are written to the stats file periodically and to the log on
+	// SIGUSR1.
+	Ref<MetricsReporter> reporter = new MetricsReporter(
+		config()->get("stats_file", "")->asString(),
+		config()->get("stats_interval", "10")->asFloat()
+	);
+	reporter->start();
+	
+	// The trace of the last trace_seconds is written on SIGUSR2 and at the
+	// end.
+	Ref<TraceWriter> tracer;
+	string traceFile = config()->get("trace_file", "")->asString();
+	if (!traceFile.empty()) {
+		Trace::setEnabled(true, config()->get("trace_buffer", "65536")->asInteger());
+		tracer = new TraceWriter(
+			traceFile,
+			config()->get("trace_seconds", "10")->asFloat()
+		);
+		tracer->start();
+	}
+	
+	if (isRender()) {
+		int result = runRender();
+		if (tracer.isNotNull()) tracer->stop();
+		reporter->stop();
+		return result;
+	}
+	
+	if (isBatch()) {
+		int result = runBatch();
+		if (tracer.isNotNull()) tracer->stop();
+		reporter->stop();
+		return result;
+	}
+	
 	Ref<Frontend> frontend = getFrontend();
-	Ref<Backend>  backend  = getBackend();
-
-	frontend->setBackend(backend);
 	frontend->run();
 	
+	if (tracer.isNotNull()) tracer->stop();
+	reporter->stop();
+	
 	// WAVStream stream(input_);
 	// //Ref<Backend> backend = new SimpleWaterfallBackend(output(), 0.2, 0.1);
 	// Ref<Backend> backend = new WaterfallBackend(
@@ -16,24 +16,63 @@ using namespace cppapp;
 
 // TODO: Remove later.
 #include "WAVStream.h"
+#include "MappedWAVFrontend.h"
+#include "ParallelWAVFrontend.h"
+#include "Batch.h"
+#include "RenderBatch.h"
+#include "RawIQFrontend.h"
+#include "UDPFrontend.h"
+#include "GeneratorFrontend.h"
+#include "SampleBusFrontend.h"
+#include "SampleBus.h"
+#include "Clock.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include "JackFrontend.h"
 #include "WaterfallBackend.h"
+#include "MultiBackend.h"
+#include "SnapshotSink.h"
+#include "TileSink.h"
+#include "SharedSpectrumSink.h"
 
 
 /**
  * \todo Write documentation for class App.
  */
-class App : public AppBase {
+class App : public AppBase, public FrontendFactory {
 private:
 	// Ref<Input> input_;
 	
+	/// The configuration is not accessed from the batch threads at once.
+	Mutex factoryMutex_;
+	
 	App(const App& other);
 
 protected:
 	// inline Ref<Input> input() { return input_; }
 	
 	Ref<Frontend> getFrontend();
-	Ref<Backend>  getBackend();
+	Ref<Frontend> getFileFrontend(string fileName, string directory, int threads);
+	Ref<Frontend> getJackFrontend(string origin);
+	Ref<Frontend> getRawIQFrontend(string origin);
+	Ref<Frontend> getUDPFrontend(string origin);
+	Ref<Frontend> getGeneratorFrontend(string origin);
+	Ref<Frontend> getSampleBusFrontend(string origin);
+	Ref<Backend>  getLiveBackend(string origin);
+	Ref<Backend>  getBackend(string origin, string directory = "",
+	                         bool live = false);
+	Ref<Backend>  getWaterfallBackend(int bins, int overlap, string origin,
+	                                  string directory = "", bool live = false);
+	
+	bool isBatch();
+	int  runBatch();
+	
+	SpectrogramRenderer getRenderer();
+	bool isRender();
+	int  runRender();
+	
+	virtual Ref<Frontend> createFrontend(const string &fileName,
+								  const string &outputDirectory);
 	
 	virtual void setUp();
 	virtual int onRun();
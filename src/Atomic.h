@@ -0,0 +1,44 @@
+/**
+ * \file   Atomic.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Relaxed atomic access to counters with a single writer.
+ */
+
+#ifndef ATOMIC_R3MW8QXC
+#define ATOMIC_R3MW8QXC
+
+#include <stdint.h>
+
+
+/**
+ * \brief Adds \c value to a counter written only by the calling thread.
+ *
+ * A plain load and store (no read-modify-write instruction), atomic only so
+ * that other threads can read the counter at any time.
+ */
+static inline void addRelaxed(uint64_t *target, uint64_t value)
+{
+	__atomic_store_n(target, __atomic_load_n(target, __ATOMIC_RELAXED) + value,
+				  __ATOMIC_RELAXED);
+}
+
+
+/**
+ * \brief Raises a maximum written only by the calling thread to \c value.
+ */
+static inline void maxRelaxed(uint64_t *target, uint64_t value)
+{
+	if (value > __atomic_load_n(target, __ATOMIC_RELAXED))
+		__atomic_store_n(target, value, __ATOMIC_RELAXED);
+}
+
+
+static inline uint64_t loadRelaxed(const uint64_t *source)
+{
+	return __atomic_load_n(source, __ATOMIC_RELAXED);
+}
+
+#endif /* end of include guard: ATOMIC_R3MW8QXC */
+
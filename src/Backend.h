@@ -10,6 +10,7 @@
 #define BACKEND_IFO2SX99
 
 #include <vector>
+#include <stdint.h>
 
 using namespace std;
 
@@ -26,6 +27,138 @@ struct Complex {
 };
 
 
+/**
+ * \brief Memory layout of the samples referenced by a SampleSpan.
+ *
+ * Frontends pass the samples in the format they receive them in. The
+ * conversion to complex doubles is done by the backend (see
+ * SampleConversion.h).
+ */
+enum SampleFormat {
+	/// Interleaved real and imaginary parts as doubles (see Complex).
+	SAMPLE_COMPLEX_DOUBLE,
+	/// Interleaved real and imaginary parts as 32-bit floats.
+	SAMPLE_COMPLEX_FLOAT,
+	/// Interleaved real and imaginary parts as signed 16-bit integers.
+	SAMPLE_COMPLEX_INT16,
+	/// Real and imaginary parts as 32-bit floats in two separate arrays.
+	SAMPLE_PLANAR_FLOAT,
+	/// Interleaved real and imaginary parts as packed signed 24-bit
+	/// little-endian integers (3 bytes each).
+	SAMPLE_COMPLEX_INT24,
+	/// Interleaved real and imaginary parts as signed 32-bit integers.
+	SAMPLE_COMPLEX_INT32,
+	/// Interleaved real and imaginary parts as unsigned 8-bit integers
+	/// with the zero at 127.5 (RTL-SDR receivers).
+	SAMPLE_COMPLEX_UINT8
+};
+
+
+/**
+ * \brief Returns whether the real and imaginary parts are stored in two
+ *        separate arrays.
+ */
+inline bool isPlanar(SampleFormat format)
+{
+	return (format == SAMPLE_PLANAR_FLOAT);
+}
+
+
+/**
+ * \brief Returns the size of one (complex) sample in bytes.
+ */
+inline int getSampleSize(SampleFormat format)
+{
+	switch (format) {
+	case SAMPLE_COMPLEX_DOUBLE: return sizeof(Complex);
+	case SAMPLE_COMPLEX_FLOAT:  return 2 * sizeof(float);
+	case SAMPLE_COMPLEX_INT16:  return 2 * sizeof(int16_t);
+	case SAMPLE_PLANAR_FLOAT:   return 2 * sizeof(float);
+	case SAMPLE_COMPLEX_INT24:  return 2 * 3;
+	case SAMPLE_COMPLEX_INT32:  return 2 * sizeof(int32_t);
+	case SAMPLE_COMPLEX_UINT8:  return 2 * sizeof(uint8_t);
+	}
+	return 0;
+}
+
+
+/**
+ * \brief Non-owning view of a block of samples (pointer, length and format).
+ *
+ * Frontends hand their own buffers (memory-mapped files, buffers owned by
+ * JACK, ...) to the backends through a span without copying them. The
+ * referenced memory only has to stay valid during the call to
+ * Backend::process().
+ *
+ * The samples of interleaved formats don't have to be adjacent: if the
+ * \c stride is set, consecutive samples start \c stride bytes apart (for
+ * example the first two channels of a multi-channel WAV file).
+ */
+struct SampleSpan {
+	SampleFormat  format;
+	/// The samples (the real parts for planar formats).
+	const void   *data;
+	/// The imaginary parts for planar formats, \c NULL otherwise.
+	const void   *imag;
+	/// Number of (complex) samples.
+	int           length;
+	/// Distance between the starts of consecutive samples in bytes, 0 if
+	/// the samples are adjacent. Not used by planar formats.
+	int           stride;
+	
+	SampleSpan() :
+		format(SAMPLE_COMPLEX_DOUBLE), data(NULL), imag(NULL), length(0), stride(0)
+	{}
+	
+	SampleSpan(SampleFormat format, const void *data, int length, int stride = 0) :
+		format(format), data(data), imag(NULL), length(length), stride(stride)
+	{}
+	
+	SampleSpan(SampleFormat format, const void *real, const void *imag, int length) :
+		format(format), data(real), imag(imag), length(length), stride(0)
+	{}
+	
+	SampleSpan(const Complex *data, int length) :
+		format(SAMPLE_COMPLEX_DOUBLE), data(data), imag(NULL), length(length), stride(0)
+	{}
+	
+	inline int sampleSize() const { return getSampleSize(format); }
+	
+	/**
+	 * \brief Returns the distance between consecutive samples in bytes.
+	 */
+	inline int frameSize() const { return (stride > 0) ? stride : sampleSize(); }
+	
+	/**
+	 * \brief Returns whether the samples are adjacent.
+	 */
+	inline bool isPacked() const { return (stride == 0) || (stride == sampleSize()); }
+	
+	/**
+	 * \brief Returns a view of \c count samples starting at \c offset.
+	 */
+	inline SampleSpan slice(int offset, int count) const
+	{
+		if (isPlanar(format)) {
+			long bytes = (long)offset * (sampleSize() / 2);
+			return SampleSpan(
+				format,
+				(const char*)data + bytes,
+				(const char*)imag + bytes,
+				count
+			);
+		}
+		
+		return SampleSpan(
+			format,
+			(const char*)data + (long)offset * frameSize(),
+			count,
+			stride
+		);
+	}
+};
+
+
 /**
  * \brief Basic metadata for a sample stream.
  */
@@ -33,13 +166,26 @@ struct StreamInfo {
 	/// Flag signalling whether the total length (number of samples) of the stream is known.
 	bool   knownLength;
 	/// Length (number of samples) of the stream if it is known, 0 otherwise.
-	int    length;
+	long   length;
 	/// Stream sample rate in samples per second (Hz).
 	int    sampleRate;
 	
 	/// Time offset of the first sample in the stream.
 	WFTime timeOffset;
 	
+	/**
+	 * Position of the first sample of the stream. Non-zero for segments of
+	 * a longer stream processed in parallel, the time of a sample at
+	 * position \c offset is \c timeOffset + \c offset / \c sampleRate
+	 * regardless of the segment. A segment of known length is followed
+	 * by the overlap requested by Backend::getSegmentOverlap().
+	 */
+	long   startOffset;
+	
+	/// Whether the samples come from a live source which can't wait (if
+	/// the processing falls behind, data are dropped instead).
+	bool   realTime;
+	
 	StreamInfo()
 	{
 		knownLength = false;
@@ -47,6 +193,9 @@ struct StreamInfo {
 		sampleRate = 48000;
 		
 		timeOffset = WFTime(0, 0);
+		
+		startOffset = 0;
+		realTime = false;
 	}
 };
 
@@ -84,9 +233,36 @@ public:
 	virtual ~Backend() {}
 	
 	virtual void startStream(StreamInfo info) { streamInfo_ = info; }
-	virtual void process(const vector<Complex> &data, DataInfo info) = 0;
+	virtual void process(const SampleSpan &data, DataInfo info) = 0;
 	virtual void endStream() {}
+	
+	/**
+	 * \brief Returns the number of samples the start of a segment of a
+	 *        stream processed in parallel has to be a multiple of, so that
+	 *        the output of the segments can be joined seamlessly.
+	 */
+	virtual long getSegmentAlignment(const StreamInfo &info) { return 1; }
+	/**
+	 * \brief Returns the number of samples that have to follow the end of a
+	 *        segment to produce all of its output.
+	 */
+	virtual int  getSegmentOverlap() { return 0; }
 };
 
+
+/**
+ * \brief Returns the least common multiple of two segment alignments.
+ */
+inline long combineAlignments(long a, long b)
+{
+	long x = a, y = b;
+	while (y != 0) {
+		long t = x % y;
+		x = y;
+		y = t;
+	}
+	return (x == 0) ? 0 : (a / x) * b;
+}
+
 #endif /* end of include guard: BACKEND_IFO2SX99 */
 
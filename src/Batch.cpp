@@ -0,0 +1,161 @@
+/**
+ * \file   Batch.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the Batch class.
+ */
+
+#include "Batch.h"
+
+#include <cerrno>
+#include <sstream>
+
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+
+/**
+ * Creates a directory including the missing parent directories.
+ */
+static bool makeDirectories(const string &path)
+{
+	for (size_t i = 1; i <= path.size(); i++) {
+		if ((i < path.size()) && (path[i] != '/')) continue;
+
+		string prefix = path.substr(0, i);
+		if ((mkdir(prefix.c_str(), 0755) != 0) && (errno != EEXIST))
+			return false;
+	}
+	return true;
+}
+
+
+static bool isWAVFileName(const string &name)
+{
+	return (name.size() > 4) &&
+		(strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0);
+}
+
+
+bool Batch::isInputFile(const string &name) const
+{
+	return isWAVFileName(name);
+}
+
+
+/**
+ * Adds a file with an output directory named after it (without the
+ * extension, made unique if several files have the same name).
+ */
+void Batch::addFile(const string &fileName)
+{
+	size_t slash = fileName.rfind('/');
+	string name = (slash == string::npos) ? fileName : fileName.substr(slash + 1);
+	if (isWAVFileName(name)) name = name.substr(0, name.size() - 4);
+
+	string directory = outputDirectory_ + "/" + name;
+	for (int i = 2; ; i++) {
+		bool unique = true;
+		for (unsigned j = 0; j < outputDirectories_.size(); j++) {
+			if (outputDirectories_[j] == directory) {
+				unique = false;
+				break;
+			}
+		}
+		if (unique) break;
+
+		ostringstream numbered;
+		numbered << outputDirectory_ << "/" << name << "_" << i;
+		directory = numbered.str();
+	}
+
+	FileBatch::addFile(fileName);
+	outputDirectories_.push_back(directory);
+}
+
+
+void Batch::processFile(unsigned index)
+{
+	const string &fileName = files_[index];
+	const string &outputDirectory = outputDirectories_[index];
+	WFTime start = WFTime::now();
+
+	uint64_t bytes = 0;
+	struct stat st;
+	if (stat(fileName.c_str(), &st) == 0) bytes = st.st_size;
+
+	long samples = 0;
+	int  sampleRate = 1;
+
+	if (makeDirectories(outputDirectory)) {
+		Ref<Frontend> frontend = factory_->createFrontend(fileName, outputDirectory);
+		frontend->run();
+
+		samples = frontend->getProcessedLength();
+		sampleRate = frontend->getStreamInfo().sampleRate;
+	} else {
+		LOG_ERROR("Failed to create output directory \"" <<
+				outputDirectory << "\".");
+	}
+
+	double seconds = secondsBetween(start, WFTime::now());
+	if (seconds <= 0) seconds = 1e-6;
+	double signalSeconds = (double)samples / sampleRate;
+
+	MutexLock lock(&mutex_);
+
+	int done = finishFile(samples > 0);
+	if (samples > 0) {
+		bytes_ += bytes;
+		signalSeconds_ += signalSeconds;
+
+		LOG_INFO("[" << done << "/" << files_.size() << "] " << fileName <<
+			    ": " << signalSeconds << " s of signal in " << seconds <<
+			    " s (" << (signalSeconds / seconds) << "x real time).");
+	} else {
+		LOG_ERROR("[" << done << "/" << files_.size() << "] " << fileName <<
+				": no samples processed.");
+	}
+}
+
+
+/**
+ * Constructor.
+ */
+Batch::Batch(FrontendFactory *factory, int threads, const string &outputDirectory) :
+	FileBatch("WAV", threads),
+	factory_(factory),
+	outputDirectory_(outputDirectory.empty() ? "." : outputDirectory),
+	bytes_(0),
+	signalSeconds_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+Batch::~Batch()
+{
+}
+
+
+int Batch::run()
+{
+	bytes_ = 0;
+	signalSeconds_ = 0;
+
+	LOG_INFO("Processing " << files_.size() << " files using " << getWorkerCount() <<
+		    " threads, output in \"" << outputDirectory_ << "\".");
+
+	double seconds = runWorkers();
+
+	LOG_INFO("Processed " << (done_ - failed_) << " of " << files_.size() <<
+		    " files (" << failed_ << " failed) in " << seconds << " s: " <<
+		    (bytes_ / 1048576.0 / seconds) << " MiB/s, " <<
+		    (signalSeconds_ / seconds) << "x real time.");
+
+	return failed_;
+}
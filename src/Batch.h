@@ -0,0 +1,91 @@
+/**
+ * \file   Batch.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the Batch class.
+ */
+
+#ifndef BATCH_H3VZP8RC
+#define BATCH_H3VZP8RC
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "FileBatch.h"
+#include "Frontend.h"
+
+
+/**
+ * \brief Creates the pipelines (a frontend with its backends) of a batch.
+ */
+class FrontendFactory {
+public:
+	virtual ~FrontendFactory() {}
+
+	/**
+	 * \brief Returns a frontend reading \c fileName, with the output written
+	 *        to \c outputDirectory.
+	 *
+	 * Called from the worker threads of the batch.
+	 */
+	virtual Ref<Frontend> createFrontend(const string &fileName,
+								  const string &outputDirectory) = 0;
+};
+
+
+/**
+ * \brief Processes a list of WAV files by a pool of worker threads.
+ *
+ * Each file is processed by its own pipeline (see FrontendFactory), so the
+ * files are independent of each other. The output of each file is written
+ * to its own directory (named after the file) in the output directory of
+ * the batch. The progress and the throughput are reported in the log.
+ */
+class Batch : public FileBatch {
+private:
+	FrontendFactory *factory_;
+	string           outputDirectory_;
+
+	/// Output directories of the files.
+	vector<string>   outputDirectories_;
+
+	uint64_t         bytes_;
+	double           signalSeconds_;
+
+	Batch(const Batch& other);
+
+protected:
+	virtual bool isInputFile(const string &name) const;
+	virtual void addFile(const string &fileName);
+	virtual void processFile(unsigned index);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param factory         creates the pipelines of the files
+	 * \param threads         number of files processed at once
+	 * \param outputDirectory directory the output directories of the files
+	 *                        are created in
+	 */
+	Batch(FrontendFactory *factory, int threads, const string &outputDirectory);
+	virtual ~Batch();
+
+	/**
+	 * \brief Processes all of the files.
+	 *
+	 * \returns the number of files that failed
+	 */
+	int run();
+};
+
+#endif /* end of include guard: BATCH_H3VZP8RC */
+
@@ -0,0 +1,115 @@
+/**
+ * \file   Clock.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the Clock classes.
+ */
+
+#include "Clock.h"
+
+#include <cerrno>
+
+
+// In this order, the reference is initialized from the pointer.
+Clock*     Clock::default_    = new SystemClock();
+Ref<Clock> Clock::defaultRef_ = Clock::default_;
+
+
+Clock* Clock::getDefault()
+{
+	return default_;
+}
+
+
+void Clock::setDefault(Clock *clock)
+{
+	defaultRef_ = clock;
+	default_ = clock;
+}
+
+
+void SystemClock::sleepUntil(const WFTime &time)
+{
+	struct timespec wakeUp;
+	wakeUp.tv_sec = time.seconds();
+	wakeUp.tv_nsec = time.microseconds() * 1000;
+
+	while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &wakeUp, NULL) == EINTR);
+}
+
+
+/**
+ * Returns the wall time since the synchronization in seconds.
+ */
+double ReplayClock::elapsed() const
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)(now.tv_sec - start_.tv_sec) +
+		(double)(now.tv_nsec - start_.tv_nsec) * 1e-9;
+}
+
+
+/**
+ * Constructor.
+ */
+ReplayClock::ReplayClock(double speed) :
+	speed_((speed < 0) ? 0 : speed),
+	synchronized_(false)
+{
+	start_.tv_sec = 0;
+	start_.tv_nsec = 0;
+}
+
+
+WFTime ReplayClock::now()
+{
+	MutexLock lock(&mutex_);
+
+	if (!synchronized_) return WFTime::now();
+	if (speed_ <= 0) return time_;
+
+	return time_.addMicroseconds((time_t)(elapsed() * speed_ * US_IN_SECOND));
+}
+
+
+void ReplayClock::sleepUntil(const WFTime &time)
+{
+	double delay;
+
+	{
+		MutexLock lock(&mutex_);
+
+		if (!synchronized_) return;
+
+		// Difference of the simulated times in seconds.
+		double ahead = (double)(time.seconds() - time_.seconds()) +
+			(double)(time.microseconds() - time_.microseconds()) * 1e-6;
+
+		if (speed_ <= 0) {
+			if (ahead > 0) time_ = time;
+			return;
+		}
+
+		delay = ahead / speed_ - elapsed();
+	}
+
+	if (delay <= 0) return;
+
+	struct timespec duration;
+	duration.tv_sec = (time_t)delay;
+	duration.tv_nsec = (long)((delay - duration.tv_sec) * 1e9);
+	while (nanosleep(&duration, &duration) == -1 && errno == EINTR);
+}
+
+
+void ReplayClock::synchronize(const WFTime &time)
+{
+	MutexLock lock(&mutex_);
+
+	time_ = time;
+	clock_gettime(CLOCK_MONOTONIC, &start_);
+	synchronized_ = true;
+}
+
@@ -0,0 +1,113 @@
+/**
+ * \file   Clock.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the Clock classes.
+ */
+
+#ifndef CLOCK_P8XK3NQD
+#define CLOCK_P8XK3NQD
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "WFTime.h"
+
+
+/**
+ * \brief Source of the current time.
+ *
+ * The time stamps that are not derived from the samples (the start of live
+ * streams, the times written to the snapshots) are read from the default
+ * clock (see getDefault()), so that a replayed recording sees the time it
+ * was recorded at. Frontends can also be paced to a clock (see
+ * Frontend::setPacingClock()).
+ */
+class Clock : public Object {
+private:
+	static Clock*     default_;
+	/// Keeps the default clock alive.
+	static Ref<Clock> defaultRef_;
+
+public:
+	virtual ~Clock() {}
+
+	/// Returns the current time (UTC).
+	virtual WFTime now() = 0;
+
+	/**
+	 * \brief Blocks until the clock shows \c time (or later).
+	 */
+	virtual void sleepUntil(const WFTime &time) = 0;
+
+	/**
+	 * \brief Makes the clock show \c time now, if it can be set (the
+	 *        system clock can't).
+	 */
+	virtual void synchronize(const WFTime &time) {}
+
+	/**
+	 * \brief Returns the clock used for the time stamps, the system clock
+	 *        unless set by setDefault().
+	 *
+	 * The clock should only be set before the processing starts (the
+	 * pointer is shared by the threads without locking).
+	 */
+	static Clock* getDefault();
+	static void   setDefault(Clock *clock);
+};
+
+
+/**
+ * \brief The wall clock.
+ */
+class SystemClock : public Clock {
+public:
+	virtual WFTime now() { return WFTime::now(); }
+	virtual void   sleepUntil(const WFTime &time);
+};
+
+
+/**
+ * \brief Simulated clock for replaying recordings at a multiple of real time.
+ *
+ * Once synchronized to the time of the first sample, the clock runs
+ * \c speed times faster than the wall clock. At speed 0 (unlimited) the
+ * clock does not run at all; it only jumps forward to the times slept
+ * until, so a paced frontend runs as fast as possible while the clock
+ * still follows the samples.
+ */
+class ReplayClock : public Clock {
+private:
+	double          speed_;
+
+	Mutex           mutex_;
+	bool            synchronized_;
+	/// Time shown at \c start_.
+	WFTime          time_;
+	/// Monotonic wall time of the synchronization.
+	struct timespec start_;
+
+	ReplayClock(const ReplayClock& other);
+
+	double elapsed() const;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param speed multiple of real time, 0 for unlimited
+	 */
+	ReplayClock(double speed);
+
+	double getSpeed() const { return speed_; }
+
+	virtual WFTime now();
+	virtual void   sleepUntil(const WFTime &time);
+	virtual void   synchronize(const WFTime &time);
+};
+
+#endif /* end of include guard: CLOCK_P8XK3NQD */
+
@@ -0,0 +1,189 @@
+/**
+ * \file   DeadlineMonitor.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the DeadlineMonitor class.
+ */
+
+#include "DeadlineMonitor.h"
+#include "Atomic.h"
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEADLINE STATS
+////////////////////////////////////////////////////////////////////////////////
+
+
+void DeadlineStats::clear()
+{
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	nearMisses = 0;
+	misses = 0;
+	xruns = 0;
+	correlatedXruns = 0;
+	max = 0;
+}
+
+
+double DeadlineStats::getPercentile(double fraction) const
+{
+	if (count == 0) return 0;
+
+	uint64_t target = (uint64_t)ceil(fraction * count);
+	if (target < 1) target = 1;
+
+	uint64_t seen = 0;
+	for (int i = 0; i < DEADLINE_BUCKETS - 1; i++) {
+		seen += buckets[i];
+		if (seen >= target) {
+			// The end of the bucket, but no more than the largest value.
+			double end = (double)(i + 1) / DEADLINE_BUCKETS_PER_PERIOD;
+			return (end < getMax()) ? end : getMax();
+		}
+	}
+
+	return getMax();
+}
+
+
+DeadlineStats DeadlineStats::since(const DeadlineStats &previous) const
+{
+	DeadlineStats result = *this;
+
+	for (int i = 0; i < DEADLINE_BUCKETS; i++)
+		result.buckets[i] -= previous.buckets[i];
+	result.count -= previous.count;
+	result.nearMisses -= previous.nearMisses;
+	result.misses -= previous.misses;
+	result.xruns -= previous.xruns;
+	result.correlatedXruns -= previous.correlatedXruns;
+
+	return result;
+}
+
+
+void DeadlineStats::write(ostream &output) const
+{
+	output << fixed << setprecision(1) <<
+		count << " callbacks, utilization" <<
+		" p50=" << (getPercentile(0.5) * 100) << "%" <<
+		" p99=" << (getPercentile(0.99) * 100) << "%" <<
+		" p99.9=" << (getPercentile(0.999) * 100) << "%" <<
+		" max=" << (getMax() * 100) << "%" <<
+		", " << nearMisses << " near misses, " << misses << " misses, " <<
+		xruns << " xruns (" << correlatedXruns << " after a near miss)";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DEADLINE MONITOR
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * Constructor.
+ */
+DeadlineMonitor::DeadlineMonitor(double nearMissThreshold, double warningThreshold) :
+	sampleRate_(0),
+	nearMissThreshold_(nearMissThreshold),
+	warningThreshold_(warningThreshold),
+	intervalMax_(0),
+	lastNearMiss_(0),
+	period_(0)
+{
+}
+
+
+void DeadlineMonitor::record(uint64_t begin, uint64_t end, int frames)
+{
+	if ((sampleRate_ <= 0) || (frames <= 0)) return;
+
+	uint64_t period = (uint64_t)frames * 1000000000ULL / sampleRate_;
+	double utilization = (double)(end - begin) / period;
+
+	int bucket = (int)(utilization * DEADLINE_BUCKETS_PER_PERIOD);
+	if (bucket >= DEADLINE_BUCKETS) bucket = DEADLINE_BUCKETS - 1;
+
+	addRelaxed(&(stats_.buckets[bucket]), 1);
+	addRelaxed(&(stats_.count), 1);
+
+	uint64_t millionths = (uint64_t)(utilization * 1e6);
+	maxRelaxed(&(stats_.max), millionths);
+	maxRelaxed(&intervalMax_, millionths);
+
+	if (utilization >= nearMissThreshold_) {
+		addRelaxed(&(stats_.nearMisses), 1);
+		if (utilization >= 1.0) addRelaxed(&(stats_.misses), 1);
+		__atomic_store_n(&lastNearMiss_, end, __ATOMIC_RELAXED);
+	}
+
+	__atomic_store_n(&period_, period, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * JACK reports an xrun after the late cycle, so a near miss causing it has
+ * already been recorded.
+ */
+void DeadlineMonitor::recordXrun(uint64_t time)
+{
+	__atomic_add_fetch(&(stats_.xruns), 1, __ATOMIC_RELAXED);
+
+	uint64_t nearMiss = __atomic_load_n(&lastNearMiss_, __ATOMIC_RELAXED);
+	uint64_t period = __atomic_load_n(&period_, __ATOMIC_RELAXED);
+	if ((nearMiss > 0) && (time >= nearMiss) && (time - nearMiss <= 10 * period))
+		__atomic_add_fetch(&(stats_.correlatedXruns), 1, __ATOMIC_RELAXED);
+}
+
+
+void DeadlineMonitor::getStats(DeadlineStats *result) const
+{
+	for (int i = 0; i < DEADLINE_BUCKETS; i++)
+		result->buckets[i] = loadRelaxed(&(stats_.buckets[i]));
+	result->count = loadRelaxed(&(stats_.count));
+	result->nearMisses = loadRelaxed(&(stats_.nearMisses));
+	result->misses = loadRelaxed(&(stats_.misses));
+	result->xruns = __atomic_load_n(&(stats_.xruns), __ATOMIC_RELAXED);
+	result->correlatedXruns = __atomic_load_n(&(stats_.correlatedXruns), __ATOMIC_RELAXED);
+	result->max = loadRelaxed(&(stats_.max));
+}
+
+
+/**
+ * A callback recorded while the maximum is being reset may still raise the
+ * maximum of the old interval, it is then counted in the next one.
+ */
+bool DeadlineMonitor::check(DeadlineStats *previous, DeadlineStats *interval)
+{
+	DeadlineStats current;
+	getStats(&current);
+	DeadlineStats result = current.since(*previous);
+	result.max = __atomic_exchange_n(&intervalMax_, 0, __ATOMIC_RELAXED);
+	*previous = current;
+
+	if (interval != NULL) *interval = result;
+	if (result.count == 0) return false;
+
+	stringstream text;
+	result.write(text);
+
+	if (result.getPercentile(0.999) > warningThreshold_) {
+		LOG_WARNING("JACK callback deadline: " << text.str() << " (p99.9 over " <<
+				  (warningThreshold_ * 100) << "%).");
+		return true;
+	}
+
+	LOG_DEBUG("JACK callback deadline: " << text.str() << ".");
+	return false;
+}
+
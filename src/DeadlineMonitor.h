@@ -0,0 +1,138 @@
+/**
+ * \file   DeadlineMonitor.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the DeadlineMonitor class.
+ */
+
+#ifndef DEADLINEMONITOR_M4XC9HTE
+#define DEADLINEMONITOR_M4XC9HTE
+
+#include <cstddef>
+#include <stdint.h>
+#include <ostream>
+
+using namespace std;
+
+
+/// Buckets of the utilization histogram per 100 %.
+#define DEADLINE_BUCKETS_PER_PERIOD 200
+/// 0.5 % buckets up to 200 %, the last one holds everything above.
+#define DEADLINE_BUCKETS (2 * DEADLINE_BUCKETS_PER_PERIOD + 1)
+
+
+/**
+ * \brief Deadline utilization of the real-time callbacks over a time.
+ */
+struct DeadlineStats {
+	/// Callbacks by the fraction of their period they took.
+	uint64_t buckets[DEADLINE_BUCKETS];
+	uint64_t count;
+	/// Callbacks which took more than the near miss threshold.
+	uint64_t nearMisses;
+	/// Callbacks which took longer than their period.
+	uint64_t misses;
+	uint64_t xruns;
+	/// Xruns which followed a near miss closely.
+	uint64_t correlatedXruns;
+	/// Largest utilization, in millionths of the period.
+	uint64_t max;
+
+	DeadlineStats() { clear(); }
+
+	void clear();
+
+	/// Returns the utilization below which \c fraction of the callbacks lie.
+	double getPercentile(double fraction) const;
+	double getMax() const { return max / 1e6; }
+
+	/**
+	 * \brief Returns the statistics since \c previous, except the maximum
+	 *        (which stays the one of \c this).
+	 */
+	DeadlineStats since(const DeadlineStats &previous) const;
+
+	void write(ostream &output) const;
+};
+
+
+/**
+ * \brief Measures how much of the time available to a real-time callback
+ *        (the JACK period, \c nframes / sample rate) it uses.
+ *
+ * The utilization of each callback goes into a histogram, callbacks using
+ * more than the near miss threshold are counted, and xruns reported
+ * shortly after a near miss are counted as correlated with it. check()
+ * warns when the 99.9th percentile of the utilization goes over the
+ * warning threshold, long before the callbacks actually miss their
+ * deadlines.
+ *
+ * record() is called by the real-time thread only and neither locks nor
+ * allocates; the other methods may be called from any thread.
+ */
+class DeadlineMonitor {
+private:
+	int      sampleRate_;
+	double   nearMissThreshold_;
+	double   warningThreshold_;
+
+	DeadlineStats stats_;
+	/// Largest utilization since the last check(), in millionths.
+	uint64_t intervalMax_;
+	/// Time of the end of the last near miss (Metrics::now()).
+	uint64_t lastNearMiss_;
+	/// Length of the last period in nanoseconds.
+	uint64_t period_;
+
+	DeadlineMonitor(const DeadlineMonitor& other);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param nearMissThreshold utilization counted as a near miss
+	 * \param warningThreshold  99.9th percentile of the utilization which
+	 *                          check() warns about
+	 */
+	DeadlineMonitor(double nearMissThreshold = 0.8, double warningThreshold = 0.5);
+
+	void setSampleRate(int sampleRate) { sampleRate_ = sampleRate; }
+	void setNearMissThreshold(double threshold) { nearMissThreshold_ = threshold; }
+	void setWarningThreshold(double threshold) { warningThreshold_ = threshold; }
+
+	/**
+	 * \brief Records a callback.
+	 *
+	 * \param begin  Metrics::now() at its start
+	 * \param end    Metrics::now() at its end
+	 * \param frames number of frames of the period
+	 */
+	void record(uint64_t begin, uint64_t end, int frames);
+
+	/**
+	 * \brief Records an xrun, correlated with a near miss which ended less
+	 *        than 10 periods before \c time.
+	 */
+	void recordXrun(uint64_t time);
+
+	void getStats(DeadlineStats *result) const;
+
+	/**
+	 * \brief Logs the utilization since \c previous (updated to the current
+	 *        statistics), as a warning if its 99.9th percentile is over the
+	 *        threshold.
+	 *
+	 * The maximum is the one since the last check. It is reset by the
+	 * check, so there should be a single caller.
+	 *
+	 * \param previous statistics of the last check
+	 * \param interval if not \c NULL, receives the statistics since the last
+	 *                 check
+	 * \returns \c true if it is over the threshold
+	 */
+	bool check(DeadlineStats *previous, DeadlineStats *interval = NULL);
+};
+
+#endif /* end of include guard: DEADLINEMONITOR_M4XC9HTE */
+
@@ -7,6 +7,10 @@
  */
 
 #include "FFTBackend.h"
+#include "SampleConversion.h"
+#include "Metrics.h"
+#include "PerfCounters.h"
+#include "Trace.h"
 
 #include <cassert>
 #include <cmath>
@@ -18,6 +22,56 @@ using namespace std;
 
 const double FFTBackend::PI = 4.0 * atan(1.0);
 
+Mutex                            FFTBackend::planMutex_;
+map<int, FFTBackend::SharedPlan> FFTBackend::plans_;
+
+
+/**
+ * Returns a plan of a forward FFT of \c bins samples, planned only once for
+ * all of the backends (and threads).
+ *
+ * The plan is executed on the buffers of each backend with
+ * fftw_execute_dft(), which is thread-safe. The buffers are allocated by
+ * fftw_malloc(), so they have the alignment the plan was made for.
+ */
+fftw_plan FFTBackend::acquirePlan(int bins)
+{
+	MutexLock lock(&planMutex_);
+	
+	map<int, SharedPlan>::iterator it = plans_.find(bins);
+	if (it != plans_.end()) {
+		it->second.references++;
+		return it->second.plan;
+	}
+	
+	fftw_complex *in  = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * bins);
+	fftw_complex *out = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * bins);
+	
+	SharedPlan shared;
+	shared.plan = fftw_plan_dft_1d(bins, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+	shared.references = 1;
+	plans_[bins] = shared;
+	
+	fftw_free(in);
+	fftw_free(out);
+	
+	return shared.plan;
+}
+
+
+void FFTBackend::releasePlan(int bins)
+{
+	MutexLock lock(&planMutex_);
+	
+	map<int, SharedPlan>::iterator it = plans_.find(bins);
+	if (it == plans_.end()) return;
+	
+	if (--(it->second.references) == 0) {
+		fftw_destroy_plan(it->second.plan);
+		plans_.erase(it);
+	}
+}
+
 
 FFTBackend::FFTBackend(int bins, int overlap) :
 	Backend(),
@@ -33,14 +87,16 @@ FFTBackend::FFTBackend(int bins, int overlap) :
 	
 	windowFn_ = new float[bufferSize_];
 	
-	window_ = (fftw_complex *) fftw_malloc(bufferSize_);
+	// The history is large enough for samples of any format.
+	historyFormat_ = SAMPLE_COMPLEX_DOUBLE;
+	history_ = (char *) fftw_malloc(bins_ * sizeof(Complex));
+	historyMark_ = 0;
+	nextOffset_ = 0;
+	skip_ = 0;
+	
 	in_ = (fftw_complex *) fftw_malloc(bufferSize_);
 	out_ = (fftw_complex *) fftw_malloc(bufferSize_);
-	fftPlan_ = fftw_plan_dft_1d(bins_, in_, out_, FFTW_FORWARD, FFTW_ESTIMATE);
-	
-	//inMark_ = in_ + binOverlap_;
-	inMark_ = window_;
-	inEnd_ = window_ + bins_;
+	fftPlan_ = acquirePlan(bins_);
 }
 
 
@@ -48,8 +104,8 @@ FFTBackend::~FFTBackend()
 {
 	delete [] windowFn_;
 	
-	fftw_destroy_plan(fftPlan_);
-	fftw_free(window_);
+	releasePlan(bins_);
+	fftw_free(history_);
 	fftw_free(in_);
 	fftw_free(out_);
 }
@@ -59,7 +115,9 @@ void FFTBackend::startStream(StreamInfo info)
 {
 	Backend::startStream(info);
 	
-	inMark_ = window_;
+	historyMark_ = 0;
+	nextOffset_ = info.startOffset;
+	skip_ = 0;
 	
 	fftSampleRate_ = ((float)info.sampleRate /
 				   (float)(bins_ - binOverlap_));
@@ -102,47 +160,141 @@ void FFTBackend::startStream(StreamInfo info)
 }
 
 
-void FFTBackend::process(const vector<Complex> &data, DataInfo info)
+void FFTBackend::process(const SampleSpan &data, DataInfo info)
 {
-	assert(sizeof(Complex) == sizeof(in_[0]));
 	//assert(binOverlap_ <= (bins_ - binOverlap_));
 	
-	int size = data.size();
-	const Complex *src = &(data[0]);
+	SampleFormat format = getStorageFormat(data.format);
+	if (format != historyFormat_) {
+		if (historyMark_ > 0) {
+			LOG_WARNING("FFT backend: sample format changed, dropping " <<
+					  historyMark_ << " samples.");
+		}
+		historyFormat_ = format;
+		historyMark_ = 0;
+	}
+	
+	int sampleSize = getSampleSize(historyFormat_);
+	int size = data.length;
+	int srcOffset = 0;
+	int hop = bins_ - binOverlap_;
+	
+	// After a gap (samples skipped by the frontend, see Frontend::skip()),
+	// the samples before it can't be joined with those after it into a
+	// frame. The history is dropped and the next frame starts at the next
+	// position on the grid of the frames (a multiple of the hop from the
+	// start of the stream).
+	if (info.offset != nextOffset_) {
+		if (historyMark_ > 0) {
+			LOG_DEBUG("FFT backend: gap of " << (info.offset - nextOffset_) <<
+					" samples, dropping " << historyMark_ << " samples.");
+		}
+		historyMark_ = 0;
+		
+		long phase = (info.offset - streamInfo_.startOffset) % hop;
+		if (phase < 0) phase += hop;
+		skip_ = (phase > 0) ? hop - phase : 0;
+	}
+	nextOffset_ = info.offset + data.length;
+	
+	if (skip_ > 0) {
+		int count = (skip_ < size) ? (int)skip_ : size;
+		skip_ -= count;
+		srcOffset += count;
+		size -= count;
+	}
 	
-	info_.timeOffset = info.timeOffset;
+	// Frames starting after the end of a segment of known length belong to
+	// the next segment (see StreamInfo::startOffset).
+	long endOffset = streamInfo_.startOffset + streamInfo_.length;
 	
-	while (size >= (inEnd_ - inMark_)) {
-		int count = inEnd_ - inMark_;
+	while (size >= (bins_ - historyMark_)) {
+		int count = bins_ - historyMark_;
+		// Position of the first sample of the frame in the stream.
+		long frameStart = info.offset + srcOffset - historyMark_;
+		bool inSegment = (!streamInfo_.knownLength || (frameStart < endOffset));
 		
-		memcpy(inMark_, src, count * sizeof(in_[0]));
+		copySamples(data, srcOffset, history_ + historyMark_ * sampleSize, count);
 		
-		for (int i = 0; i < bins_; i++) {
-			in_[i][0] = window_[i][0] * windowFn_[i];
-			in_[i][1] = window_[i][1] * windowFn_[i];
+		if (inSegment) {
+			// The hardware counters are read outside of the timed parts.
+			PerfSample perf[3];
+			bool counted = PerfCounters::isEnabled() && PerfCounters::read(&perf[0]);
+			
+			// Widen, deinterleave and window the samples in one pass.
+			uint64_t start = Metrics::now();
+			windowSamples(historyFormat_, history_, windowFn_, in_, bins_);
+			uint64_t windowed = Metrics::now();
+			
+			if (counted) counted = PerfCounters::read(&perf[1]);
+			
+			uint64_t transformed = Metrics::now();
+			fftw_execute_dft(fftPlan_, in_, out_);
+			uint64_t end = Metrics::now();
+			
+			if (counted && PerfCounters::read(&perf[2])) {
+				PerfCounters::record(PERF_WINDOW, perf[0], perf[1]);
+				PerfCounters::record(PERF_FFT, perf[1], perf[2]);
+			}
+			
+			Metrics::record(LATENCY_WINDOW, windowed - start);
+			Metrics::record(LATENCY_FFT, end - transformed);
+			if (Trace::isEnabled()) {
+				Trace::record(TRACE_WINDOW, start, windowed);
+				Trace::record(TRACE_FFT, transformed, end);
+			}
 		}
 		
-		fftw_execute(fftPlan_);
-		memmove(window_, inEnd_ - binOverlap_, binOverlap_ * sizeof(in_[0]));
+		memmove(history_,
+			   history_ + hop * sampleSize,
+			   binOverlap_ * sampleSize);
 		
-		inMark_ = window_ + binOverlap_;
+		historyMark_ = binOverlap_;
 		size -= count;
-		src += count;
+		srcOffset += count;
 		
-		processFFT(out_, bins_, info_);
-		
-		info_.offset++;
-		info_.timeOffset = info_.timeOffset.addSamples(count, streamInfo_.sampleRate);
-		//LOG_DEBUG("offset = " << info_.timeOffset << ", count = " << count << ", sr = " << streamInfo_.sampleRate);
+		if (inSegment) {
+			// The position and time of the frame are computed from the
+			// position of its first sample, so they are the same no matter
+			// how the stream is split into blocks or segments.
+			info_.offset = frameStart / hop;
+			info_.timeOffset = streamInfo_.timeOffset.addSamples(
+				frameStart,
+				streamInfo_.sampleRate
+			);
+			
+			processFFT(out_, bins_, info_);
+		}
 	}
 	
 	if (size > 0) {
-		memcpy(inMark_, src, size * sizeof(in_[0]));
-		inMark_ += size;
+		copySamples(data, srcOffset, history_ + historyMark_ * sampleSize, size);
+		historyMark_ += size;
 	}
 }
 
 
+/**
+ * Segments start at a multiple of the hop (the number of samples between
+ * the starts of two frames), so their frames are on the same grid as the
+ * frames of the whole stream.
+ */
+long FFTBackend::getSegmentAlignment(const StreamInfo &info)
+{
+	return bins_ - binOverlap_;
+}
+
+
+/**
+ * The last frame of a segment ends \c binOverlap_ samples after the start
+ * of the next segment.
+ */
+int FFTBackend::getSegmentOverlap()
+{
+	return binOverlap_;
+}
+
+
 void FFTBackend::endStream()
 {
 	Backend::endStream();
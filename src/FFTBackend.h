@@ -11,6 +11,14 @@
 
 #include <fftw3.h>
 
+#include <map>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
 #include "Backend.h"
 
 /**
@@ -28,11 +36,38 @@ private:
 	
 	float        *windowFn_;
 	
-	fftw_complex *window_;
+	/// Format of the samples in the history (see getStorageFormat()).
+	SampleFormat  historyFormat_;
+	/// The last (up to) \c bins_ input samples in their native format.
+	char         *history_;
+	/// Number of samples in the history.
+	int           historyMark_;
+	/// Position in the stream of the sample expected next.
+	long          nextOffset_;
+	/// Samples to be skipped before the next frame starts on the hop grid
+	/// (after a gap in the stream).
+	long          skip_;
+	
 	fftw_complex *in_, *out_;
-	fftw_complex *inMark_, *inEnd_;
+	/// Shared plan (see acquirePlan()), executed on \c in_ and \c out_.
 	fftw_plan     fftPlan_;
 	
+	/**
+	 * \brief Plan shared by the backends with the same number of bins.
+	 */
+	struct SharedPlan {
+		fftw_plan plan;
+		int       references;
+	};
+	
+	/// The FFTW planner is not thread-safe, plans are created and destroyed
+	/// only under this lock.
+	static Mutex                 planMutex_;
+	static map<int, SharedPlan>  plans_;
+	
+	static fftw_plan acquirePlan(int bins);
+	static void      releasePlan(int bins);
+	
 	DataInfo      info_;
 	
 protected:
@@ -47,9 +82,12 @@ public:
 	virtual ~FFTBackend();
 	
 	virtual void startStream(StreamInfo info);
-	virtual void process(const vector<Complex> &data, DataInfo info);
+	virtual void process(const SampleSpan &data, DataInfo info);
 	virtual void endStream();
 	
+	virtual long getSegmentAlignment(const StreamInfo &info);
+	virtual int  getSegmentOverlap();
+	
 	float binToFrequency(int bin) const
 	{
 		return (
@@ -0,0 +1,175 @@
+/**
+ * \file   FileBatch.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the FileBatch class.
+ */
+
+#include "FileBatch.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <dirent.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+
+double FileBatch::secondsBetween(const WFTime &start, const WFTime &end)
+{
+	return (double)(end.seconds() - start.seconds()) +
+		(double)(end.microseconds() - start.microseconds()) / US_IN_SECOND;
+}
+
+
+void FileBatch::addFile(const string &fileName)
+{
+	files_.push_back(fileName);
+}
+
+
+bool FileBatch::nextFile(unsigned *index)
+{
+	MutexLock lock(&mutex_);
+
+	if (next_ >= files_.size()) return false;
+
+	*index = next_++;
+	return true;
+}
+
+
+void* FileBatch::threadMethod()
+{
+	unsigned index;
+	while (nextFile(&index))
+		processFile(index);
+
+	return NULL;
+}
+
+
+int FileBatch::finishFile(bool ok)
+{
+	done_++;
+	if (!ok) failed_++;
+	return done_;
+}
+
+
+int FileBatch::getWorkerCount() const
+{
+	return (threads_ > (int)files_.size()) ? (int)files_.size() : threads_;
+}
+
+
+double FileBatch::runWorkers()
+{
+	next_ = 0;
+	done_ = 0;
+	failed_ = 0;
+	WFTime start = WFTime::now();
+
+	vector<Thread*> workers;
+	for (int i = 0; i < getWorkerCount(); i++)
+		workers.push_back(new Thread(this, &FileBatch::threadMethod));
+
+	for (unsigned i = 0; i < workers.size(); i++) {
+		workers[i]->join();
+		delete workers[i];
+	}
+
+	double seconds = secondsBetween(start, WFTime::now());
+	return (seconds > 0) ? seconds : 1e-6;
+}
+
+
+/**
+ * Constructor.
+ */
+FileBatch::FileBatch(const string &fileType, int threads) :
+	fileType_(fileType),
+	threads_((threads < 1) ? 1 : threads),
+	next_(0),
+	done_(0),
+	failed_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+FileBatch::~FileBatch()
+{
+}
+
+
+bool FileBatch::addInput(const string &input)
+{
+	unsigned count = files_.size();
+
+	struct stat st;
+
+	if ((input.size() > 1) && (input[0] == '@')) {
+		// List of files, one per line.
+		ifstream list(input.c_str() + 1);
+		if (!list) {
+			LOG_ERROR("Failed to open file list \"" << (input.c_str() + 1) << "\".");
+			return false;
+		}
+
+		string line;
+		while (getline(list, line)) {
+			if (line.empty() || (line[0] == '#')) continue;
+			addFile(line);
+		}
+	} else if ((stat(input.c_str(), &st) == 0) && S_ISDIR(st.st_mode)) {
+		// Input files in a directory, sorted by name.
+		DIR *dir = opendir(input.c_str());
+		if (dir == NULL) {
+			LOG_ERROR("Failed to open directory \"" << input << "\".");
+			return false;
+		}
+
+		vector<string> names;
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != NULL) {
+			if (isInputFile(entry->d_name)) names.push_back(entry->d_name);
+		}
+		closedir(dir);
+
+		sort(names.begin(), names.end());
+		for (unsigned i = 0; i < names.size(); i++)
+			addFile(input + "/" + names[i]);
+	} else if (input.find_first_of("*?[") != string::npos) {
+		glob_t matches;
+		if (glob(input.c_str(), 0, NULL, &matches) == 0) {
+			for (size_t i = 0; i < matches.gl_pathc; i++)
+				addFile(matches.gl_pathv[i]);
+		}
+		globfree(&matches);
+	} else {
+		addFile(input);
+	}
+
+	if (files_.size() == count) {
+		LOG_WARNING("No " << fileType_ << " files found in \"" << input << "\".");
+		return false;
+	}
+
+	return true;
+}
+
+
+bool FileBatch::isBatchInput(const string &input)
+{
+	struct stat st;
+
+	return ((input.size() > 1) && (input[0] == '@')) ||
+		((stat(input.c_str(), &st) == 0) && S_ISDIR(st.st_mode)) ||
+		(input.find_first_of("*?[") != string::npos);
+}
+
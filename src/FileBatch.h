@@ -0,0 +1,115 @@
+/**
+ * \file   FileBatch.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the FileBatch class.
+ */
+
+#ifndef FILEBATCH_P5TC2WKM
+#define FILEBATCH_P5TC2WKM
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "WFTime.h"
+
+
+/**
+ * \brief List of input files processed by a pool of worker threads (the
+ *        common part of Batch and RenderBatch).
+ *
+ * The files are taken by the workers one at a time, in the order they were
+ * added. A subclass selects the files of a directory (isInputFile()) and
+ * processes a single file (processFile()).
+ */
+class FileBatch : public Object {
+private:
+	typedef MethodThread<void, FileBatch> Thread;
+
+	string         fileType_;
+	int            threads_;
+
+	/// Index of the next file to be processed.
+	unsigned       next_;
+
+	FileBatch(const FileBatch& other);
+
+	bool  nextFile(unsigned *index);
+	void* threadMethod();
+
+protected:
+	vector<string> files_;
+
+	/// Guards the counters, of the subclasses as well.
+	Mutex          mutex_;
+	int            done_;
+	int            failed_;
+
+	/// Whether a file of a directory belongs to the batch.
+	virtual bool isInputFile(const string &name) const = 0;
+	virtual void addFile(const string &fileName);
+
+	/**
+	 * \brief Processes the file \c index and counts it by finishFile(),
+	 *        called from the worker threads.
+	 */
+	virtual void processFile(unsigned index) = 0;
+
+	/**
+	 * \brief Counts a processed file, with \c mutex_ locked.
+	 *
+	 * \returns the number of files done (including this one)
+	 */
+	int finishFile(bool ok);
+
+	/// Number of the worker threads run() starts.
+	int getWorkerCount() const;
+
+	/**
+	 * \brief Processes all of the files by the workers.
+	 *
+	 * \returns the time it took in seconds
+	 */
+	double runWorkers();
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param fileType type of the input files, for the messages (e.g. "WAV")
+	 * \param threads  number of files processed at once
+	 */
+	FileBatch(const string &fileType, int threads);
+	virtual ~FileBatch();
+
+	/**
+	 * \brief Adds files to the batch.
+	 *
+	 * \c input is a file, a directory (all of the input files in it, sorted
+	 * by name), a glob pattern or a list file (\c \@FILE, one file name per
+	 * line).
+	 *
+	 * \returns \c false if \c input matches no file
+	 */
+	bool addInput(const string &input);
+	int  getFileCount() const { return files_.size(); }
+
+	/**
+	 * \brief Returns whether a command line argument has to be processed
+	 *        as a batch (it is not a single file).
+	 */
+	static bool isBatchInput(const string &input);
+
+	/// Returns the time between \c start and \c end in seconds.
+	static double secondsBetween(const WFTime &start, const WFTime &end);
+};
+
+#endif /* end of include guard: FILEBATCH_P5TC2WKM */
+
@@ -8,6 +8,97 @@
 
 #include "Frontend.h"
 #include <cppapp/utils.h>
+#include <cppapp/Logger.h>
+
+#include <cstdlib>
+
+
+/// Seconds of samples between the checks of the clock drift of live streams.
+#define DRIFT_CHECK_INTERVAL 10
+
+
+long StreamPosition::toSamples(const StreamInfo &info) const
+{
+	switch (type) {
+	case POSITION_NONE:
+		return 0;
+	case POSITION_SAMPLES:
+		return samples;
+	case POSITION_SECONDS:
+		return (long)(seconds * info.sampleRate);
+	case POSITION_TIME:
+		{
+			int64_t us =
+				((int64_t)time.seconds() - info.timeOffset.seconds()) * US_IN_SECOND +
+				((int64_t)time.microseconds() - info.timeOffset.microseconds());
+			int64_t result = us / US_IN_SECOND * info.sampleRate +
+				(us % US_IN_SECOND) * info.sampleRate / US_IN_SECOND;
+			return (long)result;
+		}
+	}
+	return 0;
+}
+
+
+bool StreamPosition::parse(const string &text, StreamPosition *result)
+{
+	*result = StreamPosition();
+	if (text.empty()) return true;
+	
+	if (WFTime::parse(text, &(result->time))) {
+		result->type = POSITION_TIME;
+		return true;
+	}
+	
+	const char *begin = text.c_str();
+	char *end;
+	
+	if (text[text.size() - 1] == 's') {
+		result->seconds = strtod(begin, &end);
+		result->type = POSITION_SECONDS;
+		return (end != begin) && (*end == 's') && (end[1] == '\0');
+	}
+	
+	result->samples = strtol(begin, &end, 10);
+	result->type = POSITION_SAMPLES;
+	return (end != begin) && (*end == '\0');
+}
+
+
+/**
+ * Restricts \c streamInfo_ (with the length of the whole stream set) to
+ * the range set by setRange().
+ *
+ * The start is moved back to a multiple of the segment alignment of the
+ * backend, so the FFT frames (and snapshots) are the same as when the whole
+ * stream is processed.
+ */
+void Frontend::applyRange(Ref<Backend> backend)
+{
+	long total = streamInfo_.length;
+	
+	long start = rangeStart_.toSamples(streamInfo_);
+	if (start < 0) start = 0;
+	if (start > total) start = total;
+	
+	long alignment = backend.isNotNull() ? backend->getSegmentAlignment(streamInfo_) : 1;
+	if (alignment > 1) start -= start % alignment;
+	
+	long end = rangeEnd_.isSet() ? rangeEnd_.toSamples(streamInfo_) : total;
+	if (end > total) end = total;
+	if (end < start) end = start;
+	
+	streamInfo_.startOffset = start;
+	streamInfo_.length = end - start;
+	streamInfo_.knownLength = true;
+	
+	if (hasRange()) {
+		LOG_INFO("Processing samples " << start << " to " << end << " of " <<
+			    total << " (" <<
+			    streamInfo_.timeOffset.addSamples(start, streamInfo_.sampleRate)
+			        .format("%Y-%m-%d %H:%M:%S UTC") << ").");
+	}
+}
 
 
 /**
@@ -15,12 +106,24 @@
  */
 void Frontend::startStream()
 {
+	if (pacingClock_.isNotNull())
+		streamInfo_.realTime = true;
+	
 	if (backend_.isNotNull()) {
 		backend_->startStream(streamInfo_);
 	}
 	
-	dataInfo_.offset = 0;
-	dataInfo_.timeOffset = streamInfo_.timeOffset;
+	dataInfo_.offset = streamInfo_.startOffset;
+	dataInfo_.timeOffset = streamInfo_.timeOffset.addSamples(
+		streamInfo_.startOffset,
+		streamInfo_.sampleRate
+	);
+	
+	driftCheckOffset_ = streamInfo_.startOffset;
+	driftReported_ = 0;
+	
+	if (pacingClock_.isNotNull())
+		pacingClock_->synchronize(dataInfo_.timeOffset);
 }
 
 
@@ -38,13 +141,83 @@ void Frontend::endStream()
 /**
  *
  */
-void Frontend::process(const vector<Complex> &data)
+void Frontend::process(const SampleSpan &data)
 {
+	if (pacingClock_.isNotNull()) {
+		pacingClock_->sleepUntil(streamInfo_.timeOffset.addSamples(
+			dataInfo_.offset + data.length,
+			streamInfo_.sampleRate
+		));
+	}
+	
 	if (backend_.isNotNull()) {
-		backend_->process(data, dataInfo_);
+		processBlock(backend_, data, dataInfo_);
+	} else {
+		Metrics::count(METRIC_SAMPLES_IN, data.length);
 	}
 	
-	dataInfo_.offset += data.size();
+	if (streamInfo_.realTime) checkDrift(dataInfo_.offset + data.length);
+	skip(data.length);
+}
+
+
+/**
+ * Compares the time of the stream position \c end with the clock, every
+ * DRIFT_CHECK_INTERVAL seconds of samples of a live stream.
+ *
+ * The times of the samples are counted from the start of the stream by the
+ * sample rate, i.e. by the clock of the sound card (or of the sender), which
+ * runs off the wall clock by up to tens of ppm (seconds a day). The times
+ * are not corrected (that would put jumps into the snapshots); instead, the
+ * difference (including the constant latency of the capture) is published as
+ * the clock_drift gauge of the metrics and logged whenever it grows by
+ * another second.
+ */
+void Frontend::checkDrift(long end)
+{
+	if (end - driftCheckOffset_ < (long)streamInfo_.sampleRate * DRIFT_CHECK_INTERVAL)
+		return;
+	driftCheckOffset_ = end;
+	
+	WFTime streamTime = streamInfo_.timeOffset.addSamples(end, streamInfo_.sampleRate);
+	WFTime now = Clock::getDefault()->now();
+	int64_t drift =
+		((int64_t)now.seconds() - streamTime.seconds()) * US_IN_SECOND +
+		((int64_t)now.microseconds() - streamTime.microseconds());
+	Metrics::set(GAUGE_CLOCK_DRIFT, drift);
+	
+	int64_t magnitude = (drift < 0) ? -drift : drift;
+	if (magnitude / US_IN_SECOND > driftReported_) {
+		driftReported_ = magnitude / US_IN_SECOND;
+		LOG_WARNING("The stream time is " << (magnitude / 1e6) << " s " <<
+				  ((drift > 0) ? "behind" : "ahead of") << " the clock.");
+	}
+}
+
+
+/**
+ * Passes a block of samples to \c backend, measured like all the blocks of
+ * the frontends (for frontends which feed several backends at once).
+ */
+void Frontend::processBlock(Ref<Backend> backend, const SampleSpan &data, DataInfo info)
+{
+	{
+		LatencyTimer timer(LATENCY_FRONTEND_BLOCK);
+		TraceScope trace(TRACE_PROCESS);
+		backend->process(data, info);
+	}
+	
+	Metrics::count(METRIC_SAMPLES_IN, data.length);
+}
+
+
+/**
+ * Advances the stream position by \c count samples that were lost (for
+ * example dropped by the frontend) without passing them to the backend.
+ */
+void Frontend::skip(long count)
+{
+	dataInfo_.offset += count;
 	dataInfo_.timeOffset = streamInfo_.timeOffset.addSamples(
 		dataInfo_.offset,
 		streamInfo_.sampleRate
@@ -52,3 +225,12 @@ void Frontend::process(const vector<Complex> &data)
 }
 
 
+long Frontend::getProcessedLength() const
+{
+	// The overlap after the end of the range doesn't count.
+	long length = dataInfo_.offset - streamInfo_.startOffset;
+	if (streamInfo_.knownLength && (length > streamInfo_.length))
+		length = streamInfo_.length;
+	return length;
+}
+
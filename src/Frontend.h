@@ -9,11 +9,59 @@
 #ifndef FRONTEND_OBVGMG1U
 #define FRONTEND_OBVGMG1U
 
+#include <string>
+
+using namespace std;
+
 #include <cppapp/Object.h>
 
 using namespace cppapp;
 
 #include "Backend.h"
+#include "Clock.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+
+/**
+ * \brief Position in a stream given as a sample offset, a time relative to
+ *        the first sample or an absolute time.
+ */
+struct StreamPosition {
+	enum Type {
+		/// Not set (the start or the end of the stream).
+		POSITION_NONE,
+		POSITION_SAMPLES,
+		POSITION_SECONDS,
+		POSITION_TIME
+	};
+	
+	Type   type;
+	long   samples;
+	double seconds;
+	WFTime time;
+	
+	StreamPosition() : type(POSITION_NONE), samples(0), seconds(0) {}
+	
+	bool isSet() const { return type != POSITION_NONE; }
+	
+	/**
+	 * \brief Returns the offset of the position from the first sample of
+	 *        the stream in samples (may be negative).
+	 */
+	long toSamples(const StreamInfo &info) const;
+	
+	/**
+	 * \brief Parses a position: a number of samples ("480000"), seconds
+	 *        from the start of the stream ("10.5s") or a UTC time
+	 *        ("2013-08-16 10:20:30.5"). An empty string is an unset
+	 *        position.
+	 *
+	 * \returns \c false if the text is not a valid position
+	 */
+	static bool parse(const string &text, StreamPosition *result);
+};
+
 
 /**
  * \todo Write documentation for class Frontend.
@@ -28,17 +76,80 @@ protected:
 	StreamInfo   streamInfo_;
 	DataInfo     dataInfo_;
 	
+	/// Time of the first sample if set by setStartTime().
+	WFTime       startTime_;
+	bool         hasStartTime_;
+	
+	/// Part of the stream to be processed (see setRange()).
+	StreamPosition rangeStart_;
+	StreamPosition rangeEnd_;
+	
+	/// Clock the samples are paced to (see setPacingClock()).
+	Ref<Clock>   pacingClock_;
+	
+	/// Stream position of the last check of the clock drift.
+	long         driftCheckOffset_;
+	/// Drift (whole seconds) last reported in the log.
+	long         driftReported_;
+	
+	bool hasRange() const { return rangeStart_.isSet() || rangeEnd_.isSet(); }
+	void applyRange(Ref<Backend> backend);
+	
 	void startStream();
 	void endStream();
-	void process(const vector<Complex> &data);
+	void process(const SampleSpan &data);
+	/**
+	 * \brief Skips \c count samples of the stream (e.g. lost ones), the
+	 *        backend sees the gap in the offset of the next block.
+	 */
+	void skip(long count);
+	void checkDrift(long end);
+	
+	static void processBlock(Ref<Backend> backend, const SampleSpan &data, DataInfo info);
 	
 public:
-	Frontend() {}
+	Frontend() : hasStartTime_(false), driftCheckOffset_(0), driftReported_(0) {}
 	virtual ~Frontend() {}
 	
 	void setBackend(Ref<Backend> backend) { backend_ = backend; }
 	
+	/**
+	 * \brief Sets the time of the first sample of recordings that don't
+	 *        carry it themselves.
+	 */
+	void setStartTime(WFTime time) { startTime_ = time; hasStartTime_ = true; }
+	
+	/**
+	 * \brief Restricts the processing to a part of the stream, for
+	 *        frontends that can seek (files).
+	 *
+	 * Unset positions stand for the start and the end of the stream.
+	 */
+	void setRange(const StreamPosition &start, const StreamPosition &end)
+	{
+		rangeStart_ = start;
+		rangeEnd_ = end;
+	}
+	
+	/**
+	 * \brief Paces the samples to a clock, for replaying recordings.
+	 *
+	 * The clock is synchronized to the time of the first sample, and each
+	 * block of samples is passed to the backend once the clock reaches the
+	 * time of its last sample. The stream is treated as live (see
+	 * StreamInfo::realTime), so outputs that fall behind drop spectra.
+	 */
+	void setPacingClock(Ref<Clock> clock) { pacingClock_ = clock; }
+	
 	virtual void run() = 0;
+	
+	const StreamInfo& getStreamInfo() const { return streamInfo_; }
+	
+	/**
+	 * \brief Returns the number of samples of the stream (range) processed
+	 *        by run().
+	 */
+	virtual long getProcessedLength() const;
 };
 
 #endif /* end of include guard: FRONTEND_OBVGMG1U */
@@ -0,0 +1,282 @@
+/**
+ * \file   GeneratorFrontend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the GeneratorFrontend class.
+ */
+
+#include "GeneratorFrontend.h"
+
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <sstream>
+
+
+/**
+ * Returns a gaussian random number with zero mean and unit variance
+ * (Box-Muller transform of the xorshift64* generator).
+ */
+double GeneratorFrontend::nextGaussian()
+{
+	double u[2];
+	for (int i = 0; i < 2; i++) {
+		random_ ^= random_ >> 12;
+		random_ ^= random_ << 25;
+		random_ ^= random_ >> 27;
+		// 53 random bits in (0, 1].
+		u[i] = ((random_ * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+		u[i] = 1.0 - u[i];
+	}
+	return sqrt(-2.0 * log(u[0])) * cos(2.0 * M_PI * u[1]);
+}
+
+
+/**
+ * Fills the buffer with \c count samples starting at sample \c offset.
+ */
+void GeneratorFrontend::generate(long offset, int count)
+{
+	double *re = &(real_[0]);
+	double *im = &(imag_[0]);
+	for (int i = 0; i < count; i++) {
+		re[i] = 0;
+		im[i] = 0;
+	}
+
+	for (unsigned s = 0; s < signals_.size(); s++) {
+		const Signal &signal = signals_[s];
+
+		switch (signal.type) {
+		case Signal::SIGNAL_TONE: {
+			// The phase of the first sample is computed from its position,
+			// the rest by rotation, so the error does not accumulate
+			// between the blocks.
+			double cycles = fmod(signal.frequency * offset / sampleRate_, 1.0);
+			double zr = signal.amplitude * cos(2.0 * M_PI * cycles);
+			double zi = signal.amplitude * sin(2.0 * M_PI * cycles);
+			double wr = cos(2.0 * M_PI * signal.frequency / sampleRate_);
+			double wi = sin(2.0 * M_PI * signal.frequency / sampleRate_);
+
+			for (int i = 0; i < count; i++) {
+				re[i] += zr;
+				im[i] += zi;
+				double r = zr * wr - zi * wi;
+				zi = zr * wi + zi * wr;
+				zr = r;
+			}
+			break;
+		}
+
+		case Signal::SIGNAL_NOISE: {
+			double sigma = signal.amplitude / sqrt(2.0);
+			for (int i = 0; i < count; i++) {
+				re[i] += sigma * nextGaussian();
+				im[i] += sigma * nextGaussian();
+			}
+			break;
+		}
+
+		case Signal::SIGNAL_CHIRP:
+		case Signal::SIGNAL_PULSE: {
+			// Whole samples, so the bursts start exactly every period.
+			long period = lround(signal.period * sampleRate_);
+			long duration = lround(signal.duration * sampleRate_);
+
+			for (int i = 0; i < count; i++) {
+				// Samples since the start of the last burst.
+				long n = offset + i;
+				if (period > 0) n %= period;
+				if (n >= duration) continue;
+
+				double t = (double)(offset + i) / sampleRate_;
+				double tau = (double)n / sampleRate_;
+
+				double phase;
+				double amplitude = signal.amplitude;
+				if (signal.type == Signal::SIGNAL_CHIRP) {
+					phase = signal.frequency * tau +
+						(signal.endFrequency - signal.frequency) * tau * tau /
+						(2.0 * signal.duration);
+					// Decays to 5 % by the end, like an underdense meteor echo.
+					amplitude *= exp(-3.0 * tau / signal.duration);
+				} else {
+					phase = fmod(signal.frequency * t, 1.0);
+				}
+
+				re[i] += amplitude * cos(2.0 * M_PI * phase);
+				im[i] += amplitude * sin(2.0 * M_PI * phase);
+			}
+			break;
+		}
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		buffer_[2 * i]     = re[i];
+		buffer_[2 * i + 1] = im[i];
+	}
+}
+
+
+/**
+ * Constructor.
+ */
+GeneratorFrontend::GeneratorFrontend(int sampleRate, int blockSize) :
+	sampleRate_(sampleRate),
+	blockSize_((blockSize < 1) ? 1 : blockSize),
+	duration_(0),
+	realTime_(true),
+	running_(false),
+	random_(1),
+	buffer_(2 * blockSize_),
+	real_(blockSize_),
+	imag_(blockSize_),
+	processedLength_(0)
+{
+}
+
+
+bool GeneratorFrontend::addSignals(const string &text)
+{
+	stringstream list(text);
+	string item;
+
+	while (getline(list, item, ';')) {
+		if (item.find_first_not_of(" \t") == string::npos) continue;
+
+		Signal signal;
+		if (!parseSignal(item, &signal)) return false;
+		addSignal(signal);
+	}
+
+	return true;
+}
+
+
+void GeneratorFrontend::stop()
+{
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+}
+
+
+void GeneratorFrontend::run()
+{
+	long length = (long)(duration_ * sampleRate_);
+
+	streamInfo_ = StreamInfo();
+	streamInfo_.sampleRate = sampleRate_;
+	streamInfo_.realTime = realTime_;
+	streamInfo_.timeOffset = hasStartTime_ ? startTime_ : Clock::getDefault()->now();
+	if (length > 0) {
+		streamInfo_.length = length;
+		streamInfo_.knownLength = true;
+	}
+	startStream();
+
+	LOG_INFO("Generating " << signals_.size() << " signals at " << sampleRate_ <<
+		    " Hz" << (realTime_ ? " in real time" : "") << "...");
+
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	__atomic_store_n(&running_, true, __ATOMIC_RELEASE);
+	processedLength_ = 0;
+
+	while (__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) {
+		long count = blockSize_;
+		if (length > 0) {
+			if (processedLength_ >= length) break;
+			if (count > length - processedLength_)
+				count = length - processedLength_;
+		}
+
+		generate(processedLength_, count);
+
+		// The block is passed on when its last sample would have arrived.
+		if (realTime_) {
+			long end = processedLength_ + count;
+			struct timespec wakeUp = start;
+			wakeUp.tv_sec  += end / sampleRate_;
+			wakeUp.tv_nsec += (long)((end % sampleRate_) * (1000000000.0 / sampleRate_));
+			while (wakeUp.tv_nsec >= 1000000000) {
+				wakeUp.tv_sec++;
+				wakeUp.tv_nsec -= 1000000000;
+			}
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, NULL) == EINTR);
+		}
+
+		process(SampleSpan(SAMPLE_COMPLEX_FLOAT, &(buffer_[0]), count));
+		processedLength_ += count;
+	}
+
+	endStream();
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double seconds = (double)(now.tv_sec - start.tv_sec) +
+		(double)(now.tv_nsec - start.tv_nsec) * 1e-9;
+	if (seconds <= 0) seconds = 1e-9;
+
+	LOG_INFO("Generated " << processedLength_ << " samples in " << seconds << " s (" <<
+		    (processedLength_ / seconds / 1e6) << " MS/s, " <<
+		    (processedLength_ / seconds / sampleRate_) << "x real time).");
+}
+
+
+bool GeneratorFrontend::parseSignal(const string &text, Signal *signal)
+{
+	istringstream input(text);
+	string type;
+	vector<double> values;
+	double value;
+
+	input >> type;
+	while (input >> value) values.push_back(value);
+	if (!input.eof()) return false;
+
+	Signal result;
+	unsigned required;
+
+	if (type == "tone") {
+		result.type = Signal::SIGNAL_TONE;
+		required = 1;
+		if (values.size() >= 1) result.frequency = values[0];
+	} else if (type == "noise") {
+		result.type = Signal::SIGNAL_NOISE;
+		required = 0;
+	} else if (type == "chirp") {
+		result.type = Signal::SIGNAL_CHIRP;
+		required = 4;
+		if (values.size() >= 4) {
+			result.frequency = values[0];
+			result.endFrequency = values[1];
+			result.duration = values[2];
+			result.period = values[3];
+		}
+	} else if (type == "pulse") {
+		result.type = Signal::SIGNAL_PULSE;
+		required = 3;
+		if (values.size() >= 3) {
+			result.frequency = values[0];
+			result.duration = values[1];
+			result.period = values[2];
+		}
+	} else {
+		return false;
+	}
+
+	if ((values.size() < required) || (values.size() > required + 1))
+		return false;
+	if (values.size() == required + 1)
+		result.amplitude = values[required];
+
+	if ((result.type == Signal::SIGNAL_CHIRP) || (result.type == Signal::SIGNAL_PULSE)) {
+		if ((result.duration <= 0) || (result.period < 0)) return false;
+	}
+
+	*signal = result;
+	return true;
+}
+
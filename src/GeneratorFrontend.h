@@ -0,0 +1,137 @@
+/**
+ * \file   GeneratorFrontend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the GeneratorFrontend class.
+ */
+
+#ifndef GENERATORFRONTEND_R2WD7FKS
+#define GENERATORFRONTEND_R2WD7FKS
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "Frontend.h"
+
+
+/**
+ * \brief Frontend generating a synthetic signal of known content.
+ *
+ * The signal is a sum of tones, complex gaussian noise, chirps and pulses
+ * (see Signal). The samples are generated as 32-bit float IQ pairs, either
+ * paced to the sample rate (a live stream) or as fast as the backend takes
+ * them, which makes the frontend useful for measuring the highest sample
+ * rate the pipeline sustains and for testing detectors against signals
+ * whose position is known.
+ */
+class GeneratorFrontend : public Frontend {
+public:
+	/**
+	 * \brief Component of the generated signal.
+	 *
+	 * The bursts (chirps and pulses) start every \c period seconds (0 for
+	 * a single burst), the first one at the start of the stream. The period
+	 * and the duration of the bursts are rounded to whole samples.
+	 */
+	struct Signal {
+		enum Type {
+			/// Constant tone of \c frequency.
+			SIGNAL_TONE,
+			/// Complex gaussian noise, \c amplitude is its RMS.
+			SIGNAL_NOISE,
+			/// Linear sweep from \c frequency to \c endFrequency lasting
+			/// \c duration seconds, decaying like a meteor echo.
+			SIGNAL_CHIRP,
+			/// Tone of \c frequency lasting \c duration seconds.
+			SIGNAL_PULSE
+		};
+
+		Type   type;
+		double amplitude;
+		double frequency;
+		double endFrequency;
+		double duration;
+		double period;
+
+		Signal() :
+			type(SIGNAL_TONE), amplitude(0.5), frequency(0), endFrequency(0),
+			duration(0), period(0)
+		{}
+	};
+
+private:
+	int            sampleRate_;
+	int            blockSize_;
+	/// Length of the stream in seconds, 0 for endless.
+	double         duration_;
+	bool           realTime_;
+	bool           running_;
+
+	vector<Signal> signals_;
+	/// State of the noise generator (xorshift64*).
+	uint64_t       random_;
+
+	vector<float>  buffer_;
+	/// Sums of the signals of the block being generated.
+	vector<double> real_;
+	vector<double> imag_;
+	long           processedLength_;
+
+	GeneratorFrontend(const GeneratorFrontend& other);
+
+	double nextGaussian();
+	void   generate(long offset, int count);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param sampleRate sample rate in Hz
+	 * \param blockSize  number of samples passed to the backend at a time
+	 */
+	GeneratorFrontend(int sampleRate, int blockSize = 65536);
+	virtual ~GeneratorFrontend() {}
+
+	void addSignal(const Signal &signal) { signals_.push_back(signal); }
+
+	/**
+	 * \brief Adds the signals of a list separated by semicolons (see
+	 *        parseSignal()).
+	 *
+	 * \returns \c false if any of the signals is invalid
+	 */
+	bool addSignals(const string &text);
+
+	/// Sets the length of the stream in seconds (0 for endless).
+	void setDuration(double seconds) { duration_ = seconds; }
+	/// Sets whether the samples are paced to the sample rate (default).
+	void setRealTime(bool realTime) { realTime_ = realTime; }
+	/// Sets the seed of the noise.
+	void setSeed(uint64_t seed) { random_ = seed ? seed : 1; }
+
+	/**
+	 * \brief Makes run() end the stream after the current block.
+	 */
+	void stop();
+
+	virtual void run();
+
+	virtual long getProcessedLength() const { return processedLength_; }
+
+	/**
+	 * \brief Parses a signal: "tone FREQ [AMPLITUDE]", "noise [AMPLITUDE]",
+	 *        "chirp FREQ END_FREQ DURATION PERIOD [AMPLITUDE]" or
+	 *        "pulse FREQ DURATION PERIOD [AMPLITUDE]". Frequencies are in Hz
+	 *        (negative below the centre), times in seconds.
+	 *
+	 * \returns \c false if the text is not a valid signal
+	 */
+	static bool parseSignal(const string &text, Signal *signal);
+};
+
+#endif /* end of include guard: GENERATORFRONTEND_R2WD7FKS */
+
@@ -0,0 +1,259 @@
+/**
+ * \file   JackChannel.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the JackChannel class.
+ */
+
+#include "JackChannel.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+
+void* JackChannel::threadMethod()
+{
+	setAffinity();
+	run();
+	return NULL;
+}
+
+
+void JackChannel::setAffinity()
+{
+	if (cpu_ < 0) return;
+	
+#ifdef __linux__
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu_, &cpus);
+	
+	int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+	if (error != 0) {
+		LOG_WARNING("JACK channel \"" << name_ << "\": failed to set CPU " <<
+				  "affinity to CPU " << cpu_ << " (error " << error << ").");
+	} else {
+		LOG_INFO("JACK channel \"" << name_ << "\" runs on CPU " << cpu_ << ".");
+	}
+#else
+	LOG_WARNING("JACK channel \"" << name_ << "\": CPU affinity is not " <<
+			  "supported on this platform.");
+#endif
+}
+
+
+JackChannel::JackChannel(const string &name,
+					const string &leftInputName,
+					const string &rightInputName,
+					int           cpu) :
+	Frontend(),
+	name_(name),
+	leftInputName_(leftInputName),
+	rightInputName_(rightInputName),
+	cpu_(cpu),
+	leftPort_(NULL),
+	rightPort_(NULL),
+	leftRing_(NULL),
+	rightRing_(NULL),
+	gapRing_(NULL),
+	thread_(NULL),
+	running_(false),
+	overflowCount_(0),
+	writtenCount_(0),
+	pendingGap_(0),
+	readCount_(0)
+{
+	sem_init(&dataSemaphore_, 0, 0);
+}
+
+
+JackChannel::~JackChannel()
+{
+	if (thread_ != NULL) {
+		stop();
+		join();
+	}
+	
+	sem_destroy(&dataSemaphore_);
+	
+	delete leftRing_;
+	delete rightRing_;
+	delete gapRing_;
+}
+
+
+bool JackChannel::registerPorts(jack_client_t *client)
+{
+	string leftName  = name_.empty() ? "left"  : name_ + "_left";
+	string rightName = name_.empty() ? "right" : name_ + "_right";
+	
+	leftPort_ = jack_port_register(client,
+							 leftName.c_str(),
+							 JACK_DEFAULT_AUDIO_TYPE,
+							 JackPortIsInput, 0);
+	rightPort_ = jack_port_register(client,
+							  rightName.c_str(),
+							  JACK_DEFAULT_AUDIO_TYPE,
+							  JackPortIsInput, 0);
+	
+	return ((leftPort_ != NULL) && (rightPort_ != NULL));
+}
+
+
+bool JackChannel::connectPorts(jack_client_t *client)
+{
+	if (jack_connect(client, leftInputName_.c_str(), jack_port_name(leftPort_))) {
+		LOG_ERROR("Failed to connect left input port to \"" <<
+				leftInputName_ << "\"!");
+		return false;
+	}
+	
+	if (jack_connect(client, rightInputName_.c_str(), jack_port_name(rightPort_))) {
+		LOG_ERROR("Failed to connect right input port to \"" <<
+				rightInputName_ << "\"!");
+		return false;
+	}
+	
+	return true;
+}
+
+
+void JackChannel::start(const StreamInfo &info, int ringSize)
+{
+	leftRing_  = new SPSCRingBuffer<float>(ringSize);
+	rightRing_ = new SPSCRingBuffer<float>(ringSize);
+	// Each queued gap is followed by a period in the ring, so the gap ring
+	// only fills up if the DSP thread is far behind anyway.
+	gapRing_   = new SPSCRingBuffer<Gap>(64);
+	
+	// The stream is started here, so that the threads of the backend don't
+	// inherit the affinity of the DSP thread.
+	streamInfo_ = info;
+	startStream();
+	
+	running_ = true;
+	thread_ = new Thread(this, &JackChannel::threadMethod);
+}
+
+
+void JackChannel::stop()
+{
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+	sem_post(&dataSemaphore_);
+}
+
+
+void JackChannel::join()
+{
+	if (thread_ == NULL) return;
+	
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+}
+
+
+/**
+ * Runs in the JACK real-time thread: no locks, no allocations, no logging.
+ */
+void JackChannel::onJackInput(jack_nframes_t nframes)
+{
+	jack_default_audio_sample_t *left =
+		(jack_default_audio_sample_t *)jack_port_get_buffer(leftPort_, nframes);
+	jack_default_audio_sample_t *right =
+		(jack_default_audio_sample_t *)jack_port_get_buffer(rightPort_, nframes);
+	
+	// The DSP thread releases the left ring before the right one, so if the
+	// period fits into the right ring, it fits into the left one too. The
+	// period is either written to both rings or dropped as a whole, which
+	// keeps the rings in step. The right ring is published last, the DSP
+	// thread reads only as many frames as there are in the right ring.
+	//
+	// The frames dropped since the last period written make a gap, which is
+	// queued before the frames that follow it. If the gap can't be queued,
+	// the period is dropped as well, so that the gaps are never misplaced.
+	bool fits = rightRing_->getWriteSpace() >= (int)nframes;
+	if (fits && (pendingGap_ > 0)) {
+		Gap gap;
+		gap.position = writtenCount_;
+		gap.frames = pendingGap_;
+		fits = gapRing_->tryWrite(&gap, 1);
+		if (fits) pendingGap_ = 0;
+	}
+	
+	if (fits) {
+		leftRing_->write(left, nframes);
+		rightRing_->write(right, nframes);
+		writtenCount_ += nframes;
+	} else {
+		pendingGap_ += nframes;
+		__atomic_add_fetch(&overflowCount_, nframes, __ATOMIC_RELAXED);
+	}
+	
+	sem_post(&dataSemaphore_);
+}
+
+
+int JackChannel::getRingFill() const
+{
+	return (rightRing_ == NULL) ? 0 : rightRing_->getSize();
+}
+
+
+int JackChannel::getRingCapacity() const
+{
+	return (rightRing_ == NULL) ? 0 : rightRing_->getCapacity();
+}
+
+
+long JackChannel::getOverflowCount() const
+{
+	return __atomic_load_n(&overflowCount_, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * The DSP loop, runs in the thread of the channel.
+ */
+void JackChannel::run()
+{
+	while (true) {
+		sem_wait(&dataSemaphore_);
+		
+		bool finish = !__atomic_load_n(&running_, __ATOMIC_ACQUIRE);
+		
+		// Both rings hold the same number of frames, so their contiguous
+		// segments have the same length and can be passed to the backend
+		// without copying. A segment ends at the next gap.
+		const float *left;
+		const float *right;
+		const Gap   *gap;
+		int count;
+		while ((count = rightRing_->peek(&right)) > 0) {
+			// A gap is queued before the frames that follow it.
+			while ((gapRing_->peek(&gap) > 0) && (gap->position <= readCount_)) {
+				skip(gap->frames);
+				gapRing_->consume(1);
+			}
+			if ((gapRing_->peek(&gap) > 0) && (gap->position < readCount_ + count))
+				count = gap->position - readCount_;
+			
+			leftRing_->peek(&left);
+			
+			process(SampleSpan(SAMPLE_PLANAR_FLOAT, left, right, count));
+			
+			leftRing_->consume(count);
+			rightRing_->consume(count);
+			readCount_ += count;
+		}
+		
+		if (finish) break;
+	}
+	
+	endStream();
+}
+
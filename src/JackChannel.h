@@ -0,0 +1,127 @@
+/**
+ * \file   JackChannel.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the JackChannel class.
+ */
+
+#ifndef JACKCHANNEL_W3B7QN6D
+#define JACKCHANNEL_W3B7QN6D
+
+#include <string>
+
+using namespace std;
+
+#include "Frontend.h"
+#include "RingBuffer.h"
+
+#include <semaphore.h>
+
+#include <jack/jack.h>
+
+
+/**
+ * \brief One IQ port pair of the JackFrontend with its own backend.
+ *
+ * The JACK process callback copies the port buffers into two lock-free ring
+ * buffers (one per port) by calling onJackInput(). The DSP thread of the
+ * channel (run()) drains the rings and drives the backend. If the DSP thread
+ * falls behind by more than the length of the rings, whole periods are
+ * dropped and counted as overflows. The callback records where in the
+ * stream each gap is, so the DSP thread skips it right after the frames
+ * written before it and the time of the following samples stays exact.
+ */
+class JackChannel : public Frontend {
+private:
+	typedef MethodThread<void, JackChannel> Thread;
+	
+	/// Frames dropped after the first \c position frames of the stream.
+	struct Gap {
+		long position;
+		long frames;
+	};
+	
+	JackChannel(const JackChannel& other);
+	
+	string       name_;
+	string       leftInputName_;
+	string       rightInputName_;
+	/// CPU the DSP thread is pinned to, -1 for no affinity.
+	int          cpu_;
+	
+	jack_port_t *leftPort_;
+	jack_port_t *rightPort_;
+	
+	SPSCRingBuffer<float> *leftRing_;
+	SPSCRingBuffer<float> *rightRing_;
+	/// Gaps not yet reached by the DSP thread.
+	SPSCRingBuffer<Gap>   *gapRing_;
+	
+	Thread      *thread_;
+	/// Posted by the callback after each period (and by stop()).
+	sem_t        dataSemaphore_;
+	bool         running_;
+	
+	long         overflowCount_;
+	/// Frames written to the rings (JACK thread only).
+	long         writtenCount_;
+	/// Frames dropped since the last period written (JACK thread only).
+	long         pendingGap_;
+	/// Frames taken from the rings (DSP thread only).
+	long         readCount_;
+	
+	void* threadMethod();
+	void  setAffinity();
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param name            suffix of the names of the JACK ports (empty
+	 *                        for the plain "left" and "right" ports)
+	 * \param leftInputName   port the real part is read from
+	 * \param rightInputName  port the imaginary part is read from
+	 * \param cpu             CPU to run the DSP thread on (-1 for any)
+	 */
+	JackChannel(const string &name,
+			  const string &leftInputName,
+			  const string &rightInputName,
+			  int           cpu = -1);
+	virtual ~JackChannel();
+	
+	const string& getName() const { return name_; }
+	
+	bool registerPorts(jack_client_t *client);
+	bool connectPorts(jack_client_t *client);
+	
+	/**
+	 * \brief Allocates the rings, starts the stream and the DSP thread.
+	 */
+	void start(const StreamInfo &info, int ringSize);
+	/**
+	 * \brief Makes the DSP thread process the rest of the rings and end
+	 *        the stream.
+	 */
+	void stop();
+	void join();
+	
+	/**
+	 * \brief Copies one period from the ports to the rings (called from
+	 *        the JACK real-time thread).
+	 */
+	void onJackInput(jack_nframes_t nframes);
+	
+	/// Returns the number of frames waiting in the ring for the DSP thread.
+	int  getRingFill() const;
+	/// Returns the capacity of the ring in frames.
+	int  getRingCapacity() const;
+	/// Returns the number of frames dropped because the ring was full.
+	long getOverflowCount() const;
+	
+	virtual void run();
+};
+
+
+#endif /* end of include guard: JACKCHANNEL_W3B7QN6D */
+
@@ -8,31 +8,36 @@
 
 #include "JackFrontend.h"
 
+#include <cmath>
+#include <sstream>
+
 #include <cppapp/cppapp.h>
 using namespace cppapp;
 
 
+/**
+ * Runs in the JACK real-time thread before the first callback, so the trace
+ * buffer of the thread is allocated here rather than in the callback.
+ */
+void JackFrontend::onJackThreadInit(void *arg)
+{
+	if (Trace::isEnabled()) Trace::setThreadName("jack");
+}
+
+
+/**
+ * Runs in the JACK real-time thread: no locks, no allocations, no logging.
+ */
 int JackFrontend::onJackInput(jack_nframes_t nframes, void *arg)
 {
 	JackFrontend *self = (JackFrontend*)arg;
-
-	jack_default_audio_sample_t *left =
-		(jack_default_audio_sample_t *)jack_port_get_buffer(self->leftPort_, nframes);
-	jack_default_audio_sample_t *right =
-		(jack_default_audio_sample_t *)jack_port_get_buffer(self->rightPort_, nframes);
-	
-	//int offset = outputBuffer_.size();
-	//outputBuffer_.resize(offset + nframes);
-	int offset = 0;
-	self->outputBuffer_.resize(nframes);
-	
-	for (int i = 0; i < (int)nframes; i++) {
-		self->outputBuffer_[offset + i].real = left[i];
-		self->outputBuffer_[offset + i].imag = right[i];
-	}
+	TraceScope trace(TRACE_JACK_CALLBACK);
+	uint64_t begin = Metrics::now();
 	
-	self->process(self->outputBuffer_);
+	for (unsigned i = 0; i < self->channels_.size(); i++)
+		self->channels_[i]->onJackInput(nframes);
 	
+	self->deadlines_.record(begin, Metrics::now(), nframes);
 	return 0;
 }
 
@@ -41,12 +46,59 @@ void JackFrontend::onJackShutdown(void *arg)
 {
 	JackFrontend *self = (JackFrontend*)arg;
 
-	self->endStream();
+	self->stop();
+}
+
+
+int JackFrontend::onJackXrun(void *arg)
+{
+	JackFrontend *self = (JackFrontend*)arg;
+	
+	__atomic_add_fetch(&self->xrunCount_, 1, __ATOMIC_RELAXED);
+	self->deadlines_.recordXrun(Metrics::now());
+	
+	return 0;
+}
+
+
+void JackFrontend::stop()
+{
+	for (unsigned i = 0; i < channels_.size(); i++)
+		channels_[i]->stop();
+	
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+}
+
+
+JackFrontend::JackFrontend(const char *leftInputName, const char *rightInputName,
+					  float ringLength) :
+	leftInputName_((leftInputName == NULL) ? "system:capture_1" : leftInputName),
+	rightInputName_((rightInputName == NULL) ? "system:capture_2" : rightInputName),
+	ringLength_(ringLength),
+	running_(false),
+	xrunCount_(0)
+{
+}
+
+
+void JackFrontend::addChannel(Ref<JackChannel> channel, Ref<Backend> backend)
+{
+	channel->setBackend(backend);
+	channels_.push_back(channel);
+}
+
+
+long JackFrontend::getXrunCount() const
+{
+	return __atomic_load_n(&xrunCount_, __ATOMIC_RELAXED);
 }
 
 
 void JackFrontend::run()
 {
+	if (channels_.empty())
+		addChannel(new JackChannel("", leftInputName_, rightInputName_), backend_);
+	
 	jack_options_t options = JackNullOption;
 	jack_status_t  status;
 	const char *client_name = "waterfall";
@@ -71,50 +123,94 @@ void JackFrontend::run()
 	
 	streamInfo_ = StreamInfo();
 	streamInfo_.sampleRate = jack_get_sample_rate(client);
-	streamInfo_.timeOffset = WFTime::now();
+	streamInfo_.timeOffset = Clock::getDefault()->now();
+	streamInfo_.realTime = true;
+	
+	deadlines_.setSampleRate(streamInfo_.sampleRate);
+	
+	// The rings have to hold at least a few periods.
+	int ringSize = (int)ceil(ringLength_ * streamInfo_.sampleRate);
+	int minRingSize = 4 * jack_get_buffer_size(client);
+	if (ringSize < minRingSize) ringSize = minRingSize;
+	
+	for (unsigned i = 0; i < channels_.size(); i++) {
+		if (!channels_[i]->registerPorts(client)) {
+			LOG_ERROR("No more JACK ports available.");
+			jack_client_close(client);
+			return;
+		}
+	}
+	
+	LOG_INFO("Starting " << channels_.size() << " JACK channel(s), ring buffer: " <<
+		    ringSize << " frames (" <<
+		    ((float)ringSize / streamInfo_.sampleRate) << "s).");
 	
-	startStream();
+	running_ = true;
+	for (unsigned i = 0; i < channels_.size(); i++)
+		channels_[i]->start(streamInfo_, ringSize);
 	
+	jack_set_thread_init_callback(client, onJackThreadInit, (void*)this);
 	jack_set_process_callback(client, onJackInput, (void*)this);
+	jack_set_xrun_callback(client, onJackXrun, (void*)this);
 	jack_on_shutdown(client, onJackShutdown, (void*)this);
 	
-	leftPort_ = jack_port_register(client,
-							 "left",
-							 JACK_DEFAULT_AUDIO_TYPE,
-							 JackPortIsInput, 0);
-	rightPort_ = jack_port_register(client,
-							  "right",
-							  JACK_DEFAULT_AUDIO_TYPE,
-							  JackPortIsInput, 0);
-	
-	if ((leftPort_ == NULL) || (rightPort_ == NULL)) {
-		LOG_ERROR("No more JACK ports available.");
-		return;
-	}
-	
 	if (jack_activate(client)) {
 		LOG_ERROR("Cannot activate client.");
-		return;
+		stop();
 	}
 	
-	if (jack_connect(client, leftInputName_, jack_port_name(leftPort_))) {
-		LOG_ERROR("Failed to connect left input port to \"" <<
-				leftInputName_ << "\"!");
-		return;
+	for (unsigned i = 0; running_ && (i < channels_.size()); i++) {
+		if (!channels_[i]->connectPorts(client)) {
+			jack_client_close(client);
+			client = NULL;
+			stop();
+		}
 	}
 	
-	if (jack_connect(client, rightInputName_, jack_port_name(rightPort_))) {
-		LOG_ERROR("Failed to connect right input port to \"" <<
-				rightInputName_ << "\"!");
-		return;
-	}
-
-	// Yep, active waiting. Pretty much.
-	while (true) {
+	// Report the counters while the stream runs.
+	long lastXruns = 0;
+	vector<long> lastOverflows(channels_.size(), 0);
+	DeadlineStats lastDeadlines;
+	while (__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) {
 		sleep(2);
+		
+		deadlines_.check(&lastDeadlines);
+		
+		long xruns = getXrunCount();
+		if (xruns != lastXruns) {
+			LOG_WARNING("JACK xruns: " << xruns << " (" <<
+					  (xruns - lastXruns) << " new).");
+			lastXruns = xruns;
+		}
+		
+		for (unsigned i = 0; i < channels_.size(); i++) {
+			Ref<JackChannel> channel = channels_[i];
+			long overflows = channel->getOverflowCount();
+			
+			if (overflows != lastOverflows[i]) {
+				LOG_WARNING("JACK channel \"" << channel->getName() <<
+						  "\": ring overflow, dropped " << overflows <<
+						  " frames (" << (overflows - lastOverflows[i]) <<
+						  " new).");
+				lastOverflows[i] = overflows;
+			}
+			
+			LOG_DEBUG("JACK channel \"" << channel->getName() <<
+					"\": ring fill " << channel->getRingFill() << "/" <<
+					channel->getRingCapacity() << " frames.");
+		}
 	}
 	
-	jack_client_close(client);
+	// Closing the client first makes sure the callback no longer runs.
+	if (client != NULL) jack_client_close(client);
+	
+	DeadlineStats deadlines;
+	deadlines_.getStats(&deadlines);
+	stringstream text;
+	deadlines.write(text);
+	LOG_INFO("JACK callback deadline: " << text.str() << ".");
+	
+	for (unsigned i = 0; i < channels_.size(); i++)
+		channels_[i]->join();
 }
 
-
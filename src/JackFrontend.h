@@ -9,12 +9,26 @@
 #ifndef JACKFRONTEND_J2RTK7C1
 #define JACKFRONTEND_J2RTK7C1
 
+#include <vector>
+
+using namespace std;
+
+#include "DeadlineMonitor.h"
 #include "Frontend.h"
+#include "JackChannel.h"
 
 #include <jack/jack.h>
 
 /**
- * \todo Write documentation for class JackFrontend.
+ * \brief Frontend reading one or more IQ signals from a single JACK client.
+ *
+ * Each IQ signal is read from a pair of JACK ports (the real and the
+ * imaginary part) by a JackChannel which has its own backend and its own
+ * DSP thread. The JACK process callback only copies the port buffers into
+ * the lock-free rings of the channels, see JackChannel.
+ *
+ * If no channel is added, a single channel with the "left" and "right"
+ * ports feeding the backend of the frontend is used.
  */
 class JackFrontend : public Frontend {
 private:
@@ -23,32 +37,50 @@ private:
 	 */
 	JackFrontend(const JackFrontend& other);
 	
+	static void onJackThreadInit(void *arg);
 	static int  onJackInput(jack_nframes_t nframes, void *arg);
 	static void onJackShutdown(void *arg);
+	static int  onJackXrun(void *arg);
 	
 	const char *leftInputName_;
 	const char *rightInputName_;
 	
-	jack_port_t *leftPort_;
-	jack_port_t *rightPort_;
+	/// Length of the rings in seconds.
+	float                     ringLength_;
+	vector<Ref<JackChannel> > channels_;
+	
+	bool                      running_;
+	long                      xrunCount_;
+	/// Utilization of the JACK periods by the callback.
+	DeadlineMonitor           deadlines_;
 	
-	vector<Complex> outputBuffer_;
+	void stop();
 
 public:
 	/**
 	 * Constructor.
 	 */
-	JackFrontend(const char *leftInputName, const char *rightInputName) :
-		leftInputName_((leftInputName == NULL) ? "system:capture_1" : leftInputName),
-		rightInputName_((rightInputName == NULL) ? "system:capture_2" : rightInputName),
-		leftPort_(NULL),
-		rightPort_(NULL)
-	{}
+	JackFrontend(const char *leftInputName, const char *rightInputName,
+			   float ringLength = 2.0);
 	/**
 	 * Destructor.
 	 */
 	virtual ~JackFrontend() {}
 	
+	/**
+	 * \brief Adds an IQ port pair with its own backend.
+	 *
+	 * The ports of the channel are named NAME_left and NAME_right.
+	 */
+	void addChannel(Ref<JackChannel> channel, Ref<Backend> backend);
+	int  getChannelCount() const { return channels_.size(); }
+	Ref<JackChannel> getChannel(int index) { return channels_[index]; }
+	
+	/// Returns the number of xruns reported by JACK.
+	long getXrunCount() const;
+	
+	DeadlineMonitor& getDeadlineMonitor() { return deadlines_; }
+	
 	virtual void run();
 };
 
@@ -0,0 +1,336 @@
+/**
+ * \file   MappedWAVFrontend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the MappedWAVFrontend class.
+ */
+
+#include "MappedWAVFrontend.h"
+
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+
+/// Reads a little-endian integer of type T from (possibly unaligned) memory.
+template<class T>
+static inline T readScalar(const char *data)
+{
+	T result;
+	memcpy(&result, data, sizeof(T));
+	return result;
+}
+
+
+bool MappedWAVFrontend::map()
+{
+	int fd = ::open(fileName_.c_str(), O_RDONLY);
+	if (fd < 0) {
+		LOG_ERROR("Failed to open \"" << fileName_ << "\": " << strerror(errno));
+		return false;
+	}
+	
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		LOG_ERROR("Failed to stat \"" << fileName_ << "\": " << strerror(errno));
+		::close(fd);
+		return false;
+	}
+	size_ = st.st_size;
+	modificationTime_ = st.st_mtime;
+	
+	void *data = (size_ > 0) ? mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	// The mapping stays valid after the file is closed.
+	::close(fd);
+	
+	if (data == MAP_FAILED) {
+		LOG_ERROR("Failed to map \"" << fileName_ << "\": " << strerror(errno));
+		size_ = 0;
+		return false;
+	}
+	
+	data_ = (const char*)data;
+	madvise(data, size_, MADV_SEQUENTIAL);
+	
+	return true;
+}
+
+
+void MappedWAVFrontend::unmap()
+{
+	if (data_ == NULL) return;
+	
+	munmap((void*)data_, size_);
+	data_ = NULL;
+	size_ = 0;
+}
+
+
+/**
+ * Reads the chunks of RIFF and RF64/BW64 files (32-bit chunk IDs and sizes,
+ * the 64-bit sizes of RF64 files are in the "ds64" chunk).
+ */
+void MappedWAVFrontend::readRIFF(bool rf64)
+{
+	const char *end = data_ + size_;
+	const char *chunk = data_ + 12;
+	uint64_t dataSize64 = 0;
+	
+	while (end - chunk >= 8) {
+		uint64_t size = readScalar<uint32_t>(chunk + 4);
+		const char *body = chunk + 8;
+		
+		if (memcmp(chunk, WAVFormat::DS64_SUBCHUNK_ID, 4) == 0) {
+			if (rf64 && (size >= 16) && (end - body >= 16))
+				dataSize64 = readScalar<uint64_t>(body + 8);
+		} else if ((memcmp(chunk, WAVFormat::DATA_SUBCHUNK_ID, 4) == 0) &&
+		           (size == WAVFormat::RF64_SIZE) && (dataSize64 > 0)) {
+			size = dataSize64;
+		}
+		
+		if (size > (uint64_t)(end - body)) {
+			LOG_WARNING("WAV chunk exceeds the end of the file, truncating.");
+			size = end - body;
+		}
+		
+		if (memcmp(chunk, WAVFormat::FORMAT_SUBCHUNK_ID, 4) == 0) {
+			readFormatChunk(body, size);
+		} else if (memcmp(chunk, WAVFormat::DATA_SUBCHUNK_ID, 4) == 0) {
+			readDataChunk(body, size);
+		}
+		
+		// Chunks are padded to an even size.
+		if ((uint64_t)(end - body) <= size + (size & 1)) break;
+		chunk = body + size + (size & 1);
+	}
+}
+
+
+/**
+ * Reads the chunks of Sony Wave64 files (GUIDs as chunk IDs, 64-bit sizes
+ * including the header, chunks aligned to 8 bytes).
+ */
+void MappedWAVFrontend::readW64()
+{
+	const char *end = data_ + size_;
+	const char *chunk = data_ + 40;
+	
+	while (end - chunk >= 24) {
+		uint64_t size = readScalar<uint64_t>(chunk + 16);
+		const char *body = chunk + 24;
+		
+		if (size < 24) {
+			LOG_ERROR("Invalid Wave64 chunk size (" << size << ").");
+			break;
+		}
+		size -= 24;
+		
+		if (size > (uint64_t)(end - body)) {
+			LOG_WARNING("WAV chunk exceeds the end of the file, truncating.");
+			size = end - body;
+		}
+		
+		if (memcmp(chunk, WAVFormat::W64_FMT_GUID, 16) == 0) {
+			readFormatChunk(body, size);
+		} else if (memcmp(chunk, WAVFormat::W64_DATA_GUID, 16) == 0) {
+			readDataChunk(body, size);
+		}
+		
+		uint64_t padded = (size + 7) & ~(uint64_t)7;
+		if ((uint64_t)(end - body) <= padded) break;
+		chunk = body + padded;
+	}
+}
+
+
+void MappedWAVFrontend::readFormatChunk(const char *chunk, uint64_t size)
+{
+	if (!format_.parse(chunk, size)) {
+		LOG_ERROR("WAV format chunk too short (" << size << " bytes).");
+		return;
+	}
+	
+	formatRead_ = format_.getSampleFormat(&sampleFormat_);
+	
+	if (!formatRead_) {
+		LOG_ERROR("Unsupported WAV format (format " << format_.formatCode <<
+				", " << format_.channelCount << " channels, " <<
+				format_.bitsPerSample << " bits per sample, " <<
+				format_.sampleRate << " Hz, block of " <<
+				format_.blockAlign << " bytes).");
+	} else if (format_.channelCount > 2) {
+		LOG_WARNING("WAV file has " << format_.channelCount <<
+				  " channels, only the first two are used.");
+	}
+	
+	streamInfo_.sampleRate = format_.sampleRate;
+}
+
+
+void MappedWAVFrontend::readDataChunk(const char *chunk, uint64_t size)
+{
+	if (!formatRead_) {
+		LOG_ERROR("WAV data chunk before a supported format chunk, skipping.");
+		return;
+	}
+	
+	chunks_.push_back(DataChunk(chunk, size / format_.blockAlign));
+}
+
+
+bool MappedWAVFrontend::open()
+{
+	if (!map()) return false;
+	
+	streamInfo_ = StreamInfo();
+	dataInfo_ = DataInfo();
+	
+	formatRead_ = false;
+	chunks_.clear();
+	
+	if ((size_ >= 40) &&
+	    (memcmp(data_, WAVFormat::W64_RIFF_GUID, 16) == 0) &&
+	    (memcmp(data_ + 24, WAVFormat::W64_WAVE_GUID, 16) == 0)) {
+		readW64();
+	} else if ((size_ >= 12) && (memcmp(data_ + 8, WAVFormat::CHUNK_FORMAT, 4) == 0)) {
+		if (memcmp(data_, WAVFormat::CHUNK_ID, 4) == 0) {
+			readRIFF(false);
+		} else if ((memcmp(data_, WAVFormat::RF64_CHUNK_ID, 4) == 0) ||
+		           (memcmp(data_, WAVFormat::BW64_CHUNK_ID, 4) == 0)) {
+			readRIFF(true);
+		} else {
+			LOG_ERROR("\"" << fileName_ << "\" is not a WAV file.");
+		}
+	} else {
+		LOG_ERROR("\"" << fileName_ << "\" is not a WAV file.");
+	}
+	
+	if (chunks_.empty()) {
+		unmap();
+		return false;
+	}
+	
+	frames_ = 0;
+	for (unsigned i = 0; i < chunks_.size(); i++)
+		frames_ += chunks_[i].frames;
+	
+	streamInfo_.knownLength = true;
+	streamInfo_.length = frames_;
+	
+	// Unless set, the start of the recording is estimated from the time
+	// the file was last written to (the end of the recording).
+	if (hasStartTime_) {
+		streamInfo_.timeOffset = startTime_;
+	} else {
+		streamInfo_.timeOffset = WAVFormat::estimateStartTime(
+			modificationTime_, streamInfo_.length, streamInfo_.sampleRate);
+	}
+	
+	return true;
+}
+
+
+void MappedWAVFrontend::close()
+{
+	unmap();
+	chunks_.clear();
+}
+
+
+void MappedWAVFrontend::processSequentially()
+{
+	startStream();
+	
+	// Frames of the range and the overlap the backend needs to finish the
+	// last FFT frames of the range.
+	long begin = streamInfo_.startOffset;
+	long end   = begin + streamInfo_.length;
+	if (backend_.isNotNull()) end += backend_->getSegmentOverlap();
+	
+	// Only the first two channels are used, the rest is skipped using the
+	// stride of the span.
+	long chunkStart = 0;
+	for (unsigned c = 0; c < chunks_.size(); c++) {
+		const DataChunk &chunk = chunks_[c];
+		
+		long first = begin - chunkStart;
+		long last  = end - chunkStart;
+		if (first < 0) first = 0;
+		if (last > chunk.frames) last = chunk.frames;
+		
+		for (long i = first; i < last; i += blockSize_) {
+			int count = blockSize_;
+			if (count > last - i) count = last - i;
+			
+			process(getSamples(chunk, i, count));
+			
+			release(chunk.data + i * format_.blockAlign,
+				   chunk.data + (i + count) * format_.blockAlign);
+		}
+		
+		chunkStart += chunk.frames;
+	}
+	
+	endStream();
+}
+
+
+/**
+ * Tells the kernel that the processed part of the mapping is not needed
+ * anymore (only whole pages are released).
+ */
+void MappedWAVFrontend::release(const char *begin, const char *end)
+{
+	static const long pageSize = sysconf(_SC_PAGESIZE);
+	
+	uintptr_t first = ((uintptr_t)begin + pageSize - 1) & ~(uintptr_t)(pageSize - 1);
+	uintptr_t last  = (uintptr_t)end & ~(uintptr_t)(pageSize - 1);
+	
+	if (last > first)
+		madvise((void*)first, last - first, MADV_DONTNEED);
+}
+
+
+/**
+ * Constructor.
+ */
+MappedWAVFrontend::MappedWAVFrontend(const string &fileName, int blockSize) :
+	data_(NULL),
+	size_(0),
+	modificationTime_(0),
+	formatRead_(false),
+	fileName_(fileName),
+	blockSize_((blockSize < 1) ? 1 : blockSize),
+	sampleFormat_(SAMPLE_COMPLEX_INT16),
+	frames_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+MappedWAVFrontend::~MappedWAVFrontend()
+{
+	unmap();
+}
+
+
+void MappedWAVFrontend::run()
+{
+	if (!open()) return;
+	
+	applyRange(backend_);
+	processSequentially();
+	
+	close();
+}
+
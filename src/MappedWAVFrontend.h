@@ -0,0 +1,119 @@
+/**
+ * \file   MappedWAVFrontend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the MappedWAVFrontend class.
+ */
+
+#ifndef MAPPEDWAVFRONTEND_T6JD1YPC
+#define MAPPEDWAVFRONTEND_T6JD1YPC
+
+#include <stdint.h>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "Frontend.h"
+#include "WAVFormat.h"
+
+
+/**
+ * \brief Frontend reading a WAV file through a memory mapping.
+ *
+ * RIFF, RF64/BW64 and Sony Wave64 files with 16, 24 or 32-bit integer or
+ * 32 or 64-bit float samples are supported. The first two channels are
+ * used as the real and imaginary parts of the signal.
+ *
+ * The whole file is mapped into memory and the samples are passed to the
+ * backend directly from the mapping in blocks of configurable size, without
+ * copying them. The kernel is advised that the file is read sequentially,
+ * and the pages that have already been processed are released, so even
+ * files larger than the memory can be processed.
+ */
+class MappedWAVFrontend : public Frontend {
+private:
+	const char    *data_;
+	size_t         size_;
+	/// Modification time of the file.
+	time_t         modificationTime_;
+	
+	bool           formatRead_;
+	
+	MappedWAVFrontend(const MappedWAVFrontend& other);
+	
+	bool map();
+	void unmap();
+	
+	void readRIFF(bool rf64);
+	void readW64();
+	
+	void readFormatChunk(const char *chunk, uint64_t size);
+	void readDataChunk(const char *chunk, uint64_t size);
+
+protected:
+	/**
+	 * \brief Samples of a data chunk of the file.
+	 */
+	struct DataChunk {
+		const char *data;
+		long        frames;
+		
+		DataChunk(const char *data, long frames) : data(data), frames(frames) {}
+	};
+	
+	string            fileName_;
+	/// Number of frames passed to the backend at a time.
+	int               blockSize_;
+	
+	WAVFormat         format_;
+	SampleFormat      sampleFormat_;
+	vector<DataChunk> chunks_;
+	/// Total number of frames of the data chunks.
+	long              frames_;
+	
+	/**
+	 * \brief Maps the file and reads its format and data chunks.
+	 *
+	 * Sets up the stream info (sample rate, length and time offset), the
+	 * range set by setRange() is applied by applyRange().
+	 */
+	bool open();
+	void close();
+	
+	/**
+	 * \brief Returns \c count samples of \c chunk starting at \c offset.
+	 */
+	SampleSpan getSamples(const DataChunk &chunk, long offset, int count) const
+	{
+		return SampleSpan(sampleFormat_,
+					   chunk.data + offset * format_.blockAlign,
+					   count,
+					   format_.blockAlign);
+	}
+	
+	/**
+	 * \brief Passes the frames of the stream range (see
+	 *        StreamInfo::startOffset) to the backend of the frontend.
+	 */
+	void processSequentially();
+	void release(const char *begin, const char *end);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param fileName  name of the WAV file
+	 * \param blockSize number of frames passed to the backend at a time
+	 */
+	MappedWAVFrontend(const string &fileName, int blockSize = 65536);
+	virtual ~MappedWAVFrontend();
+	
+	virtual void run();
+};
+
+
+#endif /* end of include guard: MAPPEDWAVFRONTEND_T6JD1YPC */
+
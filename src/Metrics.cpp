@@ -0,0 +1,406 @@
+/**
+ * \file   Metrics.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the Metrics and MetricsReporter classes.
+ */
+
+#include "Metrics.h"
+#include "Atomic.h"
+#include "ThreadRegistry.h"
+
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// HISTOGRAM
+////////////////////////////////////////////////////////////////////////////////
+
+
+void Histogram::clear()
+{
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	sum = 0;
+	max = 0;
+}
+
+
+void Histogram::add(const Histogram &other)
+{
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+		buckets[i] += other.buckets[i];
+	count += other.count;
+	sum += other.sum;
+	if (other.max > max) max = other.max;
+}
+
+
+uint64_t Histogram::getPercentile(double fraction) const
+{
+	if (count == 0) return 0;
+
+	uint64_t target = (uint64_t)ceil(fraction * count);
+	if (target < 1) target = 1;
+
+	uint64_t seen = 0;
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		seen += buckets[i];
+		if (seen >= target) {
+			// The end of the bucket, but no more than the largest value.
+			uint64_t end = (i + 1 < HISTOGRAM_BUCKETS) ? getBucketStart(i + 1) - 1 : max;
+			return (end < max) ? end : max;
+		}
+	}
+
+	return max;
+}
+
+
+int Histogram::getBucket(uint64_t value)
+{
+	const int subBuckets = 1 << HISTOGRAM_SUB_BITS;
+
+	if (value < (uint64_t)subBuckets) return (int)value;
+
+	int exponent = 63 - __builtin_clzll(value);
+	if (exponent >= HISTOGRAM_MAX_BITS) return HISTOGRAM_BUCKETS - 1;
+
+	return ((exponent - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS) +
+		(int)((value >> (exponent - HISTOGRAM_SUB_BITS)) & (subBuckets - 1));
+}
+
+
+uint64_t Histogram::getBucketStart(int bucket)
+{
+	const int subBuckets = 1 << HISTOGRAM_SUB_BITS;
+
+	if (bucket < subBuckets) return bucket;
+
+	int exponent = (bucket >> HISTOGRAM_SUB_BITS) + HISTOGRAM_SUB_BITS - 1;
+	uint64_t sub = bucket & (subBuckets - 1);
+	return (subBuckets + sub) << (exponent - HISTOGRAM_SUB_BITS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// METRICS
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * \brief Metrics of a single thread.
+ *
+ * Only the owning thread writes to a shard, with relaxed atomic stores, so
+ * the snapshots can read it at any time.
+ */
+struct Metrics::Shard {
+	uint64_t  counters[METRIC_COUNTER_COUNT];
+	Histogram latencies[METRIC_LATENCY_COUNT];
+	Shard    *next;
+	Shard    *nextFree;
+
+	Shard() : next(NULL), nextFree(NULL)
+	{
+		memset(counters, 0, sizeof(counters));
+	}
+
+	/// The metrics of a finished thread are kept.
+	void release() {}
+};
+
+
+/// The gauges are shared by all threads.
+static int64_t gauges[METRIC_GAUGE_COUNT];
+
+
+Metrics::Shard* Metrics::getShard()
+{
+	return ThreadRegistry<Shard>::get();
+}
+
+
+uint64_t Metrics::now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000ULL + time.tv_nsec;
+}
+
+
+void Metrics::count(MetricCounter counter, uint64_t count)
+{
+	addRelaxed(&(getShard()->counters[counter]), count);
+}
+
+
+void Metrics::record(MetricLatency latency, uint64_t nanoseconds)
+{
+	Histogram &histogram = getShard()->latencies[latency];
+
+	addRelaxed(&(histogram.buckets[Histogram::getBucket(nanoseconds)]), 1);
+	addRelaxed(&(histogram.count), 1);
+	addRelaxed(&(histogram.sum), nanoseconds);
+	maxRelaxed(&(histogram.max), nanoseconds);
+}
+
+
+void Metrics::set(MetricGauge gauge, int64_t value)
+{
+	__atomic_store_n(&(gauges[gauge]), value, __ATOMIC_RELAXED);
+}
+
+
+void Metrics::getSnapshot(MetricsSnapshot *result)
+{
+	result->time = now() * 1e-9;
+	memset(result->counters, 0, sizeof(result->counters));
+	for (int i = 0; i < METRIC_LATENCY_COUNT; i++)
+		result->latencies[i].clear();
+	for (int i = 0; i < METRIC_GAUGE_COUNT; i++)
+		result->gauges[i] = __atomic_load_n(&(gauges[i]), __ATOMIC_RELAXED);
+	PerfCounters::getTotals(&(result->perf));
+
+	for (Shard *shard = ThreadRegistry<Shard>::getAll(); shard != NULL;
+		shard = shard->next) {
+		for (int i = 0; i < METRIC_COUNTER_COUNT; i++)
+			result->counters[i] += loadRelaxed(&(shard->counters[i]));
+
+		for (int i = 0; i < METRIC_LATENCY_COUNT; i++) {
+			const Histogram &source = shard->latencies[i];
+			Histogram &target = result->latencies[i];
+
+			for (int j = 0; j < HISTOGRAM_BUCKETS; j++)
+				target.buckets[j] += loadRelaxed(&(source.buckets[j]));
+			target.count += loadRelaxed(&(source.count));
+			target.sum += loadRelaxed(&(source.sum));
+			uint64_t max = loadRelaxed(&(source.max));
+			if (max > target.max) target.max = max;
+		}
+	}
+}
+
+
+void Metrics::write(ostream &output, const MetricsSnapshot &current,
+				const MetricsSnapshot *previous)
+{
+	double interval = previous ? current.time - previous->time : 0;
+
+	output << fixed << setprecision(1);
+
+	for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+		output << "counter " << getName((MetricCounter)i) << " " << current.counters[i];
+		if (interval > 0) {
+			output << " " << ((current.counters[i] - previous->counters[i]) / interval) <<
+				"/s";
+		}
+		output << endl;
+	}
+
+	output << "gauge sink_backlog " << current.getSinkBacklog() << endl;
+	for (int i = 0; i < METRIC_GAUGE_COUNT; i++)
+		output << "gauge " << getName((MetricGauge)i) << " " << current.gauges[i] << "us" << endl;
+
+	for (int i = 0; i < METRIC_LATENCY_COUNT; i++) {
+		const Histogram &histogram = current.latencies[i];
+		output << "latency " << getName((MetricLatency)i) <<
+			" count=" << histogram.count <<
+			" mean=" << histogram.getMean() / 1000.0 << "us" <<
+			" p50=" << histogram.getPercentile(0.5) / 1000.0 << "us" <<
+			" p90=" << histogram.getPercentile(0.9) / 1000.0 << "us" <<
+			" p99=" << histogram.getPercentile(0.99) / 1000.0 << "us" <<
+			" p999=" << histogram.getPercentile(0.999) / 1000.0 << "us" <<
+			" max=" << histogram.max / 1000.0 << "us" << endl;
+	}
+
+	if (PerfCounters::isEnabled())
+		PerfCounters::write(output, current.perf, previous ? &(previous->perf) : NULL);
+}
+
+
+const char* Metrics::getName(MetricCounter counter)
+{
+	switch (counter) {
+	case METRIC_SAMPLES_IN:    return "samples_in";
+	case METRIC_ROWS_QUEUED:   return "rows_queued";
+	case METRIC_ROWS_OUT:      return "rows_out";
+	case METRIC_ROWS_DROPPED:  return "rows_dropped";
+	case METRIC_SNAPSHOTS:     return "snapshots";
+	default:                   return "unknown";
+	}
+}
+
+
+const char* Metrics::getName(MetricLatency latency)
+{
+	switch (latency) {
+	case LATENCY_FRONTEND_BLOCK: return "frontend_block";
+	case LATENCY_WINDOW:         return "window";
+	case LATENCY_FFT:            return "fft";
+	case LATENCY_MAGNITUDE:      return "magnitude";
+	case LATENCY_SINK_PUSH:      return "sink_push";
+	case LATENCY_FITS_WRITE:     return "fits_write";
+	default:                     return "unknown";
+	}
+}
+
+
+const char* Metrics::getName(MetricGauge gauge)
+{
+	switch (gauge) {
+	case GAUGE_CLOCK_DRIFT:      return "clock_drift";
+	default:                     return "unknown";
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// METRICS REPORTER
+////////////////////////////////////////////////////////////////////////////////
+
+
+MetricsReporter *MetricsReporter::instance_ = NULL;
+
+
+void MetricsReporter::handleSignal(int signal)
+{
+	// Only async-signal-safe calls here.
+	if (instance_ != NULL) {
+		instance_->signalled_ = 1;
+		sem_post(&(instance_->semaphore_));
+	}
+}
+
+
+void* MetricsReporter::threadMethod()
+{
+	WFTime nextWrite = WFTime::now().addMicroseconds((time_t)(interval_ * US_IN_SECOND));
+
+	while (__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) {
+		struct timespec wakeUp;
+		wakeUp.tv_sec = nextWrite.seconds();
+		wakeUp.tv_nsec = nextWrite.microseconds() * 1000;
+
+		int result = sem_timedwait(&semaphore_, &wakeUp);
+		if ((result != 0) && (errno == EINTR)) continue;
+
+		MetricsSnapshot *current = new MetricsSnapshot();
+		Metrics::getSnapshot(current);
+
+		WFTime now = WFTime::now();
+
+		if (signalled_) {
+			signalled_ = 0;
+
+			stringstream text;
+			Metrics::write(text, *current, &previous_);
+			LOG_INFO("Metrics:" << endl << text.str());
+
+			writeFile(*current);
+			nextWrite = now.addMicroseconds((time_t)(interval_ * US_IN_SECOND));
+		} else if ((now.seconds() > nextWrite.seconds()) ||
+		    ((now.seconds() == nextWrite.seconds()) &&
+		     (now.microseconds() >= nextWrite.microseconds()))) {
+			writeFile(*current);
+			nextWrite = now.addMicroseconds((time_t)(interval_ * US_IN_SECOND));
+		}
+
+		delete current;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Writes the metrics to a temporary file and renames it over the stats
+ * file, so readers never see it half-written.
+ */
+void MetricsReporter::writeFile(const MetricsSnapshot &current)
+{
+	if (!fileName_.empty()) {
+		string temporary = fileName_ + ".tmp";
+
+		{
+			ofstream output(temporary.c_str());
+			output << "# " << WFTime::now().format("%Y-%m-%d %H:%M:%S UTC") << endl;
+			Metrics::write(output, current, &previous_);
+			if (!output) {
+				LOG_ERROR("Failed to write metrics to \"" << temporary << "\".");
+			}
+		}
+
+		if (rename(temporary.c_str(), fileName_.c_str()) != 0) {
+			LOG_ERROR("Failed to replace \"" << fileName_ << "\": " << strerror(errno));
+		}
+	}
+
+	previous_ = current;
+}
+
+
+/**
+ * Constructor.
+ */
+MetricsReporter::MetricsReporter(const string &fileName, float interval) :
+	fileName_(fileName),
+	interval_((interval > 0) ? interval : 10),
+	thread_(NULL),
+	running_(false),
+	signalled_(0)
+{
+	sem_init(&semaphore_, 0, 0);
+	Metrics::getSnapshot(&previous_);
+}
+
+
+/**
+ * Destructor.
+ */
+MetricsReporter::~MetricsReporter()
+{
+	stop();
+	sem_destroy(&semaphore_);
+}
+
+
+void MetricsReporter::start()
+{
+	if (thread_ != NULL) return;
+
+	instance_ = this;
+	signal(SIGUSR1, handleSignal);
+
+	__atomic_store_n(&running_, true, __ATOMIC_RELEASE);
+	thread_ = new Thread(this, &MetricsReporter::threadMethod);
+}
+
+
+void MetricsReporter::stop()
+{
+	if (thread_ == NULL) return;
+
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+	sem_post(&semaphore_);
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+
+	signal(SIGUSR1, SIG_DFL);
+	instance_ = NULL;
+
+	MetricsSnapshot *current = new MetricsSnapshot();
+	Metrics::getSnapshot(current);
+	writeFile(*current);
+	delete current;
+}
+
@@ -0,0 +1,257 @@
+/**
+ * \file   Metrics.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the Metrics and MetricsReporter classes.
+ */
+
+#ifndef METRICS_J7VT2LWC
+#define METRICS_J7VT2LWC
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include <semaphore.h>
+
+#include "PerfCounters.h"
+#include "WFTime.h"
+
+
+/**
+ * \brief Counters of the processed data.
+ */
+enum MetricCounter {
+	/// Samples passed to the backends by the frontends.
+	METRIC_SAMPLES_IN,
+	/// Spectrum rows put into the queues of the sinks.
+	METRIC_ROWS_QUEUED,
+	/// Spectrum rows processed by the sinks.
+	METRIC_ROWS_OUT,
+	/// Spectrum rows dropped because a sink queue was full.
+	METRIC_ROWS_DROPPED,
+	/// Snapshot files written.
+	METRIC_SNAPSHOTS,
+
+	METRIC_COUNTER_COUNT
+};
+
+
+/**
+ * \brief Measured stages of the processing.
+ */
+enum MetricLatency {
+	/// Processing of a block of samples by the backend.
+	LATENCY_FRONTEND_BLOCK,
+	/// Conversion and windowing of an FFT frame.
+	LATENCY_WINDOW,
+	/// The FFT of a frame.
+	LATENCY_FFT,
+	/// Magnitudes of a spectrum.
+	LATENCY_MAGNITUDE,
+	/// Handing a row to the sinks (waits for space in offline streams).
+	LATENCY_SINK_PUSH,
+	/// Writing a snapshot file.
+	LATENCY_FITS_WRITE,
+
+	METRIC_LATENCY_COUNT
+};
+
+
+/**
+ * \brief Current values of the processing (the last value set counts).
+ */
+enum MetricGauge {
+	/// Wall clock minus the stream time of the last live block in
+	/// microseconds (see Frontend::process()).
+	GAUGE_CLOCK_DRIFT,
+
+	METRIC_GAUGE_COUNT
+};
+
+
+/// Number of sub-buckets of each power of two is 2^HISTOGRAM_SUB_BITS.
+#define HISTOGRAM_SUB_BITS 3
+/// Values up to 2^HISTOGRAM_MAX_BITS - 1 ns (about 4.9 hours) are told apart.
+#define HISTOGRAM_MAX_BITS 44
+#define HISTOGRAM_BUCKETS \
+	((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+
+/**
+ * \brief HDR-style histogram of durations in nanoseconds.
+ *
+ * The buckets are linear within each power of two (with 8 sub-buckets), so
+ * the relative error of the percentiles is at most 12.5 % at any scale.
+ */
+struct Histogram {
+	uint64_t buckets[HISTOGRAM_BUCKETS];
+	uint64_t count;
+	uint64_t sum;
+	uint64_t max;
+
+	Histogram() { clear(); }
+
+	void clear();
+	void add(const Histogram &other);
+
+	/// Returns the value below which \c fraction of the values lie.
+	uint64_t getPercentile(double fraction) const;
+	double   getMean() const { return count ? (double)sum / count : 0; }
+
+	static int      getBucket(uint64_t value);
+	/// Returns the smallest value of a bucket.
+	static uint64_t getBucketStart(int bucket);
+};
+
+
+/**
+ * \brief Sum of the metrics of all threads at a moment.
+ */
+struct MetricsSnapshot {
+	/// Monotonic time of the snapshot in seconds.
+	double     time;
+	uint64_t   counters[METRIC_COUNTER_COUNT];
+	Histogram  latencies[METRIC_LATENCY_COUNT];
+	int64_t    gauges[METRIC_GAUGE_COUNT];
+	/// Hardware counters of the stages (if enabled).
+	PerfTotals perf;
+
+	/// Rows waiting in the sink queues.
+	int64_t getSinkBacklog() const
+	{
+		return (int64_t)counters[METRIC_ROWS_QUEUED] -
+			(int64_t)counters[METRIC_ROWS_OUT];
+	}
+};
+
+
+/**
+ * \brief Process-wide counters and latency histograms of the processing
+ *        stages.
+ *
+ * Each thread updates its own copy of the metrics (a shard) without locks
+ * or atomic read-modify-write operations; the shards are only summed when
+ * a snapshot is taken. The shards of finished threads are reused by new
+ * threads, so nothing is lost and the memory stays bounded.
+ */
+class Metrics {
+public:
+	/// Metrics of a single thread (see Metrics.cpp).
+	struct Shard;
+
+private:
+	static Shard* getShard();
+
+public:
+	/// Returns the monotonic time in nanoseconds.
+	static uint64_t now();
+
+	static void count(MetricCounter counter, uint64_t count = 1);
+	static void record(MetricLatency latency, uint64_t nanoseconds);
+	static void set(MetricGauge gauge, int64_t value);
+
+	/// Sums the metrics of all threads.
+	static void getSnapshot(MetricsSnapshot *result);
+
+	/**
+	 * \brief Writes the metrics, with the rates since \c previous (if not
+	 *        \c NULL).
+	 */
+	static void write(ostream &output, const MetricsSnapshot &current,
+				   const MetricsSnapshot *previous);
+
+	static const char* getName(MetricCounter counter);
+	static const char* getName(MetricLatency latency);
+	static const char* getName(MetricGauge gauge);
+};
+
+
+/**
+ * \brief Records the time from its construction to its destruction (or
+ *        stop()).
+ */
+class LatencyTimer {
+private:
+	MetricLatency latency_;
+	uint64_t      start_;
+	bool          running_;
+
+public:
+	LatencyTimer(MetricLatency latency) :
+		latency_(latency), start_(Metrics::now()), running_(true)
+	{}
+
+	~LatencyTimer() { stop(); }
+
+	void stop()
+	{
+		if (!running_) return;
+		Metrics::record(latency_, Metrics::now() - start_);
+		running_ = false;
+	}
+};
+
+
+/**
+ * \brief Thread writing the metrics to a file periodically, and to the log
+ *        on SIGUSR1.
+ *
+ * The file is replaced atomically, so it can be read at any time (for
+ * example by a monitoring script that checks whether a station keeps up
+ * with real time).
+ */
+class MetricsReporter : public Object {
+private:
+	typedef MethodThread<void, MetricsReporter> Thread;
+
+	/// The reporter woken by SIGUSR1.
+	static MetricsReporter *instance_;
+
+	string          fileName_;
+	float           interval_;
+
+	Thread         *thread_;
+	sem_t           semaphore_;
+	bool            running_;
+	/// Set by the signal handler.
+	volatile int    signalled_;
+
+	MetricsSnapshot previous_;
+
+	MetricsReporter(const MetricsReporter& other);
+
+	void* threadMethod();
+	void  writeFile(const MetricsSnapshot &current);
+
+	static void handleSignal(int signal);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param fileName file the metrics are written to (empty for none)
+	 * \param interval seconds between the writes
+	 */
+	MetricsReporter(const string &fileName, float interval);
+	virtual ~MetricsReporter();
+
+	/**
+	 * \brief Starts the thread and installs the SIGUSR1 handler.
+	 */
+	void start();
+	/**
+	 * \brief Writes the final metrics and stops the thread.
+	 */
+	void stop();
+};
+
+#endif /* end of include guard: METRICS_J7VT2LWC */
+
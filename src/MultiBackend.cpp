@@ -0,0 +1,218 @@
+/**
+ * \file   MultiBackend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the MultiBackend class.
+ */
+
+#include "MultiBackend.h"
+#include "SampleConversion.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// WORKER
+////////////////////////////////////////////////////////////////////////////////
+
+
+void* MultiBackend::Worker::threadMethod()
+{
+	while (true) {
+		Block *block;
+
+		// Wait for the next block. Exit only after all of the blocks
+		// written before the end of the stream have been processed.
+		{
+			MutexLock lock(&owner_->mutex_);
+
+			while ((next_ >= owner_->written_) && !owner_->ending_)
+				condition.wait(owner_->mutex_);
+
+			if (next_ >= owner_->written_) break;
+
+			block = &(owner_->blocks_[next_ % owner_->blocks_.size()]);
+		}
+
+		// The block cannot be overwritten until this worker releases it,
+		// so it can be processed without holding the lock.
+		backend_->process(block->samples, block->info);
+
+		// Release the block.
+		{
+			MutexLock lock(&owner_->mutex_);
+
+			next_++;
+			block->readers--;
+			if (block->readers == 0)
+				owner_->freeCondition_.signal();
+		}
+	}
+
+	return NULL;
+}
+
+
+MultiBackend::Worker::Worker(MultiBackend *owner, Ref<Backend> backend) :
+	owner_(owner), backend_(backend), thread_(NULL), next_(0)
+{
+}
+
+
+MultiBackend::Worker::~Worker()
+{
+	join();
+}
+
+
+void MultiBackend::Worker::start()
+{
+	next_ = 0;
+	thread_ = new Thread(this, &Worker::threadMethod);
+}
+
+
+void MultiBackend::Worker::join()
+{
+	if (thread_ == NULL) return;
+
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MULTI BACKEND
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * Constructor.
+ *
+ * \param blockCount number of blocks in the shared sample history
+ */
+MultiBackend::MultiBackend(int blockCount) :
+	Backend(),
+	blocks_((blockCount < 1) ? 1 : blockCount),
+	written_(0),
+	ending_(false)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+MultiBackend::~MultiBackend()
+{
+}
+
+
+void MultiBackend::addBackend(Ref<Backend> backend)
+{
+	workers_.push_back(new Worker(this, backend));
+}
+
+
+void MultiBackend::startStream(StreamInfo info)
+{
+	Backend::startStream(info);
+
+	LOG_DEBUG("Starting multi backend stream with " << workers_.size() <<
+			" backends and " << blocks_.size() << " blocks of history.");
+
+	written_ = 0;
+	ending_ = false;
+	for (unsigned i = 0; i < blocks_.size(); i++)
+		blocks_[i].readers = 0;
+
+	for (unsigned i = 0; i < workers_.size(); i++) {
+		workers_[i]->getBackend()->startStream(info);
+		workers_[i]->start();
+	}
+}
+
+
+void MultiBackend::process(const SampleSpan &data, DataInfo info)
+{
+	if ((workers_.size() == 0) || (data.length < 1)) return;
+
+	Block *block;
+
+	// Wait until the oldest block is released by all of the workers.
+	{
+		MutexLock lock(&mutex_);
+
+		block = &(blocks_[written_ % blocks_.size()]);
+		while (block->readers > 0)
+			freeCondition_.wait(mutex_);
+	}
+
+	// No worker reads a free block, so it can be filled without the lock.
+	// The block keeps its capacity, so the copy allocates only until the
+	// blocks grow to the size of the largest input block.
+	SampleFormat format = getStorageFormat(data.format);
+	block->data.resize((long)data.length * getSampleSize(format));
+	copySamples(data, 0, &(block->data[0]), data.length);
+	block->samples = SampleSpan(format, &(block->data[0]), data.length);
+	block->info = info;
+
+	// Publish the block.
+	{
+		MutexLock lock(&mutex_);
+
+		block->readers = workers_.size();
+		written_++;
+
+		for (unsigned i = 0; i < workers_.size(); i++)
+			workers_[i]->condition.signal();
+	}
+}
+
+
+void MultiBackend::endStream()
+{
+	{
+		MutexLock lock(&mutex_);
+
+		ending_ = true;
+		for (unsigned i = 0; i < workers_.size(); i++)
+			workers_[i]->condition.signal();
+	}
+
+	for (unsigned i = 0; i < workers_.size(); i++) {
+		workers_[i]->join();
+		workers_[i]->getBackend()->endStream();
+	}
+
+	Backend::endStream();
+	LOG_DEBUG("Ending multi backend stream.");
+}
+
+
+/**
+ * Segments have to be aligned for all of the children.
+ */
+long MultiBackend::getSegmentAlignment(const StreamInfo &info)
+{
+	long alignment = 1;
+	for (unsigned i = 0; i < workers_.size(); i++) {
+		alignment = combineAlignments(
+			alignment,
+			workers_[i]->getBackend()->getSegmentAlignment(info)
+		);
+	}
+	return alignment;
+}
+
+
+int MultiBackend::getSegmentOverlap()
+{
+	int overlap = 0;
+	for (unsigned i = 0; i < workers_.size(); i++) {
+		int childOverlap = workers_[i]->getBackend()->getSegmentOverlap();
+		if (childOverlap > overlap) overlap = childOverlap;
+	}
+	return overlap;
+}
+
@@ -0,0 +1,114 @@
+/**
+ * \file   MultiBackend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the MultiBackend class.
+ */
+
+#ifndef MULTIBACKEND_R8KQ2M4V
+#define MULTIBACKEND_R8KQ2M4V
+
+#include <vector>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "Backend.h"
+
+
+/**
+ * \brief Backend that feeds one sample stream to several backends at once.
+ *
+ * Every block passed to process() is stored once in a shared pool of
+ * blocks (the sample history). Each child backend is driven by its own
+ * worker thread which reads the blocks from the pool in order, so the
+ * children (for example FFT backends with different resolutions) run in
+ * parallel without keeping their own copies of the input.
+ *
+ * A block is released back to the pool only after all of the workers
+ * have processed it. If the pool is exhausted, process() waits for the
+ * slowest worker.
+ */
+class MultiBackend : public Backend {
+private:
+	/**
+	 * \brief Slot of the shared sample history.
+	 */
+	struct Block {
+		vector<char> data;
+		SampleSpan   samples;
+		DataInfo     info;
+		/// Number of workers that have not processed the block yet.
+		int          readers;
+
+		Block() : readers(0) {}
+	};
+
+	/**
+	 * \brief Worker thread driving a single child backend.
+	 */
+	class Worker : public Object {
+	private:
+		typedef MethodThread<void, Worker> Thread;
+
+		MultiBackend *owner_;
+		Ref<Backend>  backend_;
+		Thread       *thread_;
+
+		/// Sequence number of the next block to be processed.
+		long          next_;
+
+		Worker(const Worker& other);
+
+		void* threadMethod();
+
+	public:
+		Condition     condition;
+
+		Worker(MultiBackend *owner, Ref<Backend> backend);
+		virtual ~Worker();
+
+		Ref<Backend> getBackend() { return backend_; }
+
+		void start();
+		void join();
+	};
+
+	vector<Ref<Worker> > workers_;
+	vector<Block>        blocks_;
+
+	Mutex                mutex_;
+	Condition            freeCondition_;
+
+	/// Sequence number of the next block to be written.
+	long                 written_;
+	bool                 ending_;
+
+	MultiBackend(const MultiBackend& other);
+
+public:
+	MultiBackend(int blockCount = 256);
+	virtual ~MultiBackend();
+
+	/**
+	 * \brief Adds a child backend.
+	 *
+	 * Children must be added before the stream is started.
+	 */
+	void addBackend(Ref<Backend> backend);
+	int  getBackendCount() const { return workers_.size(); }
+
+	virtual void startStream(StreamInfo info);
+	virtual void process(const SampleSpan &data, DataInfo info);
+	virtual void endStream();
+	
+	virtual long getSegmentAlignment(const StreamInfo &info);
+	virtual int  getSegmentOverlap();
+};
+
+#endif /* end of include guard: MULTIBACKEND_R8KQ2M4V */
+
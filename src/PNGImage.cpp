@@ -0,0 +1,337 @@
+/**
+ * \file   PNGImage.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the PNGImage class.
+ */
+
+#include "PNGImage.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <zlib.h>
+
+
+/**
+ * The classic 5x7 font, ASCII 32 to 126. Each character is 5 columns, the
+ * lowest bit of a column is its top pixel.
+ */
+static const uint8_t font5x7[95][5] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+	{ 0x00, 0x00, 0x5F, 0x00, 0x00 }, // '!'
+	{ 0x00, 0x07, 0x00, 0x07, 0x00 }, // '"'
+	{ 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // '#'
+	{ 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, // '$'
+	{ 0x23, 0x13, 0x08, 0x64, 0x62 }, // '%'
+	{ 0x36, 0x49, 0x55, 0x22, 0x50 }, // '&'
+	{ 0x00, 0x05, 0x03, 0x00, 0x00 }, // '''
+	{ 0x00, 0x1C, 0x22, 0x41, 0x00 }, // '('
+	{ 0x00, 0x41, 0x22, 0x1C, 0x00 }, // ')'
+	{ 0x08, 0x2A, 0x1C, 0x2A, 0x08 }, // '*'
+	{ 0x08, 0x08, 0x3E, 0x08, 0x08 }, // '+'
+	{ 0x00, 0x50, 0x30, 0x00, 0x00 }, // ','
+	{ 0x08, 0x08, 0x08, 0x08, 0x08 }, // '-'
+	{ 0x00, 0x60, 0x60, 0x00, 0x00 }, // '.'
+	{ 0x20, 0x10, 0x08, 0x04, 0x02 }, // '/'
+	{ 0x3E, 0x51, 0x49, 0x45, 0x3E }, // '0'
+	{ 0x00, 0x42, 0x7F, 0x40, 0x00 }, // '1'
+	{ 0x42, 0x61, 0x51, 0x49, 0x46 }, // '2'
+	{ 0x21, 0x41, 0x45, 0x4B, 0x31 }, // '3'
+	{ 0x18, 0x14, 0x12, 0x7F, 0x10 }, // '4'
+	{ 0x27, 0x45, 0x45, 0x45, 0x39 }, // '5'
+	{ 0x3C, 0x4A, 0x49, 0x49, 0x30 }, // '6'
+	{ 0x01, 0x71, 0x09, 0x05, 0x03 }, // '7'
+	{ 0x36, 0x49, 0x49, 0x49, 0x36 }, // '8'
+	{ 0x06, 0x49, 0x49, 0x29, 0x1E }, // '9'
+	{ 0x00, 0x36, 0x36, 0x00, 0x00 }, // ':'
+	{ 0x00, 0x56, 0x36, 0x00, 0x00 }, // ';'
+	{ 0x08, 0x14, 0x22, 0x41, 0x00 }, // '<'
+	{ 0x14, 0x14, 0x14, 0x14, 0x14 }, // '='
+	{ 0x00, 0x41, 0x22, 0x14, 0x08 }, // '>'
+	{ 0x02, 0x01, 0x51, 0x09, 0x06 }, // '?'
+	{ 0x32, 0x49, 0x79, 0x41, 0x3E }, // '@'
+	{ 0x7E, 0x11, 0x11, 0x11, 0x7E }, // 'A'
+	{ 0x7F, 0x49, 0x49, 0x49, 0x36 }, // 'B'
+	{ 0x3E, 0x41, 0x41, 0x41, 0x22 }, // 'C'
+	{ 0x7F, 0x41, 0x41, 0x22, 0x1C }, // 'D'
+	{ 0x7F, 0x49, 0x49, 0x49, 0x41 }, // 'E'
+	{ 0x7F, 0x09, 0x09, 0x09, 0x01 }, // 'F'
+	{ 0x3E, 0x41, 0x49, 0x49, 0x7A }, // 'G'
+	{ 0x7F, 0x08, 0x08, 0x08, 0x7F }, // 'H'
+	{ 0x00, 0x41, 0x7F, 0x41, 0x00 }, // 'I'
+	{ 0x20, 0x40, 0x41, 0x3F, 0x01 }, // 'J'
+	{ 0x7F, 0x08, 0x14, 0x22, 0x41 }, // 'K'
+	{ 0x7F, 0x40, 0x40, 0x40, 0x40 }, // 'L'
+	{ 0x7F, 0x02, 0x0C, 0x02, 0x7F }, // 'M'
+	{ 0x7F, 0x04, 0x08, 0x10, 0x7F }, // 'N'
+	{ 0x3E, 0x41, 0x41, 0x41, 0x3E }, // 'O'
+	{ 0x7F, 0x09, 0x09, 0x09, 0x06 }, // 'P'
+	{ 0x3E, 0x41, 0x51, 0x21, 0x5E }, // 'Q'
+	{ 0x7F, 0x09, 0x19, 0x29, 0x46 }, // 'R'
+	{ 0x46, 0x49, 0x49, 0x49, 0x31 }, // 'S'
+	{ 0x01, 0x01, 0x7F, 0x01, 0x01 }, // 'T'
+	{ 0x3F, 0x40, 0x40, 0x40, 0x3F }, // 'U'
+	{ 0x1F, 0x20, 0x40, 0x20, 0x1F }, // 'V'
+	{ 0x3F, 0x40, 0x38, 0x40, 0x3F }, // 'W'
+	{ 0x63, 0x14, 0x08, 0x14, 0x63 }, // 'X'
+	{ 0x07, 0x08, 0x70, 0x08, 0x07 }, // 'Y'
+	{ 0x61, 0x51, 0x49, 0x45, 0x43 }, // 'Z'
+	{ 0x00, 0x7F, 0x41, 0x41, 0x00 }, // '['
+	{ 0x02, 0x04, 0x08, 0x10, 0x20 }, // '\'
+	{ 0x00, 0x41, 0x41, 0x7F, 0x00 }, // ']'
+	{ 0x04, 0x02, 0x01, 0x02, 0x04 }, // '^'
+	{ 0x40, 0x40, 0x40, 0x40, 0x40 }, // '_'
+	{ 0x00, 0x01, 0x02, 0x04, 0x00 }, // '`'
+	{ 0x20, 0x54, 0x54, 0x54, 0x78 }, // 'a'
+	{ 0x7F, 0x48, 0x44, 0x44, 0x38 }, // 'b'
+	{ 0x38, 0x44, 0x44, 0x44, 0x20 }, // 'c'
+	{ 0x38, 0x44, 0x44, 0x48, 0x7F }, // 'd'
+	{ 0x38, 0x54, 0x54, 0x54, 0x18 }, // 'e'
+	{ 0x08, 0x7E, 0x09, 0x01, 0x02 }, // 'f'
+	{ 0x0C, 0x52, 0x52, 0x52, 0x3E }, // 'g'
+	{ 0x7F, 0x08, 0x04, 0x04, 0x78 }, // 'h'
+	{ 0x00, 0x44, 0x7D, 0x40, 0x00 }, // 'i'
+	{ 0x20, 0x40, 0x44, 0x3D, 0x00 }, // 'j'
+	{ 0x7F, 0x10, 0x28, 0x44, 0x00 }, // 'k'
+	{ 0x00, 0x41, 0x7F, 0x40, 0x00 }, // 'l'
+	{ 0x7C, 0x04, 0x18, 0x04, 0x78 }, // 'm'
+	{ 0x7C, 0x08, 0x04, 0x04, 0x78 }, // 'n'
+	{ 0x38, 0x44, 0x44, 0x44, 0x38 }, // 'o'
+	{ 0x7C, 0x14, 0x14, 0x14, 0x08 }, // 'p'
+	{ 0x08, 0x14, 0x14, 0x18, 0x7C }, // 'q'
+	{ 0x7C, 0x08, 0x04, 0x04, 0x08 }, // 'r'
+	{ 0x48, 0x54, 0x54, 0x54, 0x20 }, // 's'
+	{ 0x04, 0x3F, 0x44, 0x40, 0x20 }, // 't'
+	{ 0x3C, 0x40, 0x40, 0x20, 0x7C }, // 'u'
+	{ 0x1C, 0x20, 0x40, 0x20, 0x1C }, // 'v'
+	{ 0x3C, 0x40, 0x30, 0x40, 0x3C }, // 'w'
+	{ 0x44, 0x28, 0x10, 0x28, 0x44 }, // 'x'
+	{ 0x0C, 0x50, 0x50, 0x50, 0x3C }, // 'y'
+	{ 0x44, 0x64, 0x54, 0x4C, 0x44 }, // 'z'
+	{ 0x00, 0x08, 0x36, 0x41, 0x00 }, // '{'
+	{ 0x00, 0x00, 0x7F, 0x00, 0x00 }, // '|'
+	{ 0x00, 0x41, 0x36, 0x08, 0x00 }, // '}'
+	{ 0x08, 0x04, 0x08, 0x10, 0x08 }  // '~'
+};
+
+
+/**
+ * Constructor.
+ */
+PNGImage::PNGImage(int width, int height) :
+	width_(0), height_(0), palette_(3 * 256)
+{
+	for (int i = 0; i < 256; i++) {
+		palette_[3 * i]     = i;
+		palette_[3 * i + 1] = i;
+		palette_[3 * i + 2] = i;
+	}
+	resize(width, height);
+}
+
+
+void PNGImage::resize(int width, int height)
+{
+	width_  = (width > 0) ? width : 0;
+	height_ = (height > 0) ? height : 0;
+	pixels_.assign((long)width_ * height_, 0);
+}
+
+
+void PNGImage::setPixel(int x, int y, uint8_t colour)
+{
+	if ((x < 0) || (y < 0) || (x >= width_) || (y >= height_)) return;
+	pixels_[(long)y * width_ + x] = colour;
+}
+
+
+void PNGImage::setPalette(const uint8_t *palette)
+{
+	memcpy(&(palette_[0]), palette, 3 * 256);
+}
+
+
+void PNGImage::fill(uint8_t colour)
+{
+	if (!pixels_.empty()) memset(&(pixels_[0]), colour, pixels_.size());
+}
+
+
+void PNGImage::drawLine(int x0, int y0, int x1, int y1, uint8_t colour)
+{
+	if (y0 == y1) {
+		if (x0 > x1) { int x = x0; x0 = x1; x1 = x; }
+		for (int x = x0; x <= x1; x++) setPixel(x, y0, colour);
+	} else if (x0 == x1) {
+		if (y0 > y1) { int y = y0; y0 = y1; y1 = y; }
+		for (int y = y0; y <= y1; y++) setPixel(x0, y, colour);
+	}
+}
+
+
+void PNGImage::drawText(int x, int y, const string &text, uint8_t colour)
+{
+	for (unsigned i = 0; i < text.size(); i++) {
+		int c = (unsigned char)text[i];
+		if ((c < 32) || (c > 126)) c = '?';
+		const uint8_t *glyph = font5x7[c - 32];
+
+		// The glyph is vertically centred in the line.
+		for (int column = 0; column < 5; column++) {
+			for (int row = 0; row < 7; row++) {
+				if (glyph[column] & (1 << row))
+					setPixel(x + column, y + 2 + row, colour);
+			}
+		}
+
+		x += PNG_FONT_WIDTH;
+	}
+}
+
+
+void PNGImage::copyTo(PNGImage *target, int x, int y) const
+{
+	for (int row = 0; row < height_; row++) {
+		int ty = y + row;
+		if ((ty < 0) || (ty >= target->height_)) continue;
+
+		int first = (x < 0) ? -x : 0;
+		int last = width_;
+		if (x + last > target->width_) last = target->width_ - x;
+		if (last <= first) continue;
+
+		memcpy(target->getRow(ty) + x + first, getRow(row) + first, last - first);
+	}
+}
+
+
+void PNGImage::scaleDown(int width, int height)
+{
+	if ((width >= width_) && (height >= height_)) return;
+	if (width > width_) width = width_;
+	if (height > height_) height = height_;
+	if ((width < 1) || (height < 1)) {
+		resize(width, height);
+		return;
+	}
+
+	vector<uint8_t> result((long)width * height);
+	vector<uint32_t> sums(width_);
+
+	for (int ty = 0; ty < height; ty++) {
+		int firstRow = (int)((long)ty * height_ / height);
+		int lastRow = (int)((long)(ty + 1) * height_ / height);
+
+		// Sum the rows of the source which fall into the target row.
+		memset(&(sums[0]), 0, width_ * sizeof(uint32_t));
+		for (int y = firstRow; y < lastRow; y++) {
+			const uint8_t *row = getRow(y);
+			for (int x = 0; x < width_; x++) sums[x] += row[x];
+		}
+
+		uint8_t *target = &(result[0]) + (long)ty * width;
+		for (int tx = 0; tx < width; tx++) {
+			int firstColumn = (int)((long)tx * width_ / width);
+			int lastColumn = (int)((long)(tx + 1) * width_ / width);
+
+			uint32_t sum = 0;
+			for (int x = firstColumn; x < lastColumn; x++) sum += sums[x];
+
+			uint32_t count = (uint32_t)(lastRow - firstRow) * (lastColumn - firstColumn);
+			target[tx] = (uint8_t)((sum + count / 2) / count);
+		}
+	}
+
+	width_ = width;
+	height_ = height;
+	pixels_.swap(result);
+}
+
+
+static void putUInt32(vector<uint8_t> *output, uint32_t value)
+{
+	output->push_back((value >> 24) & 0xff);
+	output->push_back((value >> 16) & 0xff);
+	output->push_back((value >> 8) & 0xff);
+	output->push_back(value & 0xff);
+}
+
+
+static void putChunk(vector<uint8_t> *output, const char *type,
+				 const uint8_t *data, unsigned long length)
+{
+	putUInt32(output, length);
+
+	size_t start = output->size();
+	output->insert(output->end(), type, type + 4);
+	if (length > 0) output->insert(output->end(), data, data + length);
+
+	uint32_t crc = crc32(0, &((*output)[start]), 4 + length);
+	putUInt32(output, crc);
+}
+
+
+void PNGImage::encode(vector<uint8_t> *result, int level) const
+{
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+	bool grey = true;
+	for (int i = 0; (i < 256) && grey; i++) {
+		grey = (palette_[3 * i] == i) && (palette_[3 * i + 1] == i) &&
+			(palette_[3 * i + 2] == i);
+	}
+
+	result->clear();
+	result->insert(result->end(), signature, signature + 8);
+
+	vector<uint8_t> header;
+	putUInt32(&header, width_);
+	putUInt32(&header, height_);
+	header.push_back(8);             // bit depth
+	header.push_back(grey ? 0 : 3);  // grey scale or palette
+	header.push_back(0);             // deflate
+	header.push_back(0);             // adaptive filtering
+	header.push_back(0);             // no interlace
+	putChunk(result, "IHDR", &(header[0]), header.size());
+
+	if (!grey) putChunk(result, "PLTE", &(palette_[0]), palette_.size());
+
+	// Each row starts with its filter type (none).
+	vector<uint8_t> raw((long)(width_ + 1) * height_);
+	for (int y = 0; y < height_; y++) {
+		uint8_t *row = &(raw[0]) + (long)y * (width_ + 1);
+		row[0] = 0;
+		if (width_ > 0) memcpy(row + 1, getRow(y), width_);
+	}
+
+	uLongf length = compressBound(raw.size());
+	vector<uint8_t> compressed(length);
+	compress2(&(compressed[0]), &length, raw.empty() ? NULL : &(raw[0]), raw.size(), level);
+	putChunk(result, "IDAT", &(compressed[0]), length);
+
+	putChunk(result, "IEND", NULL, 0);
+}
+
+
+bool PNGImage::write(const string &fileName, int level) const
+{
+	vector<uint8_t> data;
+	encode(&data, level);
+
+	string temporary = fileName + ".tmp";
+	FILE *file = fopen(temporary.c_str(), "wb");
+	if (file == NULL) return false;
+
+	bool ok = (fwrite(&(data[0]), 1, data.size(), file) == data.size());
+	ok = (fclose(file) == 0) && ok;
+
+	if (!ok || (rename(temporary.c_str(), fileName.c_str()) != 0)) {
+		remove(temporary.c_str());
+		return false;
+	}
+
+	return true;
+}
+
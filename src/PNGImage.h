@@ -0,0 +1,108 @@
+/**
+ * \file   PNGImage.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the PNGImage class.
+ */
+
+#ifndef PNGIMAGE_Z7RK2MWD
+#define PNGIMAGE_Z7RK2MWD
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+/// Width of a character of the built-in font (with the spacing).
+#define PNG_FONT_WIDTH  6
+/// Height of a line of the built-in font (with the spacing).
+#define PNG_FONT_HEIGHT 11
+
+
+/**
+ * \brief 8-bit image with a palette of 256 colours, written as PNG.
+ *
+ * Only what the spectrogram renderer needs: filling, horizontal and
+ * vertical lines, text in a built-in 5x7 font, area-averaging downscaling
+ * and the PNG encoding (with zlib).
+ */
+class PNGImage {
+private:
+	int             width_;
+	int             height_;
+	vector<uint8_t> pixels_;
+	/// RGB triplets of the 256 colours.
+	vector<uint8_t> palette_;
+
+public:
+	/// Creates an image filled with colour 0 and a grey scale palette.
+	PNGImage(int width = 0, int height = 0);
+
+	void resize(int width, int height);
+
+	int getWidth() const  { return width_; }
+	int getHeight() const { return height_; }
+
+	uint8_t* getRow(int y) { return &(pixels_[0]) + (long)y * width_; }
+	const uint8_t* getRow(int y) const { return &(pixels_[0]) + (long)y * width_; }
+
+	uint8_t getPixel(int x, int y) const { return pixels_[(long)y * width_ + x]; }
+	void    setPixel(int x, int y, uint8_t colour);
+
+	/// Sets the palette to 256 RGB triplets.
+	void setPalette(const uint8_t *palette);
+	const uint8_t* getPalette() const { return &(palette_[0]); }
+
+	void fill(uint8_t colour);
+
+	/**
+	 * \brief Draws a line. Only horizontal and vertical lines are drawn,
+	 *        clipped to the image.
+	 */
+	void drawLine(int x0, int y0, int x1, int y1, uint8_t colour);
+
+	/**
+	 * \brief Draws text with its top left corner at \c x, \c y (clipped to
+	 *        the image). Characters outside of ASCII are drawn as '?'.
+	 */
+	void drawText(int x, int y, const string &text, uint8_t colour);
+
+	/// Returns the width of text in pixels.
+	static int getTextWidth(const string &text)
+	{
+		return (int)text.size() * PNG_FONT_WIDTH;
+	}
+
+	static int getTextHeight() { return PNG_FONT_HEIGHT; }
+
+	/**
+	 * \brief Copies the image into \c target at \c x, \c y.
+	 */
+	void copyTo(PNGImage *target, int x, int y) const;
+
+	/**
+	 * \brief Scales the image down to \c width x \c height (each at most the
+	 *        current size) by averaging the pixel values.
+	 *
+	 * Meant for images whose values are levels of a colour map.
+	 */
+	void scaleDown(int width, int height);
+
+	/**
+	 * \brief Encodes the image as PNG.
+	 *
+	 * \param level zlib compression level (1 fastest to 9 smallest)
+	 */
+	void encode(vector<uint8_t> *result, int level = 6) const;
+
+	/**
+	 * \brief Writes the image to a PNG file (replaced atomically).
+	 */
+	bool write(const string &fileName, int level = 6) const;
+};
+
+#endif /* end of include guard: PNGIMAGE_Z7RK2MWD */
+
@@ -0,0 +1,189 @@
+/**
+ * \file   ParallelWAVFrontend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the ParallelWAVFrontend class.
+ */
+
+#include "ParallelWAVFrontend.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// WORKER
+////////////////////////////////////////////////////////////////////////////////
+
+
+void* ParallelWAVFrontend::Worker::threadMethod()
+{
+	long start;
+	while (owner_->nextSegment(&start))
+		owner_->processSegment(backend_, start);
+
+	return NULL;
+}
+
+
+ParallelWAVFrontend::Worker::Worker(ParallelWAVFrontend *owner, Ref<Backend> backend) :
+	owner_(owner), backend_(backend), thread_(NULL)
+{
+}
+
+
+ParallelWAVFrontend::Worker::~Worker()
+{
+	join();
+}
+
+
+void ParallelWAVFrontend::Worker::start()
+{
+	thread_ = new Thread(this, &Worker::threadMethod);
+}
+
+
+void ParallelWAVFrontend::Worker::join()
+{
+	if (thread_ == NULL) return;
+
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PARALLEL WAV FRONTEND
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the start of the next segment to be processed, \c false if all of
+ * the segments have been taken.
+ */
+bool ParallelWAVFrontend::nextSegment(long *start)
+{
+	MutexLock lock(&mutex_);
+
+	if (nextSegment_ >= streamInfo_.startOffset + streamInfo_.length) return false;
+
+	*start = nextSegment_;
+	nextSegment_ += segmentLength_;
+	return true;
+}
+
+
+/**
+ * Passes the segment starting at \c start (followed by the overlap) to
+ * \c backend as a separate stream.
+ */
+void ParallelWAVFrontend::processSegment(Ref<Backend> backend, long start)
+{
+	const DataChunk &chunk = chunks_[0];
+
+	StreamInfo info = streamInfo_;
+	info.startOffset = start;
+	info.length = segmentLength_;
+	long rangeEnd = streamInfo_.startOffset + streamInfo_.length;
+	if (info.length > rangeEnd - start)
+		info.length = rangeEnd - start;
+
+	long end = start + info.length + segmentOverlap_;
+	if (end > chunk.frames) end = chunk.frames;
+
+	backend->startStream(info);
+
+	DataInfo dataInfo;
+	for (long i = start; i < end; i += blockSize_) {
+		int count = blockSize_;
+		if (count > end - i) count = end - i;
+
+		dataInfo.offset = i;
+		dataInfo.timeOffset = info.timeOffset.addSamples(i, info.sampleRate);
+
+		processBlock(backend, getSamples(chunk, i, count), dataInfo);
+	}
+
+	backend->endStream();
+}
+
+
+/**
+ * Constructor.
+ */
+ParallelWAVFrontend::ParallelWAVFrontend(const string &fileName, int blockSize) :
+	MappedWAVFrontend(fileName, blockSize),
+	nextSegment_(0),
+	segmentLength_(0),
+	segmentOverlap_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+ParallelWAVFrontend::~ParallelWAVFrontend()
+{
+}
+
+
+void ParallelWAVFrontend::addBackend(Ref<Backend> backend)
+{
+	workers_.push_back(new Worker(this, backend));
+}
+
+
+void ParallelWAVFrontend::run()
+{
+	if (workers_.size() == 0) return;
+	if (!open()) return;
+
+	if ((workers_.size() < 2) || (chunks_.size() != 1)) {
+		if (chunks_.size() != 1)
+			LOG_WARNING("WAV file with several data chunks, processing sequentially.");
+
+		setBackend(workers_[0]->getBackend());
+		applyRange(backend_);
+		processSequentially();
+		close();
+		return;
+	}
+
+	applyRange(workers_[0]->getBackend());
+
+	// Several segments per worker even out differences in the speed of
+	// the workers.
+	long alignment = workers_[0]->getBackend()->getSegmentAlignment(streamInfo_);
+	if (alignment < 1) alignment = 1;
+
+	long length = streamInfo_.length / (workers_.size() * 4);
+	length = ((length + alignment - 1) / alignment) * alignment;
+	if (length < alignment) length = alignment;
+
+	nextSegment_ = streamInfo_.startOffset;
+	segmentLength_ = length;
+	segmentOverlap_ = workers_[0]->getBackend()->getSegmentOverlap();
+
+	LOG_INFO("Processing " << streamInfo_.length << " frames in segments of " <<
+		    segmentLength_ << " frames (" << segmentOverlap_ <<
+		    " frames of overlap) using " << workers_.size() << " threads.");
+
+	for (unsigned i = 0; i < workers_.size(); i++)
+		workers_[i]->start();
+
+	for (unsigned i = 0; i < workers_.size(); i++)
+		workers_[i]->join();
+
+	close();
+}
+
+
+long ParallelWAVFrontend::getProcessedLength() const
+{
+	if (workers_.size() < 2) return MappedWAVFrontend::getProcessedLength();
+	
+	// All of the segments have been processed when run() returns.
+	return (nextSegment_ > streamInfo_.startOffset) ? streamInfo_.length : 0;
+}
+
@@ -0,0 +1,102 @@
+/**
+ * \file   ParallelWAVFrontend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the ParallelWAVFrontend class.
+ */
+
+#ifndef PARALLELWAVFRONTEND_Q3XN7BKD
+#define PARALLELWAVFRONTEND_Q3XN7BKD
+
+#include <vector>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "MappedWAVFrontend.h"
+
+
+/**
+ * \brief Frontend processing a memory-mapped WAV file in several segments
+ *        at once.
+ *
+ * The file is split into segments which are processed by worker threads,
+ * each driving its own backend (see addBackend()). Every segment is passed
+ * to the backend as a separate stream with StreamInfo::startOffset set to
+ * the position of the segment, followed by the overlap requested by
+ * Backend::getSegmentOverlap(). The segments start at multiples of
+ * Backend::getSegmentAlignment(), so the FFT frames and snapshots are the
+ * same as if the file was processed sequentially.
+ *
+ * Files with more than one data chunk and frontends with less than two
+ * backends are processed sequentially by the first backend.
+ */
+class ParallelWAVFrontend : public MappedWAVFrontend {
+private:
+	/**
+	 * \brief Worker thread driving a single backend.
+	 */
+	class Worker : public Object {
+	private:
+		typedef MethodThread<void, Worker> Thread;
+
+		ParallelWAVFrontend *owner_;
+		Ref<Backend>         backend_;
+		Thread              *thread_;
+
+		Worker(const Worker& other);
+
+		void* threadMethod();
+
+	public:
+		Worker(ParallelWAVFrontend *owner, Ref<Backend> backend);
+		virtual ~Worker();
+
+		Ref<Backend> getBackend() { return backend_; }
+
+		void start();
+		void join();
+	};
+
+	vector<Ref<Worker> > workers_;
+
+	Mutex  mutex_;
+	/// Start of the next segment to be processed.
+	long   nextSegment_;
+	long   segmentLength_;
+	int    segmentOverlap_;
+
+	ParallelWAVFrontend(const ParallelWAVFrontend& other);
+
+	bool nextSegment(long *start);
+	void processSegment(Ref<Backend> backend, long start);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param fileName  name of the WAV file
+	 * \param blockSize number of frames passed to the backends at a time
+	 */
+	ParallelWAVFrontend(const string &fileName, int blockSize = 65536);
+	virtual ~ParallelWAVFrontend();
+
+	/**
+	 * \brief Adds a backend processing one segment at a time in its own
+	 *        thread.
+	 *
+	 * All of the backends have to be configured the same way.
+	 */
+	void addBackend(Ref<Backend> backend);
+	int  getBackendCount() const { return workers_.size(); }
+
+	virtual void run();
+	virtual long getProcessedLength() const;
+};
+
+#endif /* end of include guard: PARALLELWAVFRONTEND_Q3XN7BKD */
+
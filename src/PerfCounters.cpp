@@ -0,0 +1,261 @@
+/**
+ * \file   PerfCounters.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the PerfCounters class.
+ */
+
+#include "PerfCounters.h"
+#include "Atomic.h"
+#include "ThreadRegistry.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+
+void PerfTotals::clear()
+{
+	memset(calls, 0, sizeof(calls));
+	memset(values, 0, sizeof(values));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PERF COUNTERS
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * \brief Counters and totals of a single thread.
+ *
+ * Only the owning thread writes to the totals, with relaxed atomic stores,
+ * so getTotals() can read them at any time.
+ */
+struct PerfCounters::Thread {
+	/// Group of the counters, the first one is the leader.
+	int       fds[PERF_EVENT_COUNT];
+	bool      open;
+	/// Whether the counters failed to open in this thread.
+	bool      failed;
+
+	uint64_t  calls[PERF_STAGE_COUNT];
+	uint64_t  values[PERF_STAGE_COUNT][PERF_EVENT_COUNT];
+
+	Thread   *next;
+	Thread   *nextFree;
+
+	Thread() : open(false), failed(false), next(NULL), nextFree(NULL)
+	{
+		for (int i = 0; i < PERF_EVENT_COUNT; i++) fds[i] = -1;
+		memset(calls, 0, sizeof(calls));
+		memset(values, 0, sizeof(values));
+	}
+
+	void close()
+	{
+		for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+			if (fds[i] >= 0) ::close(fds[i]);
+			fds[i] = -1;
+		}
+		open = false;
+	}
+
+	/// Closes the counters of a finished thread, its totals are kept.
+	void release()
+	{
+		close();
+		failed = false;
+	}
+
+	/**
+	 * Opens and starts the counters of the calling thread.
+	 *
+	 * \returns 0, or the error of \c perf_event_open()
+	 */
+	int openCounters()
+	{
+		static const uint64_t configs[PERF_EVENT_COUNT] = {
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_BRANCH_MISSES
+		};
+
+		for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.size = sizeof(attr);
+			attr.config = configs[i];
+			// The group is started at once below.
+			attr.disabled = (i == 0);
+			// Allowed with perf_event_paranoid up to 2.
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP |
+				PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : fds[0], 0);
+			if (fds[i] < 0) {
+				int error = errno;
+				close();
+				return error;
+			}
+		}
+
+		ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		open = true;
+		return 0;
+	}
+};
+
+
+bool PerfCounters::enabled_ = false;
+
+
+PerfCounters::Thread* PerfCounters::getThread()
+{
+	return ThreadRegistry<Thread>::get();
+}
+
+
+bool PerfCounters::enable()
+{
+	Thread *thread = getThread();
+
+	if (!thread->open) {
+		int error = thread->openCounters();
+		if (error != 0) {
+			thread->failed = true;
+			LOG_WARNING("Hardware performance counters not available (" <<
+					  strerror(error) << "), see /proc/sys/kernel/perf_event_paranoid.");
+			return false;
+		}
+	}
+
+	__atomic_store_n(&enabled_, true, __ATOMIC_RELAXED);
+	return true;
+}
+
+
+void PerfCounters::disable()
+{
+	__atomic_store_n(&enabled_, false, __ATOMIC_RELAXED);
+}
+
+
+bool PerfCounters::read(PerfSample *sample)
+{
+	if (!isEnabled()) return false;
+
+	Thread *thread = getThread();
+	if (!thread->open) {
+		if (thread->failed) return false;
+		if (thread->openCounters() != 0) {
+			thread->failed = true;
+			return false;
+		}
+	}
+
+	// Number of counters, time enabled, time running, the values.
+	uint64_t data[3 + PERF_EVENT_COUNT];
+	if (::read(thread->fds[0], data, sizeof(data)) != (ssize_t)sizeof(data))
+		return false;
+
+	// Scale the values if the counters were multiplexed with others.
+	double scale = 1.0;
+	if ((data[2] > 0) && (data[2] < data[1]))
+		scale = (double)data[1] / (double)data[2];
+
+	for (int i = 0; i < PERF_EVENT_COUNT; i++)
+		sample->values[i] = (scale == 1.0) ? data[3 + i] : (uint64_t)(data[3 + i] * scale);
+
+	return true;
+}
+
+
+void PerfCounters::record(PerfStage stage, const PerfSample &begin, const PerfSample &end)
+{
+	Thread *thread = getThread();
+
+	addRelaxed(&(thread->calls[stage]), 1);
+	for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+		// Scaled values may go back a little.
+		if (end.values[i] > begin.values[i])
+			addRelaxed(&(thread->values[stage][i]), end.values[i] - begin.values[i]);
+	}
+}
+
+
+void PerfCounters::getTotals(PerfTotals *result)
+{
+	result->clear();
+
+	for (Thread *thread = ThreadRegistry<Thread>::getAll(); thread != NULL;
+		thread = thread->next) {
+		for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+			result->calls[i] += loadRelaxed(&(thread->calls[i]));
+			for (int j = 0; j < PERF_EVENT_COUNT; j++)
+				result->values[i][j] += loadRelaxed(&(thread->values[i][j]));
+		}
+	}
+}
+
+
+void PerfCounters::write(ostream &output, const PerfTotals &current,
+					const PerfTotals *previous)
+{
+	output << fixed;
+
+	for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+		uint64_t calls = current.calls[i] - (previous ? previous->calls[i] : 0);
+
+		output << "perf " << getName((PerfStage)i) << " calls=" << calls;
+
+		double values[PERF_EVENT_COUNT];
+		for (int j = 0; j < PERF_EVENT_COUNT; j++) {
+			uint64_t value = current.values[i][j] - (previous ? previous->values[i][j] : 0);
+			values[j] = calls ? (double)value / calls : 0;
+			output << " " << getName((PerfEvent)j) << "=" << setprecision(0) << values[j];
+		}
+
+		double ipc = values[PERF_CYCLES] ? values[PERF_INSTRUCTIONS] / values[PERF_CYCLES] : 0;
+		output << " ipc=" << setprecision(2) << ipc << endl;
+	}
+}
+
+
+const char* PerfCounters::getName(PerfStage stage)
+{
+	switch (stage) {
+	case PERF_WINDOW:    return "window";
+	case PERF_FFT:       return "fft";
+	case PERF_MAGNITUDE: return "magnitude";
+	case PERF_WRITE:     return "write";
+	default:             return "unknown";
+	}
+}
+
+
+const char* PerfCounters::getName(PerfEvent event)
+{
+	switch (event) {
+	case PERF_CYCLES:        return "cycles";
+	case PERF_INSTRUCTIONS:  return "instructions";
+	case PERF_LLC_MISSES:    return "llc_misses";
+	case PERF_BRANCH_MISSES: return "branch_misses";
+	default:                 return "unknown";
+	}
+}
+
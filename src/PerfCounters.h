@@ -0,0 +1,171 @@
+/**
+ * \file   PerfCounters.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the PerfCounters class.
+ */
+
+#ifndef PERFCOUNTERS_V2KD8TJF
+#define PERFCOUNTERS_V2KD8TJF
+
+#include <stdint.h>
+#include <ostream>
+
+using namespace std;
+
+
+/**
+ * \brief Measured stages of the processing.
+ */
+enum PerfStage {
+	/// Conversion and windowing of an FFT frame.
+	PERF_WINDOW,
+	/// The FFT of a frame.
+	PERF_FFT,
+	/// Magnitudes of a spectrum.
+	PERF_MAGNITUDE,
+	/// Writing a snapshot file.
+	PERF_WRITE,
+
+	PERF_STAGE_COUNT
+};
+
+
+/**
+ * \brief Counted hardware events.
+ */
+enum PerfEvent {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	/// Last level cache misses.
+	PERF_LLC_MISSES,
+	PERF_BRANCH_MISSES,
+
+	PERF_EVENT_COUNT
+};
+
+
+/**
+ * \brief Values of the counters of a thread at a moment.
+ */
+struct PerfSample {
+	uint64_t values[PERF_EVENT_COUNT];
+};
+
+
+/**
+ * \brief Sums of the counters of each stage over all threads.
+ */
+struct PerfTotals {
+	/// Number of measured runs of each stage (frames, snapshots).
+	uint64_t calls[PERF_STAGE_COUNT];
+	uint64_t values[PERF_STAGE_COUNT][PERF_EVENT_COUNT];
+
+	PerfTotals() { clear(); }
+
+	void clear();
+};
+
+
+/**
+ * \brief Hardware performance counters (Linux \c perf_event_open()) of the
+ *        processing stages.
+ *
+ * Each thread counts the cycles, instructions, LLC misses and branch misses
+ * of its own work in a group of counters opened on its first measurement,
+ * and adds the differences around each stage to its own totals. The totals
+ * are written by Metrics::write() as the averages per run of each stage,
+ * i.e. per FFT frame and per snapshot.
+ *
+ * The counters are disabled unless enable() succeeds, so the measurement
+ * costs nothing where perf is not allowed (see
+ * /proc/sys/kernel/perf_event_paranoid) or the CPU has no counters (as in
+ * many virtual machines). Threads which can't open the counters skip the
+ * measurements.
+ */
+class PerfCounters {
+public:
+	/// Counters and totals of a single thread (see PerfCounters.cpp).
+	struct Thread;
+
+private:
+	static bool enabled_;
+
+	static Thread* getThread();
+
+public:
+	/**
+	 * \brief Enables the counters if they can be opened by the calling
+	 *        thread.
+	 *
+	 * \returns \c false (with a warning in the log) if they can't
+	 */
+	static bool enable();
+	static void disable();
+
+	static bool isEnabled()
+	{
+		return __atomic_load_n(&enabled_, __ATOMIC_RELAXED);
+	}
+
+	/**
+	 * \brief Reads the counters of the calling thread.
+	 *
+	 * \returns \c false if the counters are disabled or not available to
+	 *          the thread
+	 */
+	static bool read(PerfSample *sample);
+
+	/**
+	 * \brief Adds the differences of the counters of a run of a stage to
+	 *        the totals of the calling thread.
+	 */
+	static void record(PerfStage stage, const PerfSample &begin, const PerfSample &end);
+
+	/// Sums the totals of all threads.
+	static void getTotals(PerfTotals *result);
+
+	/**
+	 * \brief Writes the averages per run of each stage, since \c previous
+	 *        (if not \c NULL).
+	 */
+	static void write(ostream &output, const PerfTotals &current,
+				   const PerfTotals *previous);
+
+	static const char* getName(PerfStage stage);
+	static const char* getName(PerfEvent event);
+};
+
+
+/**
+ * \brief Measures a run of a stage from its construction to its destruction
+ *        (or stop()) if the counters are enabled.
+ */
+class PerfScope {
+private:
+	PerfStage  stage_;
+	PerfSample begin_;
+	bool       running_;
+
+public:
+	PerfScope(PerfStage stage) :
+		stage_(stage), running_(false)
+	{
+		if (PerfCounters::isEnabled()) running_ = PerfCounters::read(&begin_);
+	}
+
+	~PerfScope() { stop(); }
+
+	void stop()
+	{
+		if (!running_) return;
+
+		PerfSample end;
+		if (PerfCounters::read(&end)) PerfCounters::record(stage_, begin_, end);
+		running_ = false;
+	}
+};
+
+#endif /* end of include guard: PERFCOUNTERS_V2KD8TJF */
+
@@ -0,0 +1,192 @@
+/**
+ * \file   RawIQFrontend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the RawIQFrontend class.
+ */
+
+#include "RawIQFrontend.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+/**
+ * Size of the pipe buffer requested for FIFOs and the standard input, so
+ * that the writer is not blocked between the reads.
+ */
+static const int PIPE_SIZE = 1 << 20;
+
+
+bool RawIQFrontend::openInput()
+{
+	if (fd_ >= 0) {
+		// Opened by the caller.
+	} else if (input_ == "-") {
+		fd_ = STDIN_FILENO;
+		ownsFd_ = false;
+	} else if (input_.compare(0, 5, "unix:") == 0) {
+		string path = input_.substr(5);
+
+		struct sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path)) {
+			LOG_ERROR("Socket path \"" << path << "\" is too long.");
+			return false;
+		}
+		strcpy(address.sun_path, path.c_str());
+
+		fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd_ < 0) {
+			LOG_ERROR("Failed to create socket: " << strerror(errno));
+			return false;
+		}
+		if (connect(fd_, (struct sockaddr*)&address, sizeof(address)) != 0) {
+			LOG_ERROR("Failed to connect to \"" << path << "\": " << strerror(errno));
+			close(fd_);
+			fd_ = -1;
+			return false;
+		}
+		ownsFd_ = true;
+	} else {
+		fd_ = open(input_.c_str(), O_RDONLY);
+		if (fd_ < 0) {
+			LOG_ERROR("Failed to open \"" << input_ << "\": " << strerror(errno));
+			return false;
+		}
+		ownsFd_ = true;
+	}
+
+#ifdef F_SETPIPE_SZ
+	// Fails for anything but pipes, which is fine.
+	fcntl(fd_, F_SETPIPE_SZ, PIPE_SIZE);
+#endif
+
+	return true;
+}
+
+
+void RawIQFrontend::closeInput()
+{
+	if (fd_ < 0) return;
+
+	if (ownsFd_) {
+		close(fd_);
+		fd_ = -1;
+	}
+}
+
+
+/**
+ * Constructor.
+ */
+RawIQFrontend::RawIQFrontend(const string &input, SampleFormat format,
+					    int sampleRate, int blockSize) :
+	input_(input),
+	fd_(-1),
+	ownsFd_(false),
+	format_(format),
+	sampleRate_(sampleRate),
+	realTime_(true),
+	buffer_((long)((blockSize < 1) ? 1 : blockSize) * getSampleSize(format))
+{
+}
+
+
+/**
+ * Constructor.
+ */
+RawIQFrontend::RawIQFrontend(int fd, SampleFormat format,
+					    int sampleRate, int blockSize) :
+	fd_(fd),
+	ownsFd_(false),
+	format_(format),
+	sampleRate_(sampleRate),
+	realTime_(true),
+	buffer_((long)((blockSize < 1) ? 1 : blockSize) * getSampleSize(format))
+{
+}
+
+
+/**
+ * Destructor.
+ */
+RawIQFrontend::~RawIQFrontend()
+{
+	closeInput();
+}
+
+
+void RawIQFrontend::run()
+{
+	if (!openInput()) return;
+
+	int sampleSize = getSampleSize(format_);
+	// Bytes of an incomplete sample at the start of the buffer.
+	int pending = 0;
+	bool started = false;
+
+	while (true) {
+		ssize_t count = read(fd_, &(buffer_[pending]), buffer_.size() - pending);
+
+		if (count < 0) {
+			if (errno == EINTR) continue;
+
+			LOG_ERROR("Failed to read IQ input: " << strerror(errno));
+			break;
+		}
+		if (count == 0) break;
+
+		// The time of the first sample is the time it arrived unless set.
+		if (!started) {
+			streamInfo_ = StreamInfo();
+			streamInfo_.sampleRate = sampleRate_;
+			streamInfo_.realTime = realTime_;
+			streamInfo_.timeOffset = hasStartTime_ ? startTime_ : Clock::getDefault()->now();
+			startStream();
+			started = true;
+		}
+
+		int bytes = pending + count;
+		int samples = bytes / sampleSize;
+
+		if (samples > 0)
+			process(SampleSpan(format_, &(buffer_[0]), samples));
+
+		pending = bytes - samples * sampleSize;
+		if (pending > 0)
+			memmove(&(buffer_[0]), &(buffer_[samples * sampleSize]), pending);
+	}
+
+	if (pending > 0) {
+		LOG_WARNING("IQ input ended with an incomplete sample (" << pending <<
+				  " bytes).");
+	}
+
+	if (started) endStream();
+
+	closeInput();
+}
+
+
+bool RawIQFrontend::parseFormat(const string &name, SampleFormat *format)
+{
+	if (name == "u8") {
+		*format = SAMPLE_COMPLEX_UINT8;
+	} else if (name == "s16") {
+		*format = SAMPLE_COMPLEX_INT16;
+	} else if (name == "cf32") {
+		*format = SAMPLE_COMPLEX_FLOAT;
+	} else {
+		return false;
+	}
+	return true;
+}
+
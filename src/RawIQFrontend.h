@@ -0,0 +1,90 @@
+/**
+ * \file   RawIQFrontend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the RawIQFrontend class.
+ */
+
+#ifndef RAWIQFRONTEND_V7NC4XPA
+#define RAWIQFRONTEND_V7NC4XPA
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "Frontend.h"
+
+
+/**
+ * \brief Frontend reading a headerless stream of interleaved IQ samples.
+ *
+ * The input is the standard input, a file or FIFO, or a UNIX stream socket
+ * (for example the output of an SDR receiver such as rtl_sdr). The samples
+ * are unsigned 8-bit, signed 16-bit or 32-bit float IQ pairs of configured
+ * sample rate.
+ *
+ * The input is read in large blocking reads straight into a buffer the
+ * samples are passed to the backend from, so the samples are not copied
+ * before the backend. Incomplete samples at the end of a read are kept for
+ * the next one. The stream ends at the end of the input.
+ */
+class RawIQFrontend : public Frontend {
+private:
+	string        input_;
+	int           fd_;
+	/// Whether the descriptor was opened (and has to be closed) by the
+	/// frontend.
+	bool          ownsFd_;
+
+	SampleFormat  format_;
+	int           sampleRate_;
+	bool          realTime_;
+
+	/// Read buffer, a whole number of samples.
+	vector<char>  buffer_;
+
+	RawIQFrontend(const RawIQFrontend& other);
+
+	bool openInput();
+	void closeInput();
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param input      "-" for the standard input, "unix:PATH" for a UNIX
+	 *                   socket, otherwise the name of a file or FIFO
+	 * \param format     format of the samples
+	 * \param sampleRate sample rate in Hz
+	 * \param blockSize  maximum number of samples read at a time
+	 */
+	RawIQFrontend(const string &input, SampleFormat format, int sampleRate,
+			    int blockSize = 65536);
+	/**
+	 * Constructor reading an open file descriptor (not closed by the
+	 * frontend).
+	 */
+	RawIQFrontend(int fd, SampleFormat format, int sampleRate,
+			    int blockSize = 65536);
+	virtual ~RawIQFrontend();
+
+	/**
+	 * \brief Sets whether the input is live (see StreamInfo::realTime),
+	 *        which it is by default.
+	 */
+	void setRealTime(bool realTime) { realTime_ = realTime; }
+
+	virtual void run();
+
+	/**
+	 * \brief Parses a sample format name ("u8", "s16" or "cf32").
+	 *
+	 * \returns \c false if the name is not known
+	 */
+	static bool parseFormat(const string &name, SampleFormat *format);
+};
+
+#endif /* end of include guard: RAWIQFRONTEND_V7NC4XPA */
+
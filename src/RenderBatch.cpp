@@ -0,0 +1,215 @@
+/**
+ * \file   RenderBatch.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the RenderBatch class.
+ */
+
+#include "RenderBatch.h"
+#include "WFTime.h"
+
+#include <algorithm>
+
+#include <strings.h>
+
+#include <fitsio.h>
+
+
+static bool isFITSFileName(const string &name)
+{
+	return ((name.size() > 5) &&
+		   (strcasecmp(name.c_str() + name.size() - 5, ".fits") == 0)) ||
+		((name.size() > 4) &&
+		 (strcasecmp(name.c_str() + name.size() - 4, ".fit") == 0));
+}
+
+
+/**
+ * Reads a header, a missing one is not an error.
+ *
+ * \returns \c true if the header was read
+ */
+static bool readKey(fitsfile *file, int type, const char *keyword, void *value,
+				int *status)
+{
+	if (*status) return false;
+
+	fits_read_key(file, type, keyword, value, NULL, status);
+	if (*status == KEY_NO_EXIST) {
+		*status = 0;
+		return false;
+	}
+
+	return *status == 0;
+}
+
+
+static string readString(fitsfile *file, const char *keyword,
+					const string &defaultValue, int *status)
+{
+	char value[FLEN_VALUE];
+	if (!readKey(file, TSTRING, keyword, value, status)) return defaultValue;
+	return value;
+}
+
+
+static double readDouble(fitsfile *file, const char *keyword, double defaultValue,
+					int *status)
+{
+	double value;
+	if (!readKey(file, TDOUBLE, keyword, &value, status)) return defaultValue;
+	return value;
+}
+
+
+bool RenderBatch::readFITS(const string &fileName, Spectrogram *result,
+					  vector<float> *data)
+{
+	int status = 0;
+	fitsfile *file;
+
+	fits_open_file(&file, fileName.c_str(), READONLY, &status);
+	if (status) {
+		char message[FLEN_STATUS];
+		fits_get_errstatus(status, message);
+		LOG_ERROR("Failed to open FITS file \"" << fileName << "\": " << message << ".");
+		return false;
+	}
+
+	int  dimensions = 0;
+	long size[2] = { 0, 0 };
+	fits_get_img_dim(file, &dimensions, &status);
+	if (!status && (dimensions == 2)) fits_get_img_size(file, 2, size, &status);
+
+	if (!status && (dimensions == 2)) {
+		data->resize(size[0] * size[1]);
+
+		long first[2] = { 1, 1 };
+		int  anyNull;
+		if (!data->empty()) {
+			fits_read_pix(file, TFLOAT, first, data->size(), NULL,
+					    &((*data)[0]), &anyNull, &status);
+		}
+	}
+
+	if (!status && (dimensions == 2)) {
+		result->width = size[0];
+		result->height = size[1];
+		result->data = data->empty() ? NULL : &((*data)[0]);
+
+		const char *keywords[2][4] = {
+			{ "CRPIX1", "CRVAL1", "CDELT1", "CTYPE1" },
+			{ "CRPIX2", "CRVAL2", "CDELT2", "CTYPE2" }
+		};
+		for (int i = 0; i < 2; i++) {
+			result->axes[i] = SpectrogramAxis(
+				readDouble(file, keywords[i][0], 1, &status),
+				readDouble(file, keywords[i][1], 1, &status),
+				readDouble(file, keywords[i][2], 1, &status),
+				size[i],
+				readString(file, keywords[i][3], "", &status)
+			);
+		}
+
+		result->origin = readString(file, "ORIGIN", "-", &status);
+		result->date = readString(file, "DATE", "", &status);
+		result->observationDate = readString(file, "DATE-OBS", "", &status);
+
+		// DATE-OBS is the time of the first row, to the second.
+		string observationDate = result->observationDate;
+		replace(observationDate.begin(), observationDate.end(), 'T', ' ');
+		WFTime time;
+		if (result->axes[1].isTime() && WFTime::parse(observationDate, &time) &&
+		    (result->axes[1].reference == 0)) {
+			result->axes[1].value = time.seconds();
+		}
+	}
+
+	int closeStatus = 0;
+	fits_close_file(file, &closeStatus);
+
+	if (status) {
+		char message[FLEN_STATUS];
+		fits_get_errstatus(status, message);
+		LOG_ERROR("Failed to read FITS file \"" << fileName << "\": " << message << ".");
+		return false;
+	}
+	if (dimensions != 2) {
+		LOG_ERROR("FITS file \"" << fileName << "\" is not a 2 dimensional image.");
+		return false;
+	}
+
+	return true;
+}
+
+
+bool RenderBatch::renderFile(const SpectrogramRenderer &renderer, const string &fileName)
+{
+	Spectrogram   spectrogram;
+	vector<float> data;
+	if (!readFITS(fileName, &spectrogram, &data)) return false;
+
+	PNGImage image;
+	renderer.render(spectrogram, &image);
+
+	string outputName = fileName + ".png";
+	if (!image.write(outputName)) {
+		LOG_ERROR("Failed to write \"" << outputName << "\".");
+		return false;
+	}
+
+	return true;
+}
+
+
+bool RenderBatch::isInputFile(const string &name) const
+{
+	return isFITSFileName(name);
+}
+
+
+void RenderBatch::processFile(unsigned index)
+{
+	bool ok = renderFile(renderer_, files_[index]);
+
+	MutexLock lock(&mutex_);
+
+	int done = finishFile(ok);
+	if (ok) {
+		LOG_DEBUG("[" << done << "/" << files_.size() << "] Rendered " <<
+				files_[index] << ".");
+	}
+}
+
+
+/**
+ * Constructor.
+ */
+RenderBatch::RenderBatch(const SpectrogramRenderer &renderer, int threads) :
+	FileBatch("FITS", threads),
+	renderer_(renderer)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+RenderBatch::~RenderBatch()
+{
+}
+
+
+int RenderBatch::run()
+{
+	LOG_INFO("Rendering " << files_.size() << " files using " << getWorkerCount() <<
+		    " threads.");
+
+	double seconds = runWorkers();
+
+	LOG_INFO("Rendered " << (done_ - failed_) << " of " << files_.size() <<
+		    " files (" << failed_ << " failed) in " << seconds << " s.");
+
+	return failed_;
+}
@@ -0,0 +1,75 @@
+/**
+ * \file   RenderBatch.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the RenderBatch class.
+ */
+
+#ifndef RENDERBATCH_W6FJ3NQA
+#define RENDERBATCH_W6FJ3NQA
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "FileBatch.h"
+#include "SpectrogramRenderer.h"
+
+
+/**
+ * \brief Renders FITS snapshots into PNG images (\c FILE.png next to each
+ *        \c FILE) by a pool of worker threads, like the \c fits2png script.
+ *
+ * The inputs are given like those of a Batch (see FileBatch::addInput()).
+ */
+class RenderBatch : public FileBatch {
+private:
+	SpectrogramRenderer renderer_;
+
+	RenderBatch(const RenderBatch& other);
+
+protected:
+	virtual bool isInputFile(const string &name) const;
+	virtual void processFile(unsigned index);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param renderer renders the images (copied)
+	 * \param threads  number of files rendered at once
+	 */
+	RenderBatch(const SpectrogramRenderer &renderer, int threads);
+	virtual ~RenderBatch();
+
+	/**
+	 * \brief Reads a two dimensional FITS image with its axes and legend.
+	 *
+	 * The time axis refers to \c DATE-OBS if the file has it (\c CRVAL2 is a
+	 * float with the precision of minutes for the current times).
+	 *
+	 * \param data holds the values of the spectrogram
+	 */
+	static bool readFITS(const string &fileName, Spectrogram *result,
+					 vector<float> *data);
+
+	/// Renders a FITS file into \c FILE.png.
+	static bool renderFile(const SpectrogramRenderer &renderer,
+					   const string &fileName);
+
+	/**
+	 * \brief Renders all of the files.
+	 *
+	 * \returns the number of files that failed
+	 */
+	int run();
+};
+
+#endif /* end of include guard: RENDERBATCH_W6FJ3NQA */
+
@@ -9,6 +9,13 @@
 #ifndef RINGBUFFER_HSQMLSDG
 #define RINGBUFFER_HSQMLSDG
 
+#include <cassert>
+#include <cstring>
+#include <cstddef>
+
+/// Size of a cache line in bytes (used to prevent false sharing).
+#define CACHE_LINE_SIZE 64
+
 /**
  * \todo Write documentation for class RingBuffer.
  *
@@ -53,7 +60,7 @@ public:
 			} else {
 				memcpy(tail_, other.tail_,
 					  sizeof(T) * (buffer_ + capacity_ - tail_));
-				memcpy(tail_, other.buffer_,
+				memcpy(buffer_, other.buffer_,
 					  sizeof(T) * (head_ - buffer_));
 			}
 		}
@@ -485,5 +492,274 @@ public:
 };
 
 
+/**
+ * \brief Wait-free single-producer/single-consumer ring buffer.
+ *
+ * One thread (the producer) writes to the buffer and another thread (the
+ * consumer) reads from it, without any locks. This makes the buffer safe
+ * to use from a real-time callback. The head (written by the producer) and
+ * the tail (written by the consumer) are kept on separate cache lines and
+ * synchronized with acquire/release atomics.
+ *
+ * Unlike RingBuffer, a full buffer is never overwritten. Items that don't
+ * fit are rejected and counted (see getOverflowCount()).
+ *
+ * Items are copied with \c memcpy, so \c T must be a POD type. The
+ * capacity is rounded up to a power of two.
+ */
+template<class T>
+class SPSCRingBuffer {
+private:
+	T             *buffer_;
+	unsigned long  capacity_;
+	unsigned long  mask_;
+	
+	char           padding0_[CACHE_LINE_SIZE];
+	
+	/// Number of items written so far (written by the producer).
+	unsigned long  head_;
+	/// Producer's copy of the tail (saves reads of the consumer's line).
+	unsigned long  tailCache_;
+	/// Number of items rejected because the buffer was full.
+	unsigned long  overflowCount_;
+	
+	char           padding1_[CACHE_LINE_SIZE];
+	
+	/// Number of items read so far (written by the consumer).
+	unsigned long  tail_;
+	/// Consumer's copy of the head.
+	unsigned long  headCache_;
+	
+	char           padding2_[CACHE_LINE_SIZE];
+	
+	SPSCRingBuffer(const SPSCRingBuffer& other);
+	
+	/**
+	 * Returns the free space, reloads the consumer's tail only if there
+	 * seems to be less than \c wanted free items.
+	 */
+	inline int freeSpace(unsigned long wanted)
+	{
+		unsigned long free = capacity_ - (head_ - tailCache_);
+		if (free < wanted) {
+			tailCache_ = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+			free = capacity_ - (head_ - tailCache_);
+		}
+		return free;
+	}
+	
+	/**
+	 * Returns the number of stored items, reloads the producer's head
+	 * only if there seems to be less than \c wanted items.
+	 */
+	inline int usedSpace(unsigned long wanted)
+	{
+		unsigned long used = headCache_ - tail_;
+		if (used < wanted) {
+			headCache_ = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+			used = headCache_ - tail_;
+		}
+		return used;
+	}
+	
+	inline void countOverflow(int count)
+	{
+		__atomic_add_fetch(&overflowCount_, count, __ATOMIC_RELAXED);
+	}
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param capacity minimal capacity of the buffer in items
+	 */
+	SPSCRingBuffer(int capacity) :
+		buffer_(NULL), capacity_(1), mask_(0),
+		head_(0), tailCache_(0), overflowCount_(0),
+		tail_(0), headCache_(0)
+	{
+		assert(capacity > 0);
+		
+		while (capacity_ < (unsigned long)capacity)
+			capacity_ <<= 1;
+		mask_ = capacity_ - 1;
+		
+		buffer_ = new T[capacity_];
+	}
+	/**
+	 * Destructor.
+	 */
+	~SPSCRingBuffer()
+	{
+		delete [] buffer_;
+		buffer_ = NULL;
+	}
+	
+	inline int getCapacity() const { return capacity_; }
+	
+	/**
+	 * \brief Returns the number of items that can be read (any thread).
+	 */
+	inline int getSize() const
+	{
+		return (__atomic_load_n(&head_, __ATOMIC_ACQUIRE) -
+			   __atomic_load_n(&tail_, __ATOMIC_ACQUIRE));
+	}
+	
+	/**
+	 * \brief Returns the number of rejected items (any thread).
+	 */
+	inline long getOverflowCount() const
+	{
+		return __atomic_load_n(&overflowCount_, __ATOMIC_RELAXED);
+	}
+	
+	/**
+	 * \brief Empties the buffer. Must not be called concurrently with
+	 *        any other method.
+	 */
+	void reset()
+	{
+		head_ = tailCache_ = tail_ = headCache_ = 0;
+		overflowCount_ = 0;
+	}
+	
+	////////////////////////////////////////////////////////////////////
+	// PRODUCER
+	////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * \brief Returns the number of items that can be written.
+	 */
+	inline int getWriteSpace() { return freeSpace(capacity_); }
+	
+	/**
+	 * \brief Writes up to \c count items.
+	 *
+	 * The items are copied in at most two contiguous segments. The items
+	 * that don't fit are counted as overflow.
+	 *
+	 * \returns the number of items written
+	 */
+	int write(const T *items, int count)
+	{
+		int free = freeSpace(count);
+		if (count > free) {
+			countOverflow(count - free);
+			count = free;
+		}
+		if (count < 1) return 0;
+		
+		unsigned long start = head_ & mask_;
+		unsigned long first = capacity_ - start;
+		if (first > (unsigned long)count) first = count;
+		
+		memcpy(buffer_ + start, items, first * sizeof(T));
+		memcpy(buffer_, items + first, (count - first) * sizeof(T));
+		
+		__atomic_store_n(&head_, head_ + count, __ATOMIC_RELEASE);
+		return count;
+	}
+	
+	/**
+	 * \brief Writes all of the \c count items or nothing.
+	 *
+	 * If the items don't fit, all of them are counted as overflow.
+	 */
+	bool tryWrite(const T *items, int count)
+	{
+		if (freeSpace(count) < count) {
+			countOverflow(count);
+			return false;
+		}
+		
+		write(items, count);
+		return true;
+	}
+	
+	/**
+	 * \brief Returns the contiguous writable part of the buffer.
+	 *
+	 * The items written to \c *items are published by commit().
+	 *
+	 * \returns number of items that can be written to \c *items
+	 */
+	int reserve(T **items)
+	{
+		unsigned long start = head_ & mask_;
+		unsigned long first = capacity_ - start;
+		unsigned long free  = freeSpace(first);
+		
+		*items = buffer_ + start;
+		return (first < free) ? first : free;
+	}
+	
+	/**
+	 * \brief Publishes \c count items written to the reserved part.
+	 */
+	void commit(int count)
+	{
+		__atomic_store_n(&head_, head_ + count, __ATOMIC_RELEASE);
+	}
+	
+	////////////////////////////////////////////////////////////////////
+	// CONSUMER
+	////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * \brief Returns the number of items that can be read.
+	 */
+	inline int getReadSpace() { return usedSpace(capacity_); }
+	
+	/**
+	 * \brief Reads up to \c count items (in at most two segments).
+	 *
+	 * \returns the number of items read
+	 */
+	int read(T *items, int count)
+	{
+		int used = usedSpace(count);
+		if (count > used) count = used;
+		if (count < 1) return 0;
+		
+		unsigned long start = tail_ & mask_;
+		unsigned long first = capacity_ - start;
+		if (first > (unsigned long)count) first = count;
+		
+		memcpy(items, buffer_ + start, first * sizeof(T));
+		memcpy(items + first, buffer_, (count - first) * sizeof(T));
+		
+		__atomic_store_n(&tail_, tail_ + count, __ATOMIC_RELEASE);
+		return count;
+	}
+	
+	/**
+	 * \brief Returns the contiguous readable part of the buffer without
+	 *        copying it.
+	 *
+	 * The items stay valid until they are released by consume().
+	 *
+	 * \returns number of items that can be read from \c *items
+	 */
+	int peek(const T **items)
+	{
+		unsigned long start = tail_ & mask_;
+		unsigned long first = capacity_ - start;
+		unsigned long used  = usedSpace(first);
+		
+		*items = buffer_ + start;
+		return (first < used) ? first : used;
+	}
+	
+	/**
+	 * \brief Releases \c count items returned by peek().
+	 */
+	void consume(int count)
+	{
+		__atomic_store_n(&tail_, tail_ + count, __ATOMIC_RELEASE);
+	}
+};
+
+
 #endif /* end of include guard: RINGBUFFER_HSQMLSDG */
 
@@ -0,0 +1,191 @@
+/**
+ * \file   SampleBus.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SampleBusBackend class.
+ */
+
+#include "SampleBus.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+
+
+/// Slots are aligned to cache lines.
+#define SLOT_ALIGNMENT 64
+
+
+/**
+ * Constructor.
+ */
+SampleBusBackend::SampleBusBackend(string       name,
+							float        length,
+							int          blockLength,
+							Ref<Backend> next) :
+	Backend(),
+	name_(name),
+	length_(length),
+	// A slot fits at least one sample of any format.
+	blockLength_((blockLength < 8) ? 8 : blockLength),
+	next_(next),
+	header_(NULL),
+	written_(0),
+	failed_(false)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+SampleBusBackend::~SampleBusBackend()
+{
+	destroy();
+}
+
+
+void SampleBusBackend::destroy()
+{
+	if (header_ != NULL)
+		__atomic_store_n(&header_->state, SAMPLE_BUS_ENDED, __ATOMIC_RELEASE);
+	header_ = NULL;
+	segment_.destroy();
+}
+
+
+/**
+ * Creates the ring for samples of \c format. The segment of the previous
+ * stream is replaced, the readers still mapping it see it ended.
+ */
+bool SampleBusBackend::create(SampleFormat format)
+{
+	long   blocks = (long)ceil((double)length_ * streamInfo_.sampleRate / blockLength_);
+	if (blocks < 4) blocks = 4;
+	size_t blockBytes = (size_t)blockLength_ * getSampleSize(format);
+	size_t headerSize = (sizeof(SampleBusHeader) + SLOT_ALIGNMENT - 1) /
+		SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+	size_t slotSize = (offsetof(SampleBusSlot, data) + blockBytes +
+				    SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+	size_t size = headerSize + blocks * slotSize;
+
+	if (!segment_.create(name_, size)) return false;
+	header_ = (SampleBusHeader*)segment_.getMemory();
+
+	header_->version = SAMPLE_BUS_VERSION;
+	header_->headerSize = headerSize;
+	header_->capacity = blocks;
+	header_->slotSize = slotSize;
+	header_->blockBytes = blockBytes;
+	header_->sampleRate = streamInfo_.sampleRate;
+	header_->realTime = streamInfo_.realTime;
+	header_->timeOffset = (int64_t)streamInfo_.timeOffset.seconds() * 1000000 +
+		streamInfo_.timeOffset.microseconds();
+	header_->written = 0;
+
+	// The magic goes last, readers do not use a bus without it.
+	memcpy(header_->magic, SAMPLE_BUS_MAGIC, sizeof(header_->magic));
+	__atomic_store_n(&header_->state, SAMPLE_BUS_LIVE, __ATOMIC_RELEASE);
+
+	LOG_INFO("Publishing samples to \"" << name_ << "\": " << blocks <<
+		    " blocks of " << blockLength_ << " samples.");
+	return true;
+}
+
+
+/**
+ * Copies a block that fits a slot into the ring.
+ */
+void SampleBusBackend::publish(const SampleSpan &data, DataInfo info)
+{
+	SampleBusSlot *slot = (SampleBusSlot*)((char*)header_ + header_->headerSize +
+		(size_t)(written_ % header_->capacity) * header_->slotSize);
+
+	__atomic_store_n(&slot->sequence, 2 * written_ + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	slot->offset = info.offset;
+	slot->time = (int64_t)info.timeOffset.seconds() * 1000000 +
+		info.timeOffset.microseconds();
+	slot->format = data.format;
+	slot->length = data.length;
+
+	int sampleSize = data.sampleSize();
+	if (isPlanar(data.format)) {
+		size_t part = (size_t)data.length * (sampleSize / 2);
+		memcpy(slot->data, data.data, part);
+		memcpy(slot->data + part, data.imag, part);
+	} else if (data.isPacked()) {
+		memcpy(slot->data, data.data, (size_t)data.length * sampleSize);
+	} else {
+		const char *source = (const char*)data.data;
+		for (int i = 0; i < data.length; i++)
+			memcpy(slot->data + (size_t)i * sampleSize, source + (size_t)i * data.stride,
+				  sampleSize);
+	}
+
+	__atomic_store_n(&slot->sequence, 2 * written_ + 2, __ATOMIC_RELEASE);
+
+	written_++;
+	__atomic_store_n(&header_->written, written_, __ATOMIC_RELEASE);
+}
+
+
+void SampleBusBackend::startStream(StreamInfo info)
+{
+	Backend::startStream(info);
+
+	destroy();
+	written_ = 0;
+	failed_ = false;
+
+	if (next_.isNotNull()) next_->startStream(info);
+}
+
+
+void SampleBusBackend::process(const SampleSpan &data, DataInfo info)
+{
+	if ((header_ == NULL) && !failed_)
+		failed_ = !create(data.format);
+
+	if (header_ != NULL) {
+		int count = header_->blockBytes / data.sampleSize();
+
+		for (int i = 0; i < data.length; i += count) {
+			int n = (data.length - i < count) ? data.length - i : count;
+			DataInfo blockInfo;
+			blockInfo.offset = info.offset + i;
+			blockInfo.timeOffset = info.timeOffset.addSamples(i, streamInfo_.sampleRate);
+			publish(data.slice(i, n), blockInfo);
+		}
+	}
+
+	if (next_.isNotNull()) next_->process(data, info);
+}
+
+
+/**
+ * The ring stays mapped (with its last blocks) until the next stream.
+ */
+void SampleBusBackend::endStream()
+{
+	if (header_ != NULL)
+		__atomic_store_n(&header_->state, SAMPLE_BUS_ENDED, __ATOMIC_RELEASE);
+
+	if (next_.isNotNull()) next_->endStream();
+}
+
+
+long SampleBusBackend::getSegmentAlignment(const StreamInfo &info)
+{
+	return next_.isNotNull() ? next_->getSegmentAlignment(info) : 1;
+}
+
+
+int SampleBusBackend::getSegmentOverlap()
+{
+	return next_.isNotNull() ? next_->getSegmentOverlap() : 0;
+}
+
@@ -0,0 +1,139 @@
+/**
+ * \file   SampleBus.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SampleBusBackend class and the layout of the
+ *         shared-memory sample bus.
+ */
+
+#ifndef SAMPLEBUS_W2JD8NPK
+#define SAMPLEBUS_W2JD8NPK
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+#include "Backend.h"
+#include "SharedSegment.h"
+
+
+#define SAMPLE_BUS_MAGIC   "WFSAMPL"
+#define SAMPLE_BUS_VERSION 1
+
+/// The bus is being set up.
+#define SAMPLE_BUS_STARTING 0
+/// Blocks are being published.
+#define SAMPLE_BUS_LIVE     1
+/// The stream has ended, no more blocks will come.
+#define SAMPLE_BUS_ENDED    2
+
+
+/**
+ * \brief Header of a shared-memory sample bus, at the start of the segment.
+ */
+struct SampleBusHeader {
+	char     magic[8];
+	uint32_t version;
+	/// One of SAMPLE_BUS_STARTING, _LIVE and _ENDED.
+	uint32_t state;
+	/// Size of this header, the first slot follows.
+	uint32_t headerSize;
+	/// Number of blocks (slots) of the ring.
+	uint32_t capacity;
+	/// Size of a slot in bytes.
+	uint32_t slotSize;
+	/// Largest number of bytes of samples in a slot.
+	uint32_t blockBytes;
+	/// Sample rate of the stream in Hz.
+	int32_t  sampleRate;
+	/// Whether the stream is live (see StreamInfo::realTime).
+	int32_t  realTime;
+	/// Time of the sample at position 0 in microseconds (UNIX time).
+	int64_t  timeOffset;
+	/// Number of blocks published so far (the index of the next block).
+	uint64_t written;
+};
+
+
+/**
+ * \brief A slot of the bus, holding block \c index while \c sequence is
+ *        2 * \c index + 2 (odd while the block is being written).
+ *
+ * The samples are packed in their format; the real parts of planar formats
+ * are followed by the imaginary parts.
+ */
+struct SampleBusSlot {
+	uint64_t sequence;
+	/// Position of the first sample in the stream (DataInfo::offset).
+	int64_t  offset;
+	/// Time of the first sample in microseconds (DataInfo::timeOffset).
+	int64_t  time;
+	/// SampleFormat of the samples.
+	int32_t  format;
+	/// Number of samples.
+	int32_t  length;
+	char     data[8];
+};
+
+
+/**
+ * \brief Backend publishing the raw samples into a POSIX shared-memory ring
+ *        (a sample bus), so that other instances (see SampleBusFrontend)
+ *        can process the same capture.
+ *
+ * The blocks (split to fit the slots) are copied into the ring and passed
+ * on to the next backend, if any. Like the SharedSpectrumSink, the writer
+ * never waits for the readers: each slot is guarded by its own sequence
+ * number, a reader which falls behind by more than the ring finds its
+ * blocks overwritten.
+ *
+ * The ring is created with the first block of a stream (when the format of
+ * the samples is known) and removed when the backend is destroyed (see
+ * SharedSegment). Only one instance can publish under a name.
+ */
+class SampleBusBackend : public Backend {
+private:
+	string           name_;
+	float            length_;
+	int              blockLength_;
+	Ref<Backend>     next_;
+
+	SharedSegment    segment_;
+	SampleBusHeader *header_;
+	uint64_t         written_;
+	bool             failed_;
+
+	SampleBusBackend(const SampleBusBackend& other);
+
+	bool create(SampleFormat format);
+	void publish(const SampleSpan &data, DataInfo info);
+	void destroy();
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param name        name of the shared memory object (e.g. "/waterfall")
+	 * \param length      length of the ring in seconds of samples
+	 * \param blockLength largest number of samples in a slot
+	 * \param next        backend processing the samples in this process,
+	 *                    may be null
+	 */
+	SampleBusBackend(string       name,
+				  float        length,
+				  int          blockLength,
+				  Ref<Backend> next);
+	virtual ~SampleBusBackend();
+
+	virtual void startStream(StreamInfo info);
+	virtual void process(const SampleSpan &data, DataInfo info);
+	virtual void endStream();
+
+	virtual long getSegmentAlignment(const StreamInfo &info);
+	virtual int  getSegmentOverlap();
+};
+
+#endif /* end of include guard: SAMPLEBUS_W2JD8NPK */
+
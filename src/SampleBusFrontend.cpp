@@ -0,0 +1,283 @@
+/**
+ * \file   SampleBusFrontend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SampleBusFrontend class.
+ */
+
+#include "SampleBusFrontend.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+static double secondsBetween(const WFTime &from, const WFTime &to)
+{
+	return (to.seconds() - from.seconds()) +
+		(to.microseconds() - from.microseconds()) / 1000000.0;
+}
+
+
+/**
+ * Constructor.
+ */
+SampleBusFrontend::SampleBusFrontend(const string &name) :
+	name_(name),
+	timeout_(0),
+	reportInterval_(60),
+	pollInterval_(1000),
+	running_(false),
+	header_(NULL),
+	size_(0),
+	next_(0),
+	started_(false),
+	blockCount_(0),
+	overrunCount_(0),
+	lostSampleCount_(0),
+	maxLag_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+SampleBusFrontend::~SampleBusFrontend()
+{
+	close();
+}
+
+
+const SampleBusSlot* SampleBusFrontend::getSlot(uint64_t index) const
+{
+	return (const SampleBusSlot*)((const char*)header_ + header_->headerSize +
+		(size_t)(index % header_->capacity) * header_->slotSize);
+}
+
+
+bool SampleBusFrontend::open()
+{
+	if (header_ != NULL) return true;
+
+	int file = shm_open(name_.c_str(), O_RDONLY, 0);
+	if (file < 0) return false;
+
+	struct stat st;
+	if ((fstat(file, &st) != 0) || (st.st_size < (off_t)sizeof(SampleBusHeader))) {
+		::close(file);
+		return false;
+	}
+
+	void *memory = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if (memory == MAP_FAILED) return false;
+
+	header_ = (const SampleBusHeader*)memory;
+	size_ = st.st_size;
+
+	if ((__atomic_load_n(&header_->state, __ATOMIC_ACQUIRE) == SAMPLE_BUS_STARTING) ||
+	    (memcmp(header_->magic, SAMPLE_BUS_MAGIC, sizeof(header_->magic)) != 0) ||
+	    (header_->version != SAMPLE_BUS_VERSION) ||
+	    (header_->capacity == 0) ||
+	    (header_->headerSize + (size_t)header_->capacity * header_->slotSize > size_)) {
+		close();
+		return false;
+	}
+
+	// Readers join the stream at the newest block.
+	next_ = __atomic_load_n(&header_->written, __ATOMIC_ACQUIRE);
+	block_.resize(header_->blockBytes);
+
+	return true;
+}
+
+
+void SampleBusFrontend::close()
+{
+	if (header_ == NULL) return;
+
+	munmap((void*)header_, size_);
+	header_ = NULL;
+	size_ = 0;
+}
+
+
+void SampleBusFrontend::stop()
+{
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+}
+
+
+long SampleBusFrontend::getLag() const
+{
+	if (header_ == NULL) return 0;
+
+	uint64_t written = __atomic_load_n(&header_->written, __ATOMIC_ACQUIRE);
+	return (written > next_) ? written - next_ : 0;
+}
+
+
+/**
+ * Takes the next block from the bus and passes it to the backend.
+ *
+ * \returns \c false if there is no block to be read
+ */
+bool SampleBusFrontend::readBlock()
+{
+	uint64_t written = __atomic_load_n(&header_->written, __ATOMIC_ACQUIRE);
+	if (next_ >= written) return false;
+
+	long lag = written - next_;
+	if (lag > maxLag_) maxLag_ = lag;
+
+	// Blocks older than the ring are gone, resume with a margin.
+	if (lag > (long)header_->capacity) {
+		uint64_t resume = written - (header_->capacity - header_->capacity / 4);
+		overrunCount_ += resume - next_;
+		next_ = resume;
+	}
+
+	uint64_t index = next_++;
+	const SampleBusSlot *slot = getSlot(index);
+	uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+	if (sequence != 2 * index + 2) {
+		overrunCount_++;
+		return true;
+	}
+
+	DataInfo info;
+	info.offset = slot->offset;
+	info.timeOffset = WFTime(slot->time / 1000000, slot->time % 1000000);
+	SampleFormat format = (SampleFormat)slot->format;
+	int length = slot->length;
+	int sampleSize = getSampleSize(format);
+
+	bool valid = (sampleSize > 0) && (length >= 0) &&
+		((size_t)length * sampleSize <= block_.size());
+	if (valid) memcpy(&(block_[0]), slot->data, (size_t)length * sampleSize);
+
+	// The copy before the second check of the sequence.
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (!valid || (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != sequence)) {
+		overrunCount_++;
+		return true;
+	}
+
+	blockCount_++;
+
+	if (!started_) {
+		streamInfo_ = StreamInfo();
+		streamInfo_.sampleRate = header_->sampleRate;
+		streamInfo_.realTime = (header_->realTime != 0);
+		streamInfo_.timeOffset = WFTime(header_->timeOffset / 1000000,
+								  header_->timeOffset % 1000000);
+		streamInfo_.startOffset = info.offset;
+		startStream();
+
+		started_ = true;
+	}
+
+	if (info.offset < dataInfo_.offset) return true;
+	if (info.offset > dataInfo_.offset) {
+		long gap = info.offset - dataInfo_.offset;
+		lostSampleCount_ += gap;
+		skip(gap);
+	}
+
+	if (isPlanar(format)) {
+		process(SampleSpan(format, &(block_[0]),
+					    &(block_[(size_t)length * (sampleSize / 2)]), length));
+	} else {
+		process(SampleSpan(format, &(block_[0]), length));
+	}
+
+	return true;
+}
+
+
+/**
+ * Logs the lag behind the writer and the blocks lost since the last report.
+ */
+void SampleBusFrontend::report(long overruns)
+{
+	if (overruns > 0) {
+		LOG_WARNING("Sample bus \"" << name_ << "\": " << overruns <<
+				  " blocks overrun, lag " << getLag() << " blocks (at most " <<
+				  maxLag_ << " of " << header_->capacity << ").");
+	} else {
+		LOG_DEBUG("Sample bus \"" << name_ << "\": lag " << getLag() <<
+				" blocks (at most " << maxLag_ << " of " << header_->capacity << ").");
+	}
+}
+
+
+void SampleBusFrontend::run()
+{
+	__atomic_store_n(&running_, true, __ATOMIC_RELEASE);
+
+	WFTime lastBlock = WFTime::now();
+
+	if (!open()) {
+		LOG_INFO("Waiting for sample bus \"" << name_ << "\"...");
+
+		while (!open()) {
+			if (!__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) return;
+			if ((timeout_ > 0) && (secondsBetween(lastBlock, WFTime::now()) > timeout_)) {
+				LOG_ERROR("Sample bus \"" << name_ << "\" not found.");
+				return;
+			}
+			usleep(100000);
+		}
+	}
+
+	LOG_INFO("Reading samples from sample bus \"" << name_ << "\"...");
+
+	started_ = false;
+	lastBlock = WFTime::now();
+	WFTime lastReport = lastBlock;
+	long   reportedOverruns = 0;
+
+	while (true) {
+		bool finish = !__atomic_load_n(&running_, __ATOMIC_ACQUIRE);
+		// Checked before reading, so the blocks before the end are read.
+		bool ended = (__atomic_load_n(&header_->state, __ATOMIC_ACQUIRE) == SAMPLE_BUS_ENDED);
+
+		// At most a ring of blocks, so that the reports are not held up.
+		bool received = false;
+		for (unsigned i = 0; (i < header_->capacity) && readBlock(); i++)
+			received = true;
+
+		WFTime now = WFTime::now();
+		if (received) {
+			lastBlock = now;
+		} else if (ended) {
+			finish = true;
+		} else if ((timeout_ > 0) && (secondsBetween(lastBlock, now) > timeout_)) {
+			LOG_INFO("Sample bus \"" << name_ << "\": no blocks for " << timeout_ << " s.");
+			finish = true;
+		}
+
+		if ((reportInterval_ > 0) && (secondsBetween(lastReport, now) >= reportInterval_)) {
+			report(overrunCount_ - reportedOverruns);
+			reportedOverruns = overrunCount_;
+			lastReport = now;
+		}
+
+		if (finish) break;
+		if (!received) usleep(pollInterval_);
+	}
+
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+
+	if (started_) endStream();
+
+	LOG_INFO("Sample bus \"" << name_ << "\": " << blockCount_ << " blocks, " <<
+		    overrunCount_ << " blocks overrun, " << lostSampleCount_ <<
+		    " samples lost, lag at most " << maxLag_ << " blocks.");
+}
+
@@ -0,0 +1,106 @@
+/**
+ * \file   SampleBusFrontend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SampleBusFrontend class.
+ */
+
+#ifndef SAMPLEBUSFRONTEND_Q6TN3XHB
+#define SAMPLEBUSFRONTEND_Q6TN3XHB
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "Frontend.h"
+#include "SampleBus.h"
+
+
+/**
+ * \brief Frontend reading the samples published by another instance into a
+ *        shared-memory sample bus (see SampleBusBackend).
+ *
+ * The bus is mapped read-only and polled for new blocks. Each block is
+ * copied out of its slot and checked against its sequence number before it
+ * is passed to the backend, so a block overwritten while being copied is
+ * never processed. The publisher does not wait for its readers: blocks
+ * lost because this reader fell behind are counted as overruns and skipped
+ * (the time of the following samples stays exact). After an overrun the
+ * reader resumes three quarters of the ring behind the writer, so that it
+ * is not overrun again right away.
+ *
+ * The lag behind the writer and the overruns are reported every report
+ * interval and at the end. The stream ends when the publisher ends it, when
+ * stop() is called or when no block arrives for the configured timeout.
+ */
+class SampleBusFrontend : public Frontend {
+private:
+	string                 name_;
+	/// Seconds without blocks after which the stream ends, 0 for never.
+	float                  timeout_;
+	/// Seconds between the lag reports, 0 for none.
+	float                  reportInterval_;
+	/// Microseconds between the polls of the bus.
+	long                   pollInterval_;
+	bool                   running_;
+
+	const SampleBusHeader *header_;
+	size_t                 size_;
+	/// Index of the next block to be read.
+	uint64_t               next_;
+	bool                   started_;
+	/// Copy of the block being processed.
+	vector<char>           block_;
+
+	long                   blockCount_;
+	long                   overrunCount_;
+	long                   lostSampleCount_;
+	/// Largest lag behind the writer seen, in blocks.
+	long                   maxLag_;
+
+	SampleBusFrontend(const SampleBusFrontend& other);
+
+	const SampleBusSlot* getSlot(uint64_t index) const;
+	bool readBlock();
+	void report(long overruns);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param name name of the shared memory object (e.g. "/waterfall")
+	 */
+	SampleBusFrontend(const string &name);
+	virtual ~SampleBusFrontend();
+
+	void setTimeout(float timeout) { timeout_ = timeout; }
+	void setReportInterval(float seconds) { reportInterval_ = seconds; }
+	void setPollInterval(long microseconds) { pollInterval_ = microseconds; }
+
+	/**
+	 * \brief Maps the bus (done by run(), waiting for the publisher, if
+	 *        not called before).
+	 */
+	bool open();
+	void close();
+
+	/**
+	 * \brief Makes run() end the stream.
+	 */
+	void stop();
+
+	long getBlockCount() const { return blockCount_; }
+	long getOverrunCount() const { return overrunCount_; }
+	long getLostSampleCount() const { return lostSampleCount_; }
+	long getMaxLag() const { return maxLag_; }
+	/// Number of blocks published but not read yet.
+	long getLag() const;
+
+	virtual void run();
+};
+
+#endif /* end of include guard: SAMPLEBUSFRONTEND_Q6TN3XHB */
+
@@ -0,0 +1,262 @@
+/**
+ * \file   SampleConversion.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Conversion of the sample formats to complex doubles.
+ *
+ * The integer formats are scaled to the full scale of the floating point
+ * ones (-1 to 1), so that the spectra of all of the formats have the same
+ * units.
+ *
+ * The loops are kept simple (unit stride, no aliasing) so that the
+ * compiler can vectorize them. The conversions of 16-bit and 32-bit integers
+ * (WAV files), which the compiler doesn't vectorize well, have explicit SSE2
+ * versions.
+ */
+
+#include "SampleConversion.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/// Scale of the 16-bit integers.
+#define INT16_SCALE (1.0 / 32768.0)
+/// Scale of the 32-bit integers (and the 24-bit ones, see unpackInt24()).
+#define INT32_SCALE (1.0 / 2147483648.0)
+/// Scale of the unsigned 8-bit integers, centered at 127.5.
+#define UINT8_SCALE (1.0 / 128.0)
+
+
+/**
+ * Multiplies the samples by the window function and by \c scale (the full
+ * scale of the format).
+ */
+template<class T>
+static void windowInterleaved(const T     * __restrict src,
+						const float * __restrict window,
+						double      * __restrict dst,
+						int                      count,
+						double                   scale)
+{
+	for (int i = 0; i < count; i++) {
+		double w = window[i] * scale;
+		dst[2 * i]     = (double)src[2 * i]     * w;
+		dst[2 * i + 1] = (double)src[2 * i + 1] * w;
+	}
+}
+
+
+/**
+ * Version of windowInterleaved() for unsigned 8-bit samples, which are
+ * centered at 127.5.
+ */
+static void windowInterleavedUint8(const uint8_t * __restrict src,
+							const float   * __restrict window,
+							double        * __restrict dst,
+							int                        count)
+{
+	for (int i = 0; i < count; i++) {
+		double w = window[i] * UINT8_SCALE;
+		dst[2 * i]     = ((double)src[2 * i]     - 127.5) * w;
+		dst[2 * i + 1] = ((double)src[2 * i + 1] - 127.5) * w;
+	}
+}
+
+
+#ifdef __SSE2__
+/**
+ * SSE2 version of windowInterleaved() for 16-bit integers, converts four
+ * complex samples per iteration.
+ */
+static void windowInterleavedInt16(const int16_t * __restrict src,
+							const float   * __restrict window,
+							double        * __restrict dst,
+							int                        count)
+{
+	int i = 0;
+	
+	for (; i + 4 <= count; i += 4) {
+		// re0 im0 re1 im1 re2 im2 re3 im3
+		__m128i samples = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+		// Sign-extend to 32 bits by shifting the samples to the upper
+		// halves and back.
+		__m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+		__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+		
+		__m128d s0 = _mm_cvtepi32_pd(low);
+		__m128d s1 = _mm_cvtepi32_pd(_mm_shuffle_epi32(low, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m128d s2 = _mm_cvtepi32_pd(high);
+		__m128d s3 = _mm_cvtepi32_pd(_mm_shuffle_epi32(high, _MM_SHUFFLE(1, 0, 3, 2)));
+		
+		_mm_storeu_pd(dst + 2 * i,     _mm_mul_pd(s0, _mm_set1_pd(window[i] * INT16_SCALE)));
+		_mm_storeu_pd(dst + 2 * i + 2, _mm_mul_pd(s1, _mm_set1_pd(window[i + 1] * INT16_SCALE)));
+		_mm_storeu_pd(dst + 2 * i + 4, _mm_mul_pd(s2, _mm_set1_pd(window[i + 2] * INT16_SCALE)));
+		_mm_storeu_pd(dst + 2 * i + 6, _mm_mul_pd(s3, _mm_set1_pd(window[i + 3] * INT16_SCALE)));
+	}
+	
+	windowInterleaved(src + 2 * i, window + i, dst + 2 * i, count - i, INT16_SCALE);
+}
+
+
+/**
+ * SSE2 version of windowInterleaved() for 32-bit integers, converts two
+ * complex samples per iteration.
+ */
+static void windowInterleavedInt32(const int32_t * __restrict src,
+							const float   * __restrict window,
+							double        * __restrict dst,
+							int                        count)
+{
+	int i = 0;
+	
+	for (; i + 2 <= count; i += 2) {
+		// re0 im0 re1 im1
+		__m128i samples = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+		
+		__m128d s0 = _mm_cvtepi32_pd(samples);
+		__m128d s1 = _mm_cvtepi32_pd(_mm_shuffle_epi32(samples, _MM_SHUFFLE(1, 0, 3, 2)));
+		
+		_mm_storeu_pd(dst + 2 * i,     _mm_mul_pd(s0, _mm_set1_pd(window[i] * INT32_SCALE)));
+		_mm_storeu_pd(dst + 2 * i + 2, _mm_mul_pd(s1, _mm_set1_pd(window[i + 1] * INT32_SCALE)));
+	}
+	
+	windowInterleaved(src + 2 * i, window + i, dst + 2 * i, count - i, INT32_SCALE);
+}
+#endif
+
+
+static void interleave(const float * __restrict real,
+				   const float * __restrict imag,
+				   float       * __restrict dst,
+				   int                      count)
+{
+	for (int i = 0; i < count; i++) {
+		dst[2 * i]     = real[i];
+		dst[2 * i + 1] = imag[i];
+	}
+}
+
+
+/**
+ * Unpacks 24-bit integers to the top bytes of 32-bit ones (\c count complex
+ * samples, \c stride bytes apart), so that they have the full scale of the
+ * 32-bit integers.
+ */
+static void unpackInt24(const unsigned char * __restrict src,
+				    int32_t             * __restrict dst,
+				    int                              count,
+				    int                              stride)
+{
+	for (int i = 0; i < count; i++) {
+		const unsigned char *sample = src + (long)i * stride;
+		
+		dst[2 * i] = (int32_t)(
+			((uint32_t)sample[0] << 8) |
+			((uint32_t)sample[1] << 16) |
+			((uint32_t)sample[2] << 24)
+		);
+		dst[2 * i + 1] = (int32_t)(
+			((uint32_t)sample[3] << 8) |
+			((uint32_t)sample[4] << 16) |
+			((uint32_t)sample[5] << 24)
+		);
+	}
+}
+
+
+/**
+ * Copies \c count samples of \c size bytes which are \c stride bytes
+ * apart to a contiguous buffer.
+ */
+static void gather(const char * __restrict src,
+			    char       * __restrict dst,
+			    int                     count,
+			    int                     size,
+			    int                     stride)
+{
+	for (int i = 0; i < count; i++)
+		memcpy(dst + (long)i * size, src + (long)i * stride, size);
+}
+
+
+SampleFormat getStorageFormat(SampleFormat format)
+{
+	switch (format) {
+	case SAMPLE_PLANAR_FLOAT:  return SAMPLE_COMPLEX_FLOAT;
+	case SAMPLE_COMPLEX_INT24: return SAMPLE_COMPLEX_INT32;
+	default:                   return format;
+	}
+}
+
+
+void copySamples(const SampleSpan &src, int srcOffset, void *dst, int count)
+{
+	SampleSpan slice = src.slice(srcOffset, count);
+	
+	if (slice.format == SAMPLE_PLANAR_FLOAT) {
+		interleave((const float*)slice.data,
+				 (const float*)slice.imag,
+				 (float*)dst,
+				 count);
+	} else if (slice.format == SAMPLE_COMPLEX_INT24) {
+		unpackInt24((const unsigned char*)slice.data,
+				  (int32_t*)dst,
+				  count,
+				  slice.frameSize());
+	} else if (!slice.isPacked()) {
+		gather((const char*)slice.data,
+			  (char*)dst,
+			  count,
+			  slice.sampleSize(),
+			  slice.stride);
+	} else {
+		memcpy(dst, slice.data, (long)count * slice.sampleSize());
+	}
+}
+
+
+void windowSamples(SampleFormat  format,
+			    const void   *src,
+			    const float  *window,
+			    fftw_complex *dst,
+			    int           count)
+{
+	switch (format) {
+	case SAMPLE_COMPLEX_DOUBLE:
+		windowInterleaved((const double*)src, window, (double*)dst, count, 1.0);
+		break;
+	case SAMPLE_COMPLEX_FLOAT:
+		windowInterleaved((const float*)src, window, (double*)dst, count, 1.0);
+		break;
+	case SAMPLE_COMPLEX_INT16:
+#ifdef __SSE2__
+		windowInterleavedInt16((const int16_t*)src, window, (double*)dst, count);
+#else
+		windowInterleaved((const int16_t*)src, window, (double*)dst, count,
+						INT16_SCALE);
+#endif
+		break;
+	case SAMPLE_COMPLEX_INT32:
+#ifdef __SSE2__
+		windowInterleavedInt32((const int32_t*)src, window, (double*)dst, count);
+#else
+		windowInterleaved((const int32_t*)src, window, (double*)dst, count,
+						INT32_SCALE);
+#endif
+		break;
+	case SAMPLE_COMPLEX_UINT8:
+		windowInterleavedUint8((const uint8_t*)src, window, (double*)dst, count);
+		break;
+	default:
+		// Planar and packed 24-bit samples are converted by copySamples().
+		assert(getStorageFormat(format) == format);
+		break;
+	}
+}
+
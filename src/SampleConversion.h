@@ -0,0 +1,60 @@
+/**
+ * \file   SampleConversion.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Conversion of the sample formats to complex doubles.
+ *
+ * The samples are kept in their native format (see SampleFormat) until the
+ * windowing step of the FFT backend, where they are widened, deinterleaved
+ * and multiplied by the window function in a single pass. The integer
+ * formats are scaled to -1 to 1 (full scale) on the way, like the floating
+ * point samples are.
+ */
+
+#ifndef SAMPLECONVERSION_B7XG2NQE
+#define SAMPLECONVERSION_B7XG2NQE
+
+#include <fftw3.h>
+
+#include "Backend.h"
+
+
+/**
+ * \brief Returns the format samples of \c format are stored in by
+ *        copySamples() (planar formats are interleaved, packed 24-bit
+ *        integers are unpacked to the top of 32 bits, the rest is kept).
+ */
+SampleFormat getStorageFormat(SampleFormat format);
+
+/**
+ * \brief Copies samples to a buffer in the storage format.
+ *
+ * Samples with a stride are stored adjacent to each other.
+ *
+ * \param src       source samples
+ * \param srcOffset index of the first copied sample in \c src
+ * \param dst       destination buffer (in getStorageFormat(src.format))
+ * \param count     number of samples to copy
+ */
+void copySamples(const SampleSpan &src, int srcOffset, void *dst, int count);
+
+/**
+ * \brief Converts interleaved samples to complex doubles scaled to
+ *        -1 to 1 and multiplies them by a window function.
+ *
+ * \param format interleaved format of \c src
+ * \param src    source samples
+ * \param window window function (\c count values)
+ * \param dst    destination (\c count complex doubles)
+ * \param count  number of samples
+ */
+void windowSamples(SampleFormat  format,
+			    const void   *src,
+			    const float  *window,
+			    fftw_complex *dst,
+			    int           count);
+
+
+#endif /* end of include guard: SAMPLECONVERSION_B7XG2NQE */
+
@@ -0,0 +1,121 @@
+/**
+ * \file   SharedSegment.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SharedSegment class.
+ */
+
+#include "SharedSegment.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+
+/**
+ * Constructor.
+ */
+SharedSegment::SharedSegment() :
+	file_(-1),
+	memory_(NULL),
+	size_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+SharedSegment::~SharedSegment()
+{
+	destroy();
+}
+
+
+/**
+ * Returns whether the name still refers to the object of this instance.
+ */
+bool SharedSegment::isNamed() const
+{
+	int file = shm_open(name_.c_str(), O_RDONLY, 0);
+	if (file < 0) return false;
+
+	struct stat named, own;
+	bool same = (fstat(file, &named) == 0) && (fstat(file_, &own) == 0) &&
+		(named.st_dev == own.st_dev) && (named.st_ino == own.st_ino);
+	close(file);
+	return same;
+}
+
+
+bool SharedSegment::create(const string &name, size_t size)
+{
+	destroy();
+	name_ = name;
+
+	file_ = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+	if ((file_ < 0) && (errno == EEXIST)) {
+		// Left behind by an instance that has died if nobody holds the lock.
+		int existing = shm_open(name_.c_str(), O_RDWR, 0);
+		if ((existing >= 0) && (flock(existing, LOCK_EX | LOCK_NB) != 0)) {
+			LOG_ERROR("Shared memory \"" << name_ << "\" is used by another "
+					"instance.");
+			close(existing);
+			return false;
+		}
+		if (existing >= 0) close(existing);
+
+		LOG_WARNING("Replacing stale shared memory \"" << name_ << "\".");
+		shm_unlink(name_.c_str());
+		file_ = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	}
+
+	if (file_ < 0) {
+		LOG_ERROR("Failed to create shared memory \"" << name_ << "\": " <<
+				strerror(errno) << ".");
+		return false;
+	}
+
+	void *memory = MAP_FAILED;
+	if ((flock(file_, LOCK_EX | LOCK_NB) == 0) && (ftruncate(file_, size) == 0))
+		memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+	if (memory == MAP_FAILED) {
+		LOG_ERROR("Failed to map shared memory \"" << name_ << "\": " <<
+				strerror(errno) << ".");
+		shm_unlink(name_.c_str());
+		close(file_);
+		file_ = -1;
+		return false;
+	}
+
+	memory_ = memory;
+	size_ = size;
+	return true;
+}
+
+
+void SharedSegment::destroy()
+{
+	if (file_ < 0) return;
+
+	if (memory_ != NULL) munmap(memory_, size_);
+	memory_ = NULL;
+	size_ = 0;
+
+	// The name may have been removed (or reused) by hand in the meantime.
+	if (isNamed()) shm_unlink(name_.c_str());
+
+	close(file_);
+	file_ = -1;
+}
+
@@ -0,0 +1,60 @@
+/**
+ * \file   SharedSegment.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SharedSegment class.
+ */
+
+#ifndef SHAREDSEGMENT_V7KP3NDZ
+#define SHAREDSEGMENT_V7KP3NDZ
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+
+/**
+ * \brief POSIX shared memory object created and owned by this process, for
+ *        the rings published to other processes.
+ *
+ * The owner keeps the object open with an exclusive \c flock() on it. An
+ * object of the same name that is still locked belongs to another running
+ * instance and is left alone (create() fails); one that is not locked was
+ * left behind by an instance that has died and is replaced. destroy() only
+ * removes the name if it still refers to the object of this instance.
+ */
+class SharedSegment {
+private:
+	string  name_;
+	int     file_;
+	void   *memory_;
+	size_t  size_;
+
+	SharedSegment(const SharedSegment& other);
+
+	bool isNamed() const;
+
+public:
+	SharedSegment();
+	~SharedSegment();
+
+	/**
+	 * \brief Creates and maps (read-write) a zero-filled object of
+	 *        \c size bytes, destroying the previous one.
+	 */
+	bool create(const string &name, size_t size);
+
+	/**
+	 * \brief Unmaps the object and removes its name if it still refers to
+	 *        it.
+	 */
+	void destroy();
+
+	void*  getMemory() const { return memory_; }
+	size_t getSize() const { return size_; }
+};
+
+#endif /* end of include guard: SHAREDSEGMENT_V7KP3NDZ */
+
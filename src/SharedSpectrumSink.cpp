@@ -0,0 +1,305 @@
+/**
+ * \file   SharedSpectrumSink.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SharedSpectrumSink and
+ *         SharedSpectrumReader classes.
+ */
+
+#include "SharedSpectrumSink.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/// Slots are aligned to cache lines, so that writing a row does not touch
+/// the line of the previous one being read.
+#define SLOT_ALIGNMENT 64
+
+
+static inline SharedSpectrumSlot* getSlot(SharedSpectrumHeader *header,
+								  uint64_t index)
+{
+	return (SharedSpectrumSlot*)((char*)header + header->headerSize +
+		(size_t)(index % header->capacity) * header->slotSize);
+}
+
+
+/* SHARED SPECTRUM SINK *******************************************************/
+
+/**
+ * Constructor.
+ */
+SharedSpectrumSink::SharedSpectrumSink(string name,
+							    string origin,
+							    float  length,
+							    float  leftFrequency,
+							    float  rightFrequency) :
+	SpectrumSink(),
+	name_(name),
+	origin_(origin),
+	length_(length),
+	leftFrequency_((leftFrequency < rightFrequency) ? leftFrequency : rightFrequency),
+	rightFrequency_((leftFrequency > rightFrequency) ? leftFrequency : rightFrequency),
+	fullBand_(leftFrequency == rightFrequency),
+	leftBin_(0),
+	rightBin_(0),
+	header_(NULL),
+	written_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+SharedSpectrumSink::~SharedSpectrumSink()
+{
+	destroy();
+}
+
+
+void SharedSpectrumSink::destroy()
+{
+	if (header_ != NULL)
+		__atomic_store_n(&header_->state, SHARED_SPECTRUM_ENDED, __ATOMIC_RELEASE);
+	header_ = NULL;
+	segment_.destroy();
+}
+
+
+/**
+ * Creates the ring of the stream. The segment of the previous stream is
+ * replaced, the readers still mapping it see it ended.
+ */
+void SharedSpectrumSink::startStream(const SpectrumInfo &info)
+{
+	SpectrumSink::startStream(info);
+
+	destroy();
+	written_ = 0;
+
+	if (fullBand_) {
+		leftBin_  = 0;
+		rightBin_ = info.bins;
+	} else {
+		leftBin_  = info.frequencyToBin(leftFrequency_);
+		rightBin_ = info.frequencyToBin(rightFrequency_);
+		if (rightBin_ <= leftBin_) rightBin_ = leftBin_ + 1;
+	}
+
+	int    bins = rightBin_ - leftBin_;
+	long   capacity = (long)ceil(length_ * info.fftSampleRate);
+	if (capacity < 2) capacity = 2;
+	size_t headerSize = (sizeof(SharedSpectrumHeader) + SLOT_ALIGNMENT - 1) /
+		SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+	size_t slotSize = (offsetof(SharedSpectrumSlot, values) + bins * sizeof(float) +
+				    SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+	size_t size = headerSize + capacity * slotSize;
+
+	// A new object, so that no reader is left with a segment that
+	// changes its size under it.
+	if (!segment_.create(name_, size)) return;
+	header_ = (SharedSpectrumHeader*)segment_.getMemory();
+
+	header_->version = SHARED_SPECTRUM_VERSION;
+	header_->headerSize = headerSize;
+	header_->bins = bins;
+	header_->capacity = capacity;
+	header_->slotSize = slotSize;
+	header_->leftFrequency = info.binToFrequency(leftBin_);
+	header_->binFrequency = info.binToFrequency(leftBin_ + 1) - header_->leftFrequency;
+	header_->rowSeconds = 1.0 / info.fftSampleRate;
+	header_->written = 0;
+	strncpy(header_->origin, origin_.c_str(), sizeof(header_->origin) - 1);
+
+	// The magic goes last, readers do not use a ring without it.
+	memcpy(header_->magic, SHARED_SPECTRUM_MAGIC, sizeof(header_->magic));
+	__atomic_store_n(&header_->state, SHARED_SPECTRUM_LIVE, __ATOMIC_RELEASE);
+
+	LOG_DEBUG("Shared spectrum \"" << name_ << "\": " << capacity << " rows of " <<
+			bins << " bins.");
+}
+
+
+/**
+ * Publishes a row. The sequence of the slot is odd while the row is being
+ * written, readers check it before and after reading the row.
+ */
+void SharedSpectrumSink::processRow(const float *row, DataInfo info)
+{
+	if (header_ == NULL) return;
+
+	SharedSpectrumSlot *slot = getSlot(header_, written_);
+
+	__atomic_store_n(&slot->sequence, 2 * written_ + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	slot->frame = info.offset;
+	slot->time = (int64_t)info.timeOffset.seconds() * 1000000 +
+		info.timeOffset.microseconds();
+	memcpy(slot->values, row + leftBin_, header_->bins * sizeof(float));
+
+	__atomic_store_n(&slot->sequence, 2 * written_ + 2, __ATOMIC_RELEASE);
+
+	written_++;
+	__atomic_store_n(&header_->written, written_, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * The ring stays mapped (with its last rows) until the next stream.
+ */
+void SharedSpectrumSink::endStream()
+{
+	if (header_ != NULL)
+		__atomic_store_n(&header_->state, SHARED_SPECTRUM_ENDED, __ATOMIC_RELEASE);
+
+	SpectrumSink::endStream();
+}
+
+
+/* SHARED SPECTRUM READER *****************************************************/
+
+/**
+ * Constructor.
+ */
+SharedSpectrumReader::SharedSpectrumReader() :
+	header_(NULL),
+	size_(0),
+	next_(0),
+	overruns_(0)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+SharedSpectrumReader::~SharedSpectrumReader()
+{
+	close();
+}
+
+
+const SharedSpectrumSlot* SharedSpectrumReader::getSlot(uint64_t index) const
+{
+	return ::getSlot((SharedSpectrumHeader*)header_, index);
+}
+
+
+bool SharedSpectrumReader::open(const string &name, bool oldest)
+{
+	close();
+
+	int file = shm_open(name.c_str(), O_RDONLY, 0);
+	if (file < 0) return false;
+
+	struct stat st;
+	if ((fstat(file, &st) != 0) || (st.st_size < (off_t)sizeof(SharedSpectrumHeader))) {
+		::close(file);
+		return false;
+	}
+
+	void *memory = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if (memory == MAP_FAILED) return false;
+
+	header_ = (const SharedSpectrumHeader*)memory;
+	size_ = st.st_size;
+
+	if ((__atomic_load_n(&header_->state, __ATOMIC_ACQUIRE) == SHARED_SPECTRUM_STARTING) ||
+	    (memcmp(header_->magic, SHARED_SPECTRUM_MAGIC, sizeof(header_->magic)) != 0) ||
+	    (header_->version != SHARED_SPECTRUM_VERSION) ||
+	    (header_->capacity == 0) ||
+	    (header_->headerSize + (size_t)header_->capacity * header_->slotSize > size_)) {
+		close();
+		return false;
+	}
+
+	uint64_t written = __atomic_load_n(&header_->written, __ATOMIC_ACQUIRE);
+	if (!oldest)
+		next_ = written;
+	else
+		next_ = (written > header_->capacity) ? written - header_->capacity : 0;
+	overruns_ = 0;
+
+	return true;
+}
+
+
+void SharedSpectrumReader::close()
+{
+	if (header_ == NULL) return;
+
+	munmap((void*)header_, size_);
+	header_ = NULL;
+	size_ = 0;
+}
+
+
+bool SharedSpectrumReader::isEnded() const
+{
+	return __atomic_load_n(&header_->state, __ATOMIC_ACQUIRE) == SHARED_SPECTRUM_ENDED;
+}
+
+
+bool SharedSpectrumReader::acquire(SharedSpectrumRow *row)
+{
+	uint64_t written = __atomic_load_n(&header_->written, __ATOMIC_ACQUIRE);
+
+	while (next_ < written) {
+		// Rows older than the ring are gone.
+		if (written - next_ > header_->capacity) {
+			overruns_ += written - header_->capacity - next_;
+			next_ = written - header_->capacity;
+		}
+
+		const SharedSpectrumSlot *slot = getSlot(next_);
+		uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+		if (sequence == 2 * next_ + 2) {
+			row->index = next_;
+			row->frame = slot->frame;
+			row->time = slot->time;
+			row->values = slot->values;
+			next_++;
+			return true;
+		}
+
+		// The writer has moved on to the slot in the meantime.
+		overruns_++;
+		next_++;
+	}
+
+	return false;
+}
+
+
+bool SharedSpectrumReader::release(const SharedSpectrumRow &row)
+{
+	// The reads of the row before the second check of the sequence.
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	const SharedSpectrumSlot *slot = getSlot(row.index);
+	if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == 2 * row.index + 2)
+		return true;
+
+	overruns_++;
+	return false;
+}
+
+
+uint64_t SharedSpectrumReader::getLag() const
+{
+	uint64_t written = __atomic_load_n(&header_->written, __ATOMIC_ACQUIRE);
+	return (written > next_) ? written - next_ : 0;
+}
+
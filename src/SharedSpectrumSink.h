@@ -0,0 +1,202 @@
+/**
+ * \file   SharedSpectrumSink.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SharedSpectrumSink and SharedSpectrumReader
+ *         classes.
+ */
+
+#ifndef SHAREDSPECTRUMSINK_N4RB7TWE
+#define SHAREDSPECTRUMSINK_N4RB7TWE
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+#include "SpectrumSink.h"
+#include "SharedSegment.h"
+
+
+#define SHARED_SPECTRUM_MAGIC   "WFSPECT"
+#define SHARED_SPECTRUM_VERSION 1
+
+/// The ring is being set up.
+#define SHARED_SPECTRUM_STARTING 0
+/// Rows are being published.
+#define SHARED_SPECTRUM_LIVE     1
+/// The stream has ended, no more rows will come.
+#define SHARED_SPECTRUM_ENDED    2
+
+
+/**
+ * \brief Header of a shared-memory spectrum ring, at the start of the
+ *        segment.
+ */
+struct SharedSpectrumHeader {
+	char     magic[8];
+	uint32_t version;
+	/// One of SHARED_SPECTRUM_STARTING, _LIVE and _ENDED.
+	uint32_t state;
+	/// Size of this header, the first slot follows.
+	uint32_t headerSize;
+	/// Number of values of a row.
+	uint32_t bins;
+	/// Number of rows (slots) of the ring.
+	uint32_t capacity;
+	/// Size of a slot in bytes.
+	uint32_t slotSize;
+	/// Frequency of the first value of a row in Hz.
+	double   leftFrequency;
+	/// Frequency difference between two values in Hz.
+	double   binFrequency;
+	/// Time between two rows in seconds.
+	double   rowSeconds;
+	/// Number of rows published so far (the index of the next row).
+	uint64_t written;
+	char     origin[64];
+};
+
+
+/**
+ * \brief A slot of the ring, holding row \c index while \c sequence is
+ *        2 * \c index + 2 (odd while the row is being written).
+ */
+struct SharedSpectrumSlot {
+	uint64_t sequence;
+	/// Position of the row in the stream (the FFT frame number).
+	int64_t  frame;
+	/// Time of the row in microseconds (UNIX time).
+	int64_t  time;
+	uint64_t reserved;
+	/// \c bins values follow.
+	float    values[1];
+};
+
+
+/**
+ * \brief Sink publishing the rows (cropped to the band) into a POSIX
+ *        shared-memory ring for local viewers and analysis processes.
+ *
+ * Any number of processes can map the ring read-only (see
+ * SharedSpectrumReader) and follow it. The writer never waits for them:
+ * each slot is guarded by its own sequence number (a seqlock), so a reader
+ * which falls behind by more than the ring finds its rows overwritten and
+ * skips them.
+ *
+ * The segment is created anew for each stream and removed when the sink is
+ * destroyed (see SharedSegment). Only one instance can publish under a
+ * name, the sink is meant for live streams only.
+ */
+class SharedSpectrumSink : public SpectrumSink {
+private:
+	string                name_;
+	string                origin_;
+	float                 length_;
+
+	float                 leftFrequency_;
+	float                 rightFrequency_;
+	bool                  fullBand_;
+	int                   leftBin_;
+	int                   rightBin_;
+
+	SharedSegment         segment_;
+	SharedSpectrumHeader *header_;
+	uint64_t              written_;
+
+	SharedSpectrumSink(const SharedSpectrumSink& other);
+
+	void destroy();
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param name   name of the shared memory object (e.g. "/waterfall")
+	 * \param length length of the ring in seconds of rows
+	 */
+	SharedSpectrumSink(string name,
+				    string origin,
+				    float  length,
+				    float  leftFrequency,
+				    float  rightFrequency);
+	virtual ~SharedSpectrumSink();
+
+	virtual void startStream(const SpectrumInfo &info);
+	virtual void processRow(const float *row, DataInfo info);
+	virtual void endStream();
+};
+
+
+/**
+ * \brief A row of a shared spectrum ring.
+ */
+struct SharedSpectrumRow {
+	/// Index of the row in the ring.
+	uint64_t     index;
+	int64_t      frame;
+	int64_t      time;
+	/// Values in the shared memory (not copied).
+	const float *values;
+};
+
+
+/**
+ * \brief Follows a shared spectrum ring (see SharedSpectrumSink) from
+ *        another process.
+ *
+ * The rows are read in place: acquire() returns the next row and release()
+ * tells whether the writer has overwritten it in the meantime (then the
+ * values may be mixed with a newer row and must be discarded).
+ */
+class SharedSpectrumReader {
+private:
+	const SharedSpectrumHeader *header_;
+	size_t                      size_;
+	/// Index of the next row to be read.
+	uint64_t                    next_;
+	/// Rows overwritten before they were read.
+	uint64_t                    overruns_;
+
+	SharedSpectrumReader(const SharedSpectrumReader& other);
+
+	const SharedSpectrumSlot* getSlot(uint64_t index) const;
+
+public:
+	SharedSpectrumReader();
+	~SharedSpectrumReader();
+
+	/**
+	 * \brief Maps a ring read-only.
+	 *
+	 * \param oldest start at the oldest row in the ring instead of the
+	 *               next one to be written
+	 */
+	bool open(const string &name, bool oldest = false);
+	void close();
+
+	bool isOpen() const { return header_ != NULL; }
+	const SharedSpectrumHeader* getHeader() const { return header_; }
+	/// Whether the stream has ended (the ring has to be opened again).
+	bool isEnded() const;
+
+	/**
+	 * \brief Returns the next row if there is one, skipping rows that have
+	 *        been overwritten.
+	 */
+	bool acquire(SharedSpectrumRow *row);
+
+	/**
+	 * \brief Returns whether \c row is still intact (it was not overwritten
+	 *        since acquire()), counts it as an overrun if not.
+	 */
+	bool release(const SharedSpectrumRow &row);
+
+	/// Number of rows published but not read yet.
+	uint64_t getLag() const;
+	uint64_t getOverruns() const { return overruns_; }
+};
+
+#endif /* end of include guard: SHAREDSPECTRUMSINK_N4RB7TWE */
+
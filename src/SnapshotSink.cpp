@@ -0,0 +1,303 @@
+/**
+ * \file   SnapshotSink.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SnapshotSink class.
+ */
+
+#include "SnapshotSink.h"
+#include "Clock.h"
+#include "Metrics.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+
+#include <cppapp/Logger.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+
+void SnapshotSink::writeHeader(fitsfile   *file,
+						 const char *keyword,
+						 int         type,
+						 void       *value,
+						 const char *comment,
+						 int        *status)
+{
+	fits_write_key(file, type, keyword, value, comment, status);
+}
+
+
+void SnapshotSink::writeHeader(fitsfile   *file,
+						 const char *keyword,
+						 const char *value,
+						 const char *comment,
+						 int        *status)
+{
+	char valueBuffer[FLEN_VALUE];
+	strcpy(valueBuffer, value);
+	writeHeader(file, keyword, TSTRING, (void*)valueBuffer, comment, status);
+}
+
+
+void SnapshotSink::writeHeader(fitsfile   *file,
+						 const char *keyword,
+						 float       value,
+						 const char *comment,
+						 int        *status)
+{
+	writeHeader(file, keyword, TFLOAT, (void*)&value, comment, status);
+}
+
+
+void SnapshotSink::writeHeader(fitsfile   *file,
+						 const char *keyword,
+						 int         value,
+						 const char *comment,
+						 int        *status)
+{
+	writeHeader(file, keyword, TINT, (void*)&value, comment, status);
+}
+
+
+/**
+ * Returns the number of rows of a snapshot (the size of the buffer).
+ */
+int SnapshotSink::getSnapshotRows(const SpectrumInfo &info) const
+{
+	int rows = (int)ceil(snapshotLength_ * info.fftSampleRate);
+	return (rows < 1) ? 1 : rows;
+}
+
+
+void SnapshotSink::makeSnapshot()
+{
+	PerfScope    perf(PERF_WRITE);
+	LatencyTimer timer(LATENCY_FITS_WRITE);
+	TraceScope   trace(TRACE_SNAPSHOT_WRITE);
+	WFTime time = buffer_.times[0];
+
+	char *fileName = new char[1024];
+	snprintf(fileName, 1024, "!%s%ssnapshot_%s_%s.fits",
+		    directory_.c_str(),
+		    (directory_.empty() || (directory_[directory_.size() - 1] == '/')) ? "" : "/",
+		    origin_.c_str(),
+		    time.format("%Y_%m_%d_%H_%M_%S").c_str());
+
+	int status = 0;
+	fitsfile *fptr;
+
+	LOG_INFO("Writing snapshot \"" << (fileName + 1) << "\"...");
+
+	fits_create_file(&fptr, fileName, &status);
+	if (status) {
+		cerr << "ERROR: Failed to create FITS file (code: " << status << ")." << endl;
+		delete [] fileName;
+		return;
+	}
+
+	int width = buffer_.bins;
+	long dimensions[2] = { width, buffer_.mark };
+	fits_create_img(fptr, FLOAT_IMG, 2, dimensions, &status);
+	if (status) {
+		cerr << "ERROR: Failed to create primary HDU in FITS file (code: " <<
+			status << ")." << endl;
+	}
+
+	writeHeader(fptr, "ORIGIN", origin_.c_str(), "", &status);
+	fits_write_date(fptr, &status);
+	fits_write_comment(fptr, Clock::getDefault()->now().format("Local time: %Y-%m-%d %H:%M:%S %Z", true).c_str(), &status);
+	writeHeader(fptr, "DATE-OBS", time.format("%Y-%m-%dT%H:%M:%S").c_str(), "observation date (UTC)", &status);
+
+	writeHeader(fptr, "CTYPE2", "TIME",                            "in seconds", &status);
+	writeHeader(fptr, "CRPIX2", 1,                                 "",           &status);
+	writeHeader(fptr, "CRVAL2", (float)time.seconds(),             "",           &status);
+	writeHeader(fptr, "CDELT2", 1.f / (float)info_.fftSampleRate,  "",           &status);
+
+	writeHeader(fptr, "CTYPE1", "FREQ",                            "in Hz", &status);
+	writeHeader(fptr, "CRPIX1", 1.f,                               "",      &status);
+	writeHeader(fptr, "CRVAL1", (float)leftFrequency_,             "",      &status);
+	writeHeader(fptr, "CDELT1", (float)info_.binToFrequency(),     "",      &status);
+
+	fits_write_comment(fptr, "Pixels: FFT magnitudes of the windowed samples, scaled to -1 to 1 (full scale).", &status);
+
+	if (status) {
+		cerr << "ERROR: Error occured while writing FITS file header (code: " <<
+			status << ")." << endl;
+	}
+
+	long fpixel[2] = { 1, 1 };
+	for (int y = 0; y < buffer_.mark; y++) {
+		fits_write_pix(fptr,
+					TFLOAT,
+					fpixel,
+					width,
+					(void*)buffer_.getRow(y),
+					&status);
+		fpixel[1]++;
+		if (status) break;
+	}
+
+	if (status) {
+		cerr << "ERROR: Error occured while writing data to FITS file (code: " <<
+			status << ")." << endl;
+	}
+
+	fits_close_file(fptr, &status);
+	if (status) {
+		cerr << "ERROR: Failed to close FITS file (code: " << status << ")." << endl;
+	}
+
+	if (renderPNG_) renderSnapshot(fileName + 1);
+
+	delete [] fileName;
+
+	Metrics::count(METRIC_SNAPSHOTS);
+	LOG_DEBUG("Finished writing snapshot.");
+}
+
+
+/**
+ * Renders the snapshot in the buffer into \c FILE.png, with the same axes
+ * as the FITS file (but the exact time of the first row).
+ */
+void SnapshotSink::renderSnapshot(const string &fileName)
+{
+	WFTime time = buffer_.times[0];
+
+	Spectrogram spectrogram;
+	spectrogram.width = buffer_.bins;
+	spectrogram.height = buffer_.mark;
+	spectrogram.data = buffer_.getRow(0);
+	spectrogram.axes[0] = SpectrogramAxis(1, leftFrequency_, info_.binToFrequency(),
+								   buffer_.bins, "FREQ");
+	spectrogram.axes[1] = SpectrogramAxis(
+		1,
+		(double)time.seconds() + (double)time.microseconds() / US_IN_SECOND,
+		1.0 / info_.fftSampleRate,
+		buffer_.mark,
+		"TIME"
+	);
+	spectrogram.origin = origin_;
+	spectrogram.date = Clock::getDefault()->now().format("%Y-%m-%dT%H:%M:%S");
+	spectrogram.observationDate = time.format("%Y-%m-%dT%H:%M:%S");
+
+	PNGImage image;
+	renderer_.render(spectrogram, &image);
+
+	string imageName = fileName + ".png";
+	if (!image.write(imageName))
+		LOG_ERROR("Failed to write \"" << imageName << "\".");
+}
+
+
+SnapshotSink::SnapshotSink(string origin,
+					  float  snapshotLength,
+					  float  leftFrequency,
+					  float  rightFrequency,
+					  string directory) :
+	SpectrumSink(),
+	origin_(origin),
+	directory_(directory),
+	snapshotLength_(snapshotLength),
+	buffer_(),
+	leftFrequency_((leftFrequency < rightFrequency) ? leftFrequency : rightFrequency),
+	rightFrequency_((leftFrequency > rightFrequency) ? leftFrequency : rightFrequency),
+	fullBand_(leftFrequency == rightFrequency),
+	leftBin_(0),
+	rightBin_(0),
+	renderPNG_(false),
+	renderer_()
+{
+}
+
+
+SnapshotSink::~SnapshotSink()
+{
+}
+
+
+/**
+ *
+ */
+void SnapshotSink::startStream(const SpectrumInfo &info)
+{
+	SpectrumSink::startStream(info);
+
+	int bufferSize = getSnapshotRows(info);
+	if (snapshotLength_ * info.fftSampleRate < 1) {
+		LOG_WARNING("Snapshot sink: buffer size too small, using buffer size = " << bufferSize);
+	}
+	float realLength = (float)bufferSize / info.fftSampleRate;
+	LOG_DEBUG("Snapshot sink: snapshot length = " << snapshotLength_ << "s" <<
+			", FFT sample rate = " << info.fftSampleRate << "Hz" <<
+			", buffer size (length * sample rate) = " << bufferSize << " samples" <<
+			", real snapshot length = " << realLength << "s");
+
+	if (fullBand_) {
+		leftFrequency_ = -(float)info.stream.sampleRate;
+		rightFrequency_ = (float)info.stream.sampleRate;
+		leftBin_  = 0;
+		rightBin_ = info.bins;
+	} else {
+		leftBin_  = info.frequencyToBin(leftFrequency_);
+		rightBin_ = info.frequencyToBin(rightFrequency_);
+		if (rightBin_ <= leftBin_) rightBin_ = leftBin_ + 1;
+	}
+
+	buffer_.resize(bufferSize, rightBin_ - leftBin_);
+}
+
+
+/**
+ *
+ */
+void SnapshotSink::processRow(const float *row, DataInfo info)
+{
+	// Rows dropped by the sink worker or lost by the frontend leave gaps:
+	// they are left blank inside a snapshot, and a row past the end of the
+	// snapshot starts a new one, so the time of each row is that of the
+	// header (CRVAL2 + n CDELT2).
+	float *bufferRow = buffer_.placeRow(info.offset, info.timeOffset,
+								 info_.fftSampleRate);
+	if (bufferRow == NULL) {
+		makeSnapshot();
+		buffer_.rewind();
+		bufferRow = buffer_.placeRow(info.offset, info.timeOffset,
+								info_.fftSampleRate);
+	}
+	memcpy(bufferRow, row + leftBin_, buffer_.bins * sizeof(float));
+
+	if (buffer_.isFull()) {
+		makeSnapshot();
+		buffer_.rewind();
+	}
+}
+
+
+/**
+ * Segments start at the start of a snapshot, so the snapshots are the same
+ * as if the stream was processed at once.
+ */
+int SnapshotSink::getRowAlignment(const SpectrumInfo &info)
+{
+	return getSnapshotRows(info);
+}
+
+
+/**
+ *
+ */
+void SnapshotSink::endStream()
+{
+	if (buffer_.mark > 0) {
+		makeSnapshot();
+		buffer_.rewind();
+	}
+
+	SpectrumSink::endStream();
+}
+
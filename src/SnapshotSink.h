@@ -0,0 +1,110 @@
+/**
+ * \file   SnapshotSink.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SnapshotSink class.
+ */
+
+#ifndef SNAPSHOTSINK_K5TD0QXB
+#define SNAPSHOTSINK_K5TD0QXB
+
+#include <string>
+
+using namespace std;
+
+#include <fitsio.h>
+
+#include "SpectrogramRenderer.h"
+#include "SpectrumSink.h"
+#include "WaterfallBackend.h"
+
+
+/**
+ * \brief Sink writing the spectra into a series of FITS files (snapshots)
+ *        of configured length.
+ *
+ * There is a single buffer: a full one is written out synchronously by the
+ * sink thread (see LATENCY_FITS_WRITE) and then reused, the rows queued
+ * meanwhile wait in the queue of the sink.
+ */
+class SnapshotSink : public SpectrumSink {
+private:
+	SnapshotSink(const SnapshotSink& other);
+
+	string           origin_;
+	/// Directory the snapshots are written to, empty for the working
+	/// directory.
+	string           directory_;
+
+	/// Snapshot length in seconds (determines the size of the buffer).
+	float            snapshotLength_;
+
+	/// Rows of the current snapshot, cropped to the snapshot band.
+	WaterfallBuffer  buffer_;
+
+	float            leftFrequency_;
+	float            rightFrequency_;
+	/// Whether the snapshots contain the whole spectrum (no band was set).
+	bool             fullBand_;
+	int              leftBin_;
+	int              rightBin_;
+
+	/// Whether a PNG image is rendered with each snapshot.
+	bool             renderPNG_;
+	SpectrogramRenderer renderer_;
+
+	void writeHeader(fitsfile   *file,
+				  const char *keyword,
+				  int         type,
+				  void       *value,
+				  const char *comment,
+				  int        *status);
+	void writeHeader(fitsfile   *file,
+				  const char *keyword,
+				  const char *value,
+				  const char *comment,
+				  int        *status);
+	void writeHeader(fitsfile   *file,
+				  const char *keyword,
+				  float       value,
+				  const char *comment,
+				  int        *status);
+	void writeHeader(fitsfile   *file,
+				  const char *keyword,
+				  int         value,
+				  const char *comment,
+				  int        *status);
+
+	int  getSnapshotRows(const SpectrumInfo &info) const;
+	void makeSnapshot();
+	void renderSnapshot(const string &fileName);
+
+public:
+	SnapshotSink(string origin,
+			   float  snapshotLength,
+			   float  leftFrequency,
+			   float  rightFrequency,
+			   string directory = "");
+	virtual ~SnapshotSink();
+
+	/**
+	 * \brief Renders a PNG image (\c FILE.png) of each snapshot from the
+	 *        buffer, right after the snapshot is written.
+	 */
+	void setRenderer(const SpectrogramRenderer &renderer)
+	{
+		renderer_ = renderer;
+		renderPNG_ = true;
+	}
+
+	virtual void startStream(const SpectrumInfo &info);
+	virtual void processRow(const float *row, DataInfo info);
+	virtual void endStream();
+	
+	virtual int getRowAlignment(const SpectrumInfo &info);
+};
+
+
+#endif /* end of include guard: SNAPSHOTSINK_K5TD0QXB */
+
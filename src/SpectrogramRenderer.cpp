@@ -0,0 +1,415 @@
+/**
+ * \file   SpectrogramRenderer.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SpectrogramRenderer class.
+ */
+
+#include "SpectrogramRenderer.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <pthread.h>
+#include <strings.h>
+
+
+#define FOREGROUND 255
+#define BACKGROUND 0
+
+
+bool SpectrogramAxis::isTime() const
+{
+	return strcasecmp(type.c_str(), "TIME") == 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOGARITHM TABLE
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * Natural logarithm by the upper 16 bits of a float (the sign, the exponent
+ * and 7 bits of the mantissa): the logarithm of a value within 0.4 % of the
+ * argument, i.e. off by less than 0.004.
+ */
+static float          logTable[65536];
+static pthread_once_t logTableOnce = PTHREAD_ONCE_INIT;
+
+
+static inline uint32_t floatToBits(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+
+static inline float bitsToFloat(uint32_t bits)
+{
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+
+static void createLogTable()
+{
+	for (uint32_t key = 0; key < 65536; key++) {
+		uint32_t bits = key << 16;
+		uint32_t exponent = (key >> 7) & 0xff;
+
+		// The middle of the range of the key, except for zero, the
+		// infinity and NaN.
+		if ((exponent != 0) && (exponent != 0xff)) bits |= 0x8000;
+
+		logTable[key] = (float)log((double)bitsToFloat(bits));
+	}
+}
+
+
+static inline bool isFinite(float value)
+{
+	return (value >= -FLT_MAX) && (value <= FLT_MAX);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// AXIS LAYOUT
+////////////////////////////////////////////////////////////////////////////////
+
+
+struct AxisTick {
+	int    position;
+	string text;
+
+	AxisTick(int position, const string &text) : position(position), text(text) {}
+};
+
+
+static string formatTick(const SpectrogramAxis &axis, double logical)
+{
+	char text[64];
+
+	if (axis.isTime()) {
+		time_t seconds = (time_t)floor(logical);
+		struct tm tm;
+		gmtime_r(&seconds, &tm);
+		strftime(text, sizeof(text), "%H:%M:%S", &tm);
+	} else {
+		snprintf(text, sizeof(text), "%ld", (long)logical);
+	}
+
+	return text;
+}
+
+
+/**
+ * Returns the ticks of an axis \c length pixels long, \c step logical units
+ * apart, and the size of the largest of the labels.
+ */
+static void getTicks(const SpectrogramAxis &axis, int length, double step,
+				 vector<AxisTick> *ticks, int *maxWidth, int *maxHeight)
+{
+	ticks->clear();
+	*maxWidth = 0;
+	*maxHeight = 0;
+
+	if ((axis.delta == 0) || !isFinite(axis.delta)) return;
+
+	int    physical = 0;
+	double logical = axis.toLogical(physical);
+
+	while ((physical < length) && ((int)ticks->size() < length)) {
+		string text = formatTick(axis, logical);
+
+		int width = PNGImage::getTextWidth(text);
+		if (width > *maxWidth) *maxWidth = width;
+		*maxHeight = PNGImage::getTextHeight();
+
+		ticks->push_back(AxisTick(physical, text));
+
+		logical += step;
+		int next = axis.toPhysical(logical);
+		if (next <= physical) break;
+		physical = next;
+	}
+}
+
+
+/**
+ * \brief Layout of an axis: the step of the ticks (the smallest of 1, 2, 10,
+ *        20, 100... which leaves more than 20 pixels and more than the size
+ *        of a label between the ticks) and the size of the axis.
+ */
+struct AxisLayout {
+	double           step;
+	vector<AxisTick> ticks;
+	int              margin;
+	int              ticksSize;
+	int              width;
+	int              height;
+
+	AxisLayout(const SpectrogramAxis &axis, int length, bool vertical)
+	{
+		double direction = (axis.toPhysicalLength(1.0) < 0.0) ? -1.0 : 1.0;
+		int maxWidth, maxHeight;
+
+		step = direction;
+		for (int i = 0; i < 10; i++) {
+			if (fits(axis, length, vertical, direction * pow(10.0, i))) break;
+			if (fits(axis, length, vertical, direction * pow(10.0, i) * 2)) break;
+		}
+
+		getTicks(axis, length, step, &ticks, &maxWidth, &maxHeight);
+
+		margin = (int)(maxHeight * 0.3);
+		ticksSize = (vertical ? maxWidth : maxHeight) + margin;
+
+		int labelWidth = 0, labelHeight = 0;
+		if (!axis.type.empty()) {
+			labelWidth = PNGImage::getTextWidth(getLabel(axis, vertical));
+			labelHeight = PNGImage::getTextHeight();
+		}
+
+		if (vertical) {
+			width = ticksSize + labelWidth + margin;
+			height = length;
+		} else {
+			width = length;
+			height = ticksSize + labelHeight + margin;
+		}
+	}
+
+	bool fits(const SpectrogramAxis &axis, int length, bool vertical, double candidate)
+	{
+		int maxWidth, maxHeight;
+
+		step = candidate;
+		getTicks(axis, length, step, &ticks, &maxWidth, &maxHeight);
+
+		double physical = axis.toPhysicalLength(step);
+		return (physical > 20) && (physical > (vertical ? maxHeight : maxWidth));
+	}
+
+	static string getLabel(const SpectrogramAxis &axis, bool vertical)
+	{
+		return vertical ? " " + axis.type : axis.type;
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SPECTROGRAM RENDERER
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * Constructor.
+ */
+SpectrogramRenderer::SpectrogramRenderer() :
+	scale_(SCALE_LOG),
+	colormap_(COLORMAP_GRAY),
+	min_(0),
+	max_(0),
+	hasMin_(false),
+	hasMax_(false),
+	width_(0)
+{
+	pthread_once(&logTableOnce, createLogTable);
+}
+
+
+inline float SpectrogramRenderer::transform(float value) const
+{
+	if (scale_ == SCALE_LOG) return logTable[floatToBits(value) >> 16];
+	return value;
+}
+
+
+void SpectrogramRenderer::renderData(const Spectrogram &spectrogram, PNGImage *result) const
+{
+	int  width = spectrogram.width;
+	int  height = spectrogram.height;
+	long size = (long)width * height;
+
+	result->resize(width, height);
+	if (size == 0) return;
+
+	// The logarithm is looked up once, the identity is used in place.
+	const float  *values = spectrogram.data;
+	vector<float> scaled;
+	if (scale_ != SCALE_IDENTITY) {
+		scaled.resize(size);
+		for (long i = 0; i < size; i++)
+			scaled[i] = transform(spectrogram.data[i]);
+		values = &(scaled[0]);
+	}
+
+	float minimum = FLT_MAX;
+	float maximum = -FLT_MAX;
+	for (long i = 0; i < size; i++) {
+		float value = values[i];
+		if (!isFinite(value)) continue;
+		if (value < minimum) minimum = value;
+		if (value > maximum) maximum = value;
+	}
+
+	if (hasMin_ && isFinite(transform((float)min_))) minimum = transform((float)min_);
+	if (hasMax_ && isFinite(transform((float)max_))) maximum = transform((float)max_);
+
+	float factor = (maximum > minimum) ? 255.0f / (maximum - minimum) : 0.0f;
+
+	for (int y = 0; y < height; y++) {
+		const float *row = values + (long)y * width;
+		uint8_t *levels = result->getRow(y);
+
+		// Written so that it is vectorized: NaN ends up as 0, the
+		// levels are truncated (as by numpy).
+		for (int x = 0; x < width; x++) {
+			float level = (row[x] - minimum) * factor;
+			level = (level >= 0.0f) ? level : 0.0f;
+			level = (level <= 255.0f) ? level : 255.0f;
+			levels[x] = (uint8_t)level;
+		}
+	}
+
+	if (colormap_ == COLORMAP_HOT) {
+		uint8_t palette[3 * 256];
+		for (int i = 0; i < 256; i++) {
+			int red = 3 * i, green = 3 * i - 255, blue = 3 * i - 510;
+			palette[3 * i]     = (red > 255) ? 255 : red;
+			palette[3 * i + 1] = (green < 0) ? 0 : ((green > 255) ? 255 : green);
+			palette[3 * i + 2] = (blue < 0) ? 0 : blue;
+		}
+		result->setPalette(palette);
+	}
+}
+
+
+/**
+ * Draws an axis into the rectangle next to the data (left of it for the
+ * vertical axis, below it for the horizontal one).
+ */
+static void drawAxis(PNGImage *image, const SpectrogramAxis &axis,
+				  const AxisLayout &layout, bool vertical,
+				  int x, int y, int width, int height)
+{
+	string label = AxisLayout::getLabel(axis, vertical);
+
+	if (vertical) {
+		int tickEnd = x + width;
+		int tickStart = tickEnd - layout.ticksSize;
+
+		image->drawLine(tickEnd, y, tickEnd, y + height, FOREGROUND);
+		for (unsigned i = 0; i < layout.ticks.size(); i++) {
+			int position = y + layout.ticks[i].position;
+			image->drawLine(tickStart, position, tickEnd, position, FOREGROUND);
+			image->drawText(tickStart, position, layout.ticks[i].text, FOREGROUND);
+		}
+
+		if (!axis.type.empty()) {
+			image->drawText(x, y + height / 2 - PNGImage::getTextHeight() / 2,
+						 label, FOREGROUND);
+		}
+	} else {
+		int tickEnd = y;
+		int tickStart = tickEnd + layout.ticksSize;
+
+		image->drawLine(x, tickEnd, x + width, tickEnd, FOREGROUND);
+		for (unsigned i = 0; i < layout.ticks.size(); i++) {
+			int position = x + layout.ticks[i].position;
+			image->drawLine(position, tickStart, position, tickEnd, FOREGROUND);
+			image->drawText(position, tickStart - PNGImage::getTextHeight(),
+						 layout.ticks[i].text, FOREGROUND);
+		}
+
+		if (!axis.type.empty()) {
+			image->drawText(x + width / 2 - PNGImage::getTextWidth(label) / 2,
+						 y + height - layout.ticksSize + layout.margin,
+						 label, FOREGROUND);
+		}
+	}
+}
+
+
+void SpectrogramRenderer::render(const Spectrogram &spectrogram, PNGImage *result) const
+{
+	PNGImage data;
+	renderData(spectrogram, &data);
+
+	SpectrogramAxis xAxis = spectrogram.axes[0];
+	SpectrogramAxis yAxis = spectrogram.axes[1];
+
+	if ((width_ > 0) && (width_ < data.getWidth())) {
+		double ratio = (double)width_ / data.getWidth();
+		data.scaleDown(width_, (int)(data.getHeight() * ratio));
+		xAxis.scale = ratio;
+		yAxis.scale = ratio;
+	}
+
+	int width = data.getWidth();
+	int height = data.getHeight();
+
+	// Legend, a line of text per header, a quarter of a line apart.
+	vector<string> lines;
+	lines.push_back(" Origin: " + spectrogram.origin + " ");
+	if (!spectrogram.date.empty())
+		lines.push_back(" Date: " + spectrogram.date + " ");
+	if (!spectrogram.observationDate.empty())
+		lines.push_back(" Observation date: " + spectrogram.observationDate + " ");
+
+	int lineHeight = PNGImage::getTextHeight();
+	int lineMargin = lineHeight / 4;
+	int legendHeight = lineHeight * lines.size() + lineMargin * (1 + lines.size());
+
+	AxisLayout yLayout(yAxis, height, true);
+	AxisLayout xLayout(xAxis, width, false);
+
+	result->resize(yLayout.width + width, legendHeight + height + xLayout.height);
+	result->setPalette(data.getPalette());
+	result->fill(BACKGROUND);
+
+	data.copyTo(result, yLayout.width, legendHeight);
+
+	for (unsigned i = 0; i < lines.size(); i++) {
+		result->drawText(yLayout.width, lineMargin + i * (lineHeight + lineMargin),
+					  lines[i], FOREGROUND);
+	}
+
+	drawAxis(result, yAxis, yLayout, true, 0, legendHeight, yLayout.width, height);
+	drawAxis(result, xAxis, xLayout, false, yLayout.width, legendHeight + height,
+		    width, xLayout.height);
+}
+
+
+bool SpectrogramRenderer::parseScale(const string &name, SpectrogramScale *result)
+{
+	if ((name == "id") || (name == "identity")) {
+		*result = SCALE_IDENTITY;
+	} else if (name == "log") {
+		*result = SCALE_LOG;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+
+bool SpectrogramRenderer::parseColormap(const string &name, SpectrogramColormap *result)
+{
+	if ((name == "gray") || (name == "grey")) {
+		*result = COLORMAP_GRAY;
+	} else if (name == "hot") {
+		*result = COLORMAP_HOT;
+	} else {
+		return false;
+	}
+	return true;
+}
+
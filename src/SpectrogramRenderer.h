@@ -0,0 +1,158 @@
+/**
+ * \file   SpectrogramRenderer.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SpectrogramRenderer class.
+ */
+
+#ifndef SPECTROGRAMRENDERER_Q2HN8VXE
+#define SPECTROGRAMRENDERER_Q2HN8VXE
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "PNGImage.h"
+
+
+/**
+ * \brief Linear mapping between the pixels of an image axis and the logical
+ *        values (like the CRPIXn, CRVALn and CDELTn FITS headers).
+ */
+struct SpectrogramAxis {
+	/// Pixel of the reference value, counted from 0.
+	double reference;
+	/// Logical value of the reference pixel.
+	double value;
+	/// Difference of the logical value between two subsequent pixels.
+	double delta;
+	/// Number of pixels of the (unscaled) axis.
+	int    length;
+	/// Type of the axis (CTYPEn), \c TIME for the time in UNIX seconds.
+	string type;
+	/// Ratio of the size of the rendered image to the data.
+	double scale;
+
+	/**
+	 * Constructor.
+	 *
+	 * \param reference reference pixel counted from 1 (as CRPIXn)
+	 */
+	SpectrogramAxis(double reference = 1, double value = 0, double delta = 1,
+				 int length = 0, const string &type = "") :
+		reference(reference - 1), value(value), delta(delta), length(length),
+		type(type), scale(1.0)
+	{}
+
+	double toLogical(double physical) const
+	{
+		return value + (delta / scale) * (physical - scale * reference);
+	}
+
+	int toPhysical(double logical) const
+	{
+		return (int)(scale * reference + (scale / delta) * (logical - value));
+	}
+
+	double toPhysicalLength(double logical) const
+	{
+		return (scale / delta) * logical;
+	}
+
+	bool isTime() const;
+};
+
+
+/**
+ * \brief Values of a snapshot (rows of spectra, the first one at the top)
+ *        with its axes and legend.
+ */
+struct Spectrogram {
+	int             width;
+	int             height;
+	/// Rows of the spectrogram, \c width values each.
+	const float    *data;
+
+	/// Frequency (horizontal) and time (vertical) axis.
+	SpectrogramAxis axes[2];
+
+	string          origin;
+	/// Date of the file (DATE), empty if unknown.
+	string          date;
+	/// Date of the observation (DATE-OBS), empty if unknown.
+	string          observationDate;
+
+	Spectrogram() : width(0), height(0), data(NULL), origin("-") {}
+};
+
+
+enum SpectrogramScale {
+	SCALE_IDENTITY,
+	SCALE_LOG
+};
+
+
+enum SpectrogramColormap {
+	COLORMAP_GRAY,
+	/// Black, red, yellow, white.
+	COLORMAP_HOT
+};
+
+
+/**
+ * \brief Renders spectrograms into images with a legend and the axes, laid
+ *        out like the images of the \c fits2png script.
+ *
+ * The values are scaled (with a lookup table for the logarithm), mapped
+ * linearly to the 256 levels of the colour map between the minimum and the
+ * maximum, and the image is optionally scaled down to the output width.
+ * The colour map is the palette of the image, so the levels are not
+ * converted to colours at all.
+ *
+ * A renderer can be used by several threads at once.
+ */
+class SpectrogramRenderer {
+private:
+	SpectrogramScale    scale_;
+	SpectrogramColormap colormap_;
+	double              min_;
+	double              max_;
+	bool                hasMin_;
+	bool                hasMax_;
+	int                 width_;
+
+	float transform(float value) const;
+
+public:
+	SpectrogramRenderer();
+
+	void setScale(SpectrogramScale scale) { scale_ = scale; }
+	void setColormap(SpectrogramColormap colormap) { colormap_ = colormap; }
+	/// Sets the value mapped to the first colour (instead of the minimum).
+	void setMin(double value) { min_ = value; hasMin_ = true; }
+	/// Sets the value mapped to the last colour (instead of the maximum).
+	void setMax(double value) { max_ = value; hasMax_ = true; }
+	/// Sets the width the data is scaled down to, 0 to keep it.
+	void setWidth(int width) { width_ = width; }
+
+	/**
+	 * \brief Maps the values to the levels of the colour map, not scaled.
+	 *
+	 * Values which are not finite (like the logarithm of zero) do not count
+	 * into the minimum and the maximum and are mapped to the first level.
+	 */
+	void renderData(const Spectrogram &spectrogram, PNGImage *result) const;
+
+	/// Renders the spectrogram with the legend and the axes.
+	void render(const Spectrogram &spectrogram, PNGImage *result) const;
+
+	/// Parses a scale name (\c id or \c log).
+	static bool parseScale(const string &name, SpectrogramScale *result);
+	/// Parses a colour map name (\c gray or \c hot).
+	static bool parseColormap(const string &name, SpectrogramColormap *result);
+};
+
+#endif /* end of include guard: SPECTROGRAMRENDERER_Q2HN8VXE */
+
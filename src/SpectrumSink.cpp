@@ -0,0 +1,178 @@
+/**
+ * \file   SpectrumSink.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the SpectrumSink and SinkWorker classes.
+ */
+
+#include "SpectrumSink.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+#include <cmath>
+#include <cstring>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SINK WORKER
+////////////////////////////////////////////////////////////////////////////////
+
+
+void* SinkWorker::threadMethod()
+{
+	if (Trace::isEnabled()) Trace::setThreadName("sink");
+	
+	while (true) {
+		const float *row;
+		DataInfo     info;
+
+		// Wait for a row. Exit only after the queue has been drained.
+		{
+			MutexLock lock(&mutex_);
+
+			while ((count_ == 0) && !ending_)
+				condition_.wait(mutex_);
+
+			if (count_ == 0) break;
+
+			row  = &(rows_[0]) + (long)head_ * bins_;
+			info = infos_[head_];
+		}
+
+		// The producer never writes to the head of a non-empty queue.
+		{
+			TraceScope trace(TRACE_SINK_ROW);
+			sink_->processRow(row, info);
+		}
+		Metrics::count(METRIC_ROWS_OUT);
+
+		{
+			MutexLock lock(&mutex_);
+
+			head_ = (head_ + 1) % capacity_;
+			count_--;
+			if (blocking_) spaceCondition_.signal();
+		}
+	}
+
+	return NULL;
+}
+
+
+SinkWorker::SinkWorker(Ref<SpectrumSink> sink, float queueLength) :
+	sink_(sink), thread_(NULL), ending_(false), blocking_(false),
+	queueLength_(queueLength),
+	bins_(0), capacity_(0), head_(0), count_(0),
+	droppedRows_(0)
+{
+}
+
+
+SinkWorker::~SinkWorker()
+{
+	if (thread_ != NULL) endStream();
+}
+
+
+int SinkWorker::getBacklog()
+{
+	MutexLock lock(&mutex_);
+	return count_;
+}
+
+
+long SinkWorker::getDroppedRows()
+{
+	MutexLock lock(&mutex_);
+	return droppedRows_;
+}
+
+
+void SinkWorker::startStream(const SpectrumInfo &info)
+{
+	bins_     = info.bins;
+	capacity_ = (int)ceil(queueLength_ * info.fftSampleRate);
+	if (capacity_ < 2) capacity_ = 2;
+
+	rows_.resize((long)capacity_ * bins_);
+	infos_.resize(capacity_);
+
+	head_        = 0;
+	count_       = 0;
+	droppedRows_ = 0;
+	ending_      = false;
+	blocking_    = !info.stream.realTime;
+
+	LOG_DEBUG("Sink worker: queue length = " << capacity_ << " rows of " <<
+			bins_ << " bins.");
+
+	sink_->startStream(info);
+	thread_ = new Thread(this, &SinkWorker::threadMethod);
+}
+
+
+void SinkWorker::push(const float *row, DataInfo info)
+{
+	int tail;
+
+	{
+		TraceScope wait(TRACE_SINK_WAIT);
+		MutexLock lock(&mutex_);
+
+		while (blocking_ && (count_ >= capacity_))
+			spaceCondition_.wait(mutex_);
+		wait.stop();
+
+		if (count_ >= capacity_) {
+			droppedRows_++;
+			Metrics::count(METRIC_ROWS_DROPPED);
+			// Log the 1st, 2nd, 4th, 8th... dropped row.
+			if ((droppedRows_ & (droppedRows_ - 1)) == 0) {
+				LOG_WARNING("Sink queue is full, " << droppedRows_ <<
+						  " row(s) dropped so far.");
+			}
+			return;
+		}
+
+		tail = (head_ + count_) % capacity_;
+	}
+
+	// The consumer doesn't touch the tail of the queue, so the row can be
+	// copied without holding the lock.
+	memcpy(&(rows_[0]) + (long)tail * bins_, row, bins_ * sizeof(float));
+	infos_[tail] = info;
+
+	{
+		MutexLock lock(&mutex_);
+
+		count_++;
+		condition_.signal();
+	}
+
+	Metrics::count(METRIC_ROWS_QUEUED);
+}
+
+
+void SinkWorker::endStream()
+{
+	if (thread_ == NULL) return;
+
+	{
+		MutexLock lock(&mutex_);
+
+		ending_ = true;
+		condition_.signal();
+	}
+
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+
+	sink_->endStream();
+
+	if (droppedRows_ > 0) {
+		LOG_WARNING("Sink dropped " << droppedRows_ << " row(s) in total.");
+	}
+}
+
@@ -0,0 +1,170 @@
+/**
+ * \file   SpectrumSink.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the SpectrumSink and SinkWorker classes.
+ */
+
+#ifndef SPECTRUMSINK_W3NA7PLE
+#define SPECTRUMSINK_W3NA7PLE
+
+#include <vector>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include "Backend.h"
+
+
+/**
+ * \brief Basic metadata for a stream of spectra (magnitude rows).
+ */
+struct SpectrumInfo {
+	/// Sample stream the spectra are computed from.
+	StreamInfo stream;
+	/// Width of a row (number of FFT bins).
+	int        bins;
+	/// Number of rows per second (Hz).
+	float      fftSampleRate;
+
+	SpectrumInfo() :
+		stream(), bins(0), fftSampleRate(0)
+	{}
+
+	float binToFrequency(int bin) const
+	{
+		return (
+			(float)stream.sampleRate *
+			((2.0 * ((float)bin / (float)bins)) - 1.0)
+		);
+	}
+
+	float binToFrequency() const
+	{
+		return (
+			(2.0 / (float)bins) * (float)stream.sampleRate
+		);
+	}
+
+	int frequencyToBin(float frequency) const
+	{
+		int bin = (
+			(float)bins * 0.5 *
+			((frequency / (float)stream.sampleRate) + 1.0)
+		);
+		if (bin < 0) return 0;
+		if (bin >= bins) return bins - 1;
+		return bin;
+	}
+};
+
+
+/**
+ * \brief Consumer of the magnitude rows produced by WaterfallBackend.
+ *
+ * Each sink subscribed to a backend is driven by its own SinkWorker, so
+ * all of the methods of a sink are called from the same thread.
+ */
+class SpectrumSink : public Object {
+private:
+	SpectrumSink(const SpectrumSink& other);
+
+protected:
+	SpectrumInfo info_;
+
+public:
+	SpectrumSink() {}
+	virtual ~SpectrumSink() {}
+
+	virtual void startStream(const SpectrumInfo &info) { info_ = info; }
+	/**
+	 * \brief Processes one magnitude row.
+	 *
+	 * \param row  \c info_.bins magnitudes, the lowest frequency first
+	 * \param info position (FFT frame number) and time of the row
+	 */
+	virtual void processRow(const float *row, DataInfo info) = 0;
+	virtual void endStream() {}
+	
+	/**
+	 * \brief Returns the number of rows the first row of a segment of a
+	 *        stream processed in parallel has to be a multiple of (see
+	 *        Backend::getSegmentAlignment()).
+	 */
+	virtual int getRowAlignment(const SpectrumInfo &info) { return 1; }
+};
+
+
+/**
+ * \brief Queue and worker thread of a single SpectrumSink.
+ *
+ * The producer (the FFT thread) only copies the row into the queue. In
+ * real-time streams (see StreamInfo::realTime) it never waits for the sink:
+ * if the queue is full, the row is dropped and counted, so a slow sink can't
+ * stall the FFT or the other sinks. In other streams (files) the producer
+ * waits for the sink instead.
+ */
+class SinkWorker : public Object {
+private:
+	typedef MethodThread<void, SinkWorker> Thread;
+
+	Ref<SpectrumSink> sink_;
+	Thread           *thread_;
+
+	Mutex             mutex_;
+	Condition         condition_;
+	/// Signalled by the consumer when a row is removed from a full queue.
+	Condition         spaceCondition_;
+	bool              ending_;
+	/// Whether the producer waits for free space instead of dropping rows.
+	bool              blocking_;
+
+	/// Requested queue length in seconds.
+	float             queueLength_;
+
+	int               bins_;
+	int               capacity_;
+	vector<float>     rows_;
+	vector<DataInfo>  infos_;
+	int               head_;
+	int               count_;
+
+	long              droppedRows_;
+
+	SinkWorker(const SinkWorker& other);
+
+	void* threadMethod();
+
+public:
+	/**
+	 * \param sink        the sink to be driven by the worker
+	 * \param queueLength length of the queue in seconds of rows
+	 */
+	SinkWorker(Ref<SpectrumSink> sink, float queueLength);
+	virtual ~SinkWorker();
+
+	Ref<SpectrumSink> getSink() { return sink_; }
+
+	/// Number of rows waiting in the queue.
+	int  getBacklog();
+	/// Number of rows dropped because the queue was full.
+	long getDroppedRows();
+
+	void startStream(const SpectrumInfo &info);
+	/**
+	 * \brief Copies the row into the queue (called by the producer).
+	 */
+	void push(const float *row, DataInfo info);
+	/**
+	 * \brief Waits for the sink to process the queued rows and ends the stream.
+	 */
+	void endStream();
+};
+
+
+#endif /* end of include guard: SPECTRUMSINK_W3NA7PLE */
+
@@ -0,0 +1,113 @@
+/**
+ * \file   ThreadRegistry.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the ThreadRegistry class.
+ */
+
+#ifndef THREADREGISTRY_H4NB7QEW
+#define THREADREGISTRY_H4NB7QEW
+
+#include <cstddef>
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include <pthread.h>
+
+
+/**
+ * \brief Objects of type \c T owned by single threads, e.g. the shards of
+ *        the metrics.
+ *
+ * A thread gets its own object on the first call of get(). When the thread
+ * finishes, T::release() is called and the object is put on a free list, to
+ * be reused by the next new thread: nothing a thread has recorded is lost
+ * and the memory stays bounded by the largest number of threads at once.
+ * The objects are never deleted, so getAll() can be walked at any time.
+ *
+ * \c T must have a default constructor, a \c release() method and the
+ * members \c next and \c nextFree (pointers to \c T) for the lists.
+ */
+template<class T>
+class ThreadRegistry {
+private:
+	static Mutex          mutex_;
+	/// All of the objects ever created.
+	static T             *all_;
+	/// Objects of the threads that have finished.
+	static T             *free_;
+
+	static pthread_once_t keyOnce_;
+	static pthread_key_t  key_;
+	static __thread T    *current_;
+
+	static void release(void *object)
+	{
+		((T*)object)->release();
+
+		MutexLock lock(&mutex_);
+		((T*)object)->nextFree = free_;
+		free_ = (T*)object;
+	}
+
+	static void createKey()
+	{
+		pthread_key_create(&key_, release);
+	}
+
+	static T* acquire()
+	{
+		pthread_once(&keyOnce_, createKey);
+
+		{
+			MutexLock lock(&mutex_);
+
+			if (free_ != NULL) {
+				current_ = free_;
+				free_ = free_->nextFree;
+			} else {
+				current_ = new T();
+				current_->next = all_;
+				all_ = current_;
+			}
+		}
+
+		pthread_setspecific(key_, current_);
+		return current_;
+	}
+
+public:
+	/// Returns the object of the calling thread.
+	static T* get()
+	{
+		if (current_ != NULL) return current_;
+		return acquire();
+	}
+
+	/**
+	 * \brief Returns the first of all the objects, the rest is linked by
+	 *        \c next.
+	 *
+	 * Objects are never removed from the list, and new ones are added at
+	 * its head, so the rest of it can be walked without a lock.
+	 */
+	static T* getAll()
+	{
+		MutexLock lock(&mutex_);
+		return all_;
+	}
+};
+
+
+template<class T> Mutex          ThreadRegistry<T>::mutex_;
+template<class T> T             *ThreadRegistry<T>::all_ = NULL;
+template<class T> T             *ThreadRegistry<T>::free_ = NULL;
+template<class T> pthread_once_t ThreadRegistry<T>::keyOnce_ = PTHREAD_ONCE_INIT;
+template<class T> pthread_key_t  ThreadRegistry<T>::key_;
+template<class T> __thread T    *ThreadRegistry<T>::current_ = NULL;
+
+#endif /* end of include guard: THREADREGISTRY_H4NB7QEW */
+
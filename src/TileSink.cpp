@@ -0,0 +1,426 @@
+/**
+ * \file   TileSink.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the TileSink class.
+ */
+
+#include "TileSink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+
+/**
+ * \brief A level of the pyramid: its tile row being filled and the row
+ *        waiting to be binned with the next one into the next level.
+ */
+struct TileSink::Level {
+	int           width;
+	int           columns;
+	/// Length of a row in microseconds.
+	double        rowMicroseconds;
+	/// Whether the means are the maxima (level 0).
+	bool          single;
+
+	/// Means and maxima of the tile row, \c tileSize rows of \c width.
+	vector<float> mean;
+	vector<float> max;
+	/// Index of the tile row being filled, -1 for none.
+	long          tileRow;
+	/// Number of rows of the tile row (the last one written + 1).
+	int           rows;
+	/// Time of the first row of the tile row.
+	int64_t       time;
+
+	/// Row binned to the width of the next level, waiting for its pair.
+	vector<float> binnedMean;
+	vector<float> binnedMax;
+	long          pendingIndex;
+	int64_t       pendingTime;
+
+	int           tilesFile;
+	int           indexFile;
+	/// A tile being written.
+	vector<float> tile;
+
+	Level(int width, int tileSize, double rowMicroseconds, bool single) :
+		width(width),
+		columns((width + tileSize - 1) / tileSize),
+		rowMicroseconds(rowMicroseconds),
+		single(single),
+		mean((long)width * tileSize, NAN),
+		max(single ? 0 : (long)width * tileSize, NAN),
+		tileRow(-1),
+		rows(0),
+		time(0),
+		pendingIndex(-1),
+		pendingTime(0),
+		tilesFile(-1),
+		indexFile(-1),
+		tile(2 * tileSize * tileSize)
+	{}
+
+	const float* getMax() const { return single ? &(mean[0]) : &(max[0]); }
+};
+
+
+static bool writeAll(int file, const void *data, size_t size, off_t offset)
+{
+	const char *bytes = (const char*)data;
+	while (size > 0) {
+		ssize_t written = pwrite(file, bytes, size, offset);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		bytes += written;
+		size -= written;
+		offset += written;
+	}
+	return true;
+}
+
+
+/**
+ * Constructor.
+ */
+TileSink::TileSink(string origin,
+			    int    tileSize,
+			    int    levels,
+			    float  leftFrequency,
+			    float  rightFrequency,
+			    string directory) :
+	SpectrumSink(),
+	origin_(origin),
+	directory_(directory),
+	tileSize_((tileSize < 1) ? 1 : tileSize),
+	levelCount_((levels < 1) ? 1 : ((levels > 16) ? 16 : levels)),
+	leftFrequency_((leftFrequency < rightFrequency) ? leftFrequency : rightFrequency),
+	rightFrequency_((leftFrequency > rightFrequency) ? leftFrequency : rightFrequency),
+	fullBand_(leftFrequency == rightFrequency),
+	leftBin_(0),
+	rightBin_(0),
+	failed_(false)
+{
+}
+
+
+/**
+ * Destructor.
+ */
+TileSink::~TileSink()
+{
+	closeLevels();
+}
+
+
+void TileSink::closeLevels()
+{
+	for (unsigned i = 0; i < levels_.size(); i++) {
+		if (levels_[i]->tilesFile >= 0) close(levels_[i]->tilesFile);
+		if (levels_[i]->indexFile >= 0) close(levels_[i]->indexFile);
+		delete levels_[i];
+	}
+	levels_.clear();
+}
+
+
+/**
+ * Adds a row of a level (the means and the maxima of its bins) and bins it
+ * into the next level.
+ *
+ * \param index position of the row in the level
+ * \param time  time of the first (full resolution) row of the row
+ */
+void TileSink::addRow(int level, long index, const float *mean, const float *max,
+				  int64_t time)
+{
+	Level *current = levels_[level];
+
+	long tileRow = index / tileSize_;
+	int  row = index % tileSize_;
+
+	if (tileRow != current->tileRow) {
+		if (current->tileRow >= 0) writeTileRow(level);
+
+		current->tileRow = tileRow;
+		current->rows = 0;
+		current->time = time - (int64_t)(row * current->rowMicroseconds);
+		fill(current->mean.begin(), current->mean.end(), NAN);
+		fill(current->max.begin(), current->max.end(), NAN);
+	}
+
+	memcpy(&(current->mean[(long)row * current->width]), mean,
+		  current->width * sizeof(float));
+	if (!current->single) {
+		memcpy(&(current->max[(long)row * current->width]), max,
+			  current->width * sizeof(float));
+	}
+	if (row + 1 > current->rows) current->rows = row + 1;
+
+	if (level + 1 < levelCount_) {
+		int width = levels_[level + 1]->width;
+		float *binnedMean = &(current->binnedMean[0]);
+		float *binnedMax = &(current->binnedMax[0]);
+
+		// A row without its pair (e.g. after dropped rows) goes up alone.
+		if ((current->pendingIndex >= 0) && (current->pendingIndex / 2 != index / 2)) {
+			addRow(level + 1, current->pendingIndex / 2, binnedMean, binnedMax,
+				  current->pendingTime);
+			current->pendingIndex = -1;
+		}
+
+		// Bin the pairs of values, the last one of an odd width alone.
+		for (int i = 0; i < width; i++) {
+			int left = 2 * i;
+			int right = (left + 1 < current->width) ? left + 1 : left;
+
+			float rowMean = 0.5f * (mean[left] + mean[right]);
+			float rowMax = (max[left] > max[right]) ? max[left] : max[right];
+
+			if (current->pendingIndex >= 0) {
+				binnedMean[i] = 0.5f * (binnedMean[i] + rowMean);
+				if (rowMax > binnedMax[i]) binnedMax[i] = rowMax;
+			} else {
+				binnedMean[i] = rowMean;
+				binnedMax[i] = rowMax;
+			}
+		}
+
+		if (current->pendingIndex >= 0) {
+			current->pendingIndex = -1;
+			addRow(level + 1, index / 2, binnedMean, binnedMax, current->pendingTime);
+		} else if (index % 2 == 0) {
+			current->pendingIndex = index;
+			current->pendingTime = time;
+		} else {
+			addRow(level + 1, index / 2, binnedMean, binnedMax, time);
+		}
+	}
+
+	if (row == tileSize_ - 1) {
+		writeTileRow(level);
+		current->tileRow = -1;
+
+		// The partial tile rows of the other levels are brought up to date.
+		if (level == 0) {
+			for (int i = 1; i < levelCount_; i++) {
+				if (levels_[i]->tileRow >= 0) writeTileRow(i);
+			}
+		}
+	}
+}
+
+
+void TileSink::writeTileRow(int level)
+{
+	if (failed_) return;
+
+	Level *current = levels_[level];
+
+	long tileValues = (long)tileSize_ * tileSize_;
+	long tileBytes = 2 * tileValues * sizeof(float);
+	const float *max = current->getMax();
+
+	bool ok = true;
+	for (int column = 0; ok && (column < current->columns); column++) {
+		int first = column * tileSize_;
+		int count = (current->width - first < tileSize_) ? current->width - first : tileSize_;
+
+		for (int row = 0; row < tileSize_; row++) {
+			long source = (long)row * current->width + first;
+			float *tileMean = &(current->tile[(long)row * tileSize_]);
+			float *tileMax = tileMean + tileValues;
+
+			memcpy(tileMean, &(current->mean[source]), count * sizeof(float));
+			memcpy(tileMax, max + source, count * sizeof(float));
+			for (int i = count; i < tileSize_; i++) {
+				tileMean[i] = NAN;
+				tileMax[i] = NAN;
+			}
+		}
+
+		off_t offset = ((off_t)current->tileRow * current->columns + column) * tileBytes;
+		ok = writeAll(current->tilesFile, &(current->tile[0]), tileBytes, offset);
+	}
+
+	TileIndexEntry entry;
+	entry.time = current->time;
+	entry.rows = current->rows;
+	entry.reserved = 0;
+	ok = ok && writeAll(current->indexFile, &entry, sizeof(entry),
+					(off_t)current->tileRow * sizeof(entry));
+
+	if (!ok) {
+		LOG_ERROR("Failed to write tiles of level " << level << " into \"" << path_ <<
+				"\": " << strerror(errno) << ".");
+		failed_ = true;
+	}
+}
+
+
+/**
+ * Writes tiles.txt (replaced atomically, as the segments of a stream write
+ * the same pyramid).
+ */
+void TileSink::writeDescription()
+{
+	ostringstream text;
+	text.precision(10);
+
+	text << "# Tile pyramid written by waterfall. Tiles of TILE_SIZE x TILE_SIZE" << endl;
+	text << "# float means followed by as many maxima in level_N.tiles, an index" << endl;
+	text << "# entry (int64 time in us, int32 rows, int32 reserved) per tile row" << endl;
+	text << "# in level_N.index. level_N = WIDTH COLUMNS ROW_SECONDS." << endl;
+	text << "origin = " << origin_ << endl;
+	text << "start_time = " << info_.stream.timeOffset.format("%Y-%m-%d %H:%M:%S") << endl;
+	text << "left_frequency = " << info_.binToFrequency(leftBin_) << endl;
+	text << "bin_frequency = " << info_.binToFrequency() << endl;
+	text << "row_seconds = " << (1.0 / info_.fftSampleRate) << endl;
+	text << "tile_size = " << tileSize_ << endl;
+	text << "levels = " << levelCount_ << endl;
+	for (int i = 0; i < levelCount_; i++) {
+		text << "level_" << i << " = " << levels_[i]->width << " " <<
+			levels_[i]->columns << " " << (levels_[i]->rowMicroseconds / 1e6) << endl;
+	}
+
+	string fileName = path_ + "/tiles.txt";
+	char temporary[1024];
+	snprintf(temporary, sizeof(temporary), "%s.XXXXXX", fileName.c_str());
+
+	int file = mkstemp(temporary);
+	string data = text.str();
+	bool ok = (file >= 0) && writeAll(file, data.c_str(), data.size(), 0);
+	if (file >= 0) ok = (close(file) == 0) && ok;
+	if (ok) ok = (chmod(temporary, 0644) == 0) && (rename(temporary, fileName.c_str()) == 0);
+
+	if (!ok) {
+		if (file >= 0) unlink(temporary);
+		LOG_ERROR("Failed to write \"" << fileName << "\".");
+	}
+}
+
+
+/**
+ *
+ */
+void TileSink::startStream(const SpectrumInfo &info)
+{
+	SpectrumSink::startStream(info);
+
+	closeLevels();
+	failed_ = false;
+
+	if (fullBand_) {
+		leftBin_  = 0;
+		rightBin_ = info.bins;
+	} else {
+		leftBin_  = info.frequencyToBin(leftFrequency_);
+		rightBin_ = info.frequencyToBin(rightFrequency_);
+		if (rightBin_ <= leftBin_) rightBin_ = leftBin_ + 1;
+	}
+
+	ostringstream path;
+	path << directory_;
+	if (!directory_.empty() && (directory_[directory_.size() - 1] != '/')) path << "/";
+	path << "tiles_" << origin_ << "_" <<
+		info.stream.timeOffset.format("%Y_%m_%d_%H_%M_%S");
+	path_ = path.str();
+
+	if ((mkdir(path_.c_str(), 0755) != 0) && (errno != EEXIST)) {
+		LOG_ERROR("Failed to create tile directory \"" << path_ << "\": " <<
+				strerror(errno) << ".");
+		failed_ = true;
+	}
+
+	int width = rightBin_ - leftBin_;
+	double rowMicroseconds = 1e6 / info.fftSampleRate;
+
+	for (int i = 0; i < levelCount_; i++) {
+		Level *level = new Level(width, tileSize_, rowMicroseconds, i == 0);
+		levels_.push_back(level);
+
+		if (i > 0) {
+			levels_[i - 1]->binnedMean.resize(width);
+			levels_[i - 1]->binnedMax.resize(width);
+		}
+
+		if (!failed_) {
+			ostringstream name;
+			name << path_ << "/level_" << i;
+			level->tilesFile = open((name.str() + ".tiles").c_str(), O_RDWR | O_CREAT, 0644);
+			level->indexFile = open((name.str() + ".index").c_str(), O_RDWR | O_CREAT, 0644);
+
+			if ((level->tilesFile < 0) || (level->indexFile < 0)) {
+				LOG_ERROR("Failed to open tiles \"" << name.str() << "\": " <<
+						strerror(errno) << ".");
+				failed_ = true;
+			}
+		}
+
+		width = (width + 1) / 2;
+		rowMicroseconds *= 2;
+	}
+
+	if (!failed_) writeDescription();
+
+	LOG_DEBUG("Tile sink: " << levelCount_ << " levels of " << tileSize_ << "x" <<
+			tileSize_ << " tiles in \"" << path_ << "\".");
+}
+
+
+/**
+ *
+ */
+void TileSink::processRow(const float *row, DataInfo info)
+{
+	int64_t time = (int64_t)info.timeOffset.seconds() * 1000000 +
+		info.timeOffset.microseconds();
+
+	addRow(0, info.offset, row + leftBin_, row + leftBin_, time);
+}
+
+
+int TileSink::getRowAlignment(const SpectrumInfo &info)
+{
+	return tileSize_ << (levelCount_ - 1);
+}
+
+
+/**
+ *
+ */
+void TileSink::endStream()
+{
+	// The rows waiting for their pairs go up alone.
+	for (int i = 0; i + 1 < levelCount_; i++) {
+		Level *level = levels_[i];
+		if (level->pendingIndex < 0) continue;
+
+		addRow(i + 1, level->pendingIndex / 2, &(level->binnedMean[0]),
+			  &(level->binnedMax[0]), level->pendingTime);
+		level->pendingIndex = -1;
+	}
+
+	for (int i = 0; i < levelCount_; i++) {
+		if (levels_[i]->tileRow >= 0) writeTileRow(i);
+		levels_[i]->tileRow = -1;
+	}
+
+	closeLevels();
+
+	SpectrumSink::endStream();
+}
+
@@ -0,0 +1,117 @@
+/**
+ * \file   TileSink.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the TileSink class.
+ */
+
+#ifndef TILESINK_P8VD2KXM
+#define TILESINK_P8VD2KXM
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "SpectrumSink.h"
+
+
+/**
+ * \brief Entry of the index of a level of a tile pyramid, one per tile row.
+ */
+struct TileIndexEntry {
+	/// Time of the first row of the tile row in microseconds (UNIX time).
+	int64_t time;
+	/// Number of rows written (the last written row + 1), 0 if the tile
+	/// row has not been written at all.
+	int32_t rows;
+	int32_t reserved;
+};
+
+
+/**
+ * \brief Sink keeping a pyramid of downsampled levels of the waterfall in
+ *        fixed-size tiles, so that a viewer can zoom from hours of data down
+ *        to the full resolution reading only the tiles it needs.
+ *
+ * Level 0 is the full resolution (cropped to the band), each of the next
+ * levels bins 2 x 2 values of the previous one (2 rows, 2 frequency bins)
+ * into their mean and maximum. The levels are updated as the rows come.
+ *
+ * A pyramid is a directory (\c tiles_ORIGIN_TIME, after the start of the
+ * stream) with:
+ *
+ * - \c tiles.txt describing the pyramid (the axes, tile size, levels),
+ * - \c level_N.tiles with the tiles of level N, each \c tileSize x
+ *   \c tileSize float means followed by as many maxima (native byte order,
+ *   NaN where there is no data), tile (ROW, COLUMN) at the offset
+ *   (ROW * columns + COLUMN) * tile bytes,
+ * - \c level_N.index with a TileIndexEntry per tile row, written after its
+ *   tiles.
+ *
+ * The rows are placed by their position in the stream (the FFT frame
+ * number), so the segments of a file processed in parallel write into the
+ * same pyramid. The tile rows being filled are rewritten whenever a tile row
+ * of level 0 is finished.
+ */
+class TileSink : public SpectrumSink {
+private:
+	struct Level;
+
+	string          origin_;
+	string          directory_;
+	int             tileSize_;
+	int             levelCount_;
+
+	float           leftFrequency_;
+	float           rightFrequency_;
+	bool            fullBand_;
+	int             leftBin_;
+	int             rightBin_;
+
+	/// Directory of the pyramid of the current stream.
+	string          path_;
+	vector<Level*>  levels_;
+	bool            failed_;
+
+	TileSink(const TileSink& other);
+
+	void addRow(int level, long index, const float *mean, const float *max,
+			  int64_t time);
+	void writeTileRow(int level);
+	void writeDescription();
+	void closeLevels();
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param tileSize width and height of a tile
+	 * \param levels   number of levels including the full resolution
+	 */
+	TileSink(string origin,
+		    int    tileSize,
+		    int    levels,
+		    float  leftFrequency,
+		    float  rightFrequency,
+		    string directory = "");
+	virtual ~TileSink();
+
+	/// Returns the directory of the pyramid of the current stream.
+	const string& getPath() const { return path_; }
+
+	virtual void startStream(const SpectrumInfo &info);
+	virtual void processRow(const float *row, DataInfo info);
+	virtual void endStream();
+
+	/**
+	 * Segments start at a tile row of the last level, so that no tile is
+	 * written by two segments.
+	 */
+	virtual int getRowAlignment(const SpectrumInfo &info);
+};
+
+#endif /* end of include guard: TILESINK_P8VD2KXM */
+
@@ -0,0 +1,332 @@
+/**
+ * \file   Trace.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the Trace and TraceWriter classes.
+ */
+
+#include "Trace.h"
+#include "ThreadRegistry.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <unistd.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRACE
+////////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * \brief Recorded event.
+ */
+struct TraceEntry {
+	uint64_t begin;
+	uint64_t end;
+	/// The event in the low byte, the thread number above it.
+	uint64_t id;
+};
+
+
+/// Number of the last thread given a buffer.
+static uint64_t threadCount = 0;
+
+
+/**
+ * \brief Ring buffer of the events of a single thread.
+ *
+ * Only the owning thread writes to a buffer. It announces each slot it is
+ * about to overwrite in \c claimed before writing it, and publishes it in
+ * \c written afterwards, so a reader can tell which of the slots it copied
+ * were overwritten meanwhile (like a sequence lock).
+ */
+struct Trace::Buffer {
+	TraceEntry *entries;
+	uint64_t    capacity;
+	uint64_t    claimed;
+	uint64_t    written;
+	/// Number of the thread currently using the buffer.
+	uint64_t    thread;
+	Buffer     *next;
+	Buffer     *nextFree;
+
+	Buffer() :
+		capacity(__atomic_load_n(&capacity_, __ATOMIC_RELAXED)),
+		claimed(0), written(0),
+		thread(__atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED)),
+		next(NULL), nextFree(NULL)
+	{
+		entries = new TraceEntry[capacity];
+	}
+
+	/**
+	 * The events are kept until the next thread overwrites them; that
+	 * thread is told apart from the previous one by its number, stored in
+	 * each of its events.
+	 */
+	void release()
+	{
+		thread = __atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED);
+	}
+};
+
+
+bool Trace::enabled_  = false;
+int  Trace::capacity_ = 65536;
+
+
+static Mutex                 nameMutex;
+static map<uint64_t, string> threadNames;
+
+
+Trace::Buffer* Trace::getBuffer()
+{
+	return ThreadRegistry<Buffer>::get();
+}
+
+
+void Trace::setEnabled(bool enabled, int capacity)
+{
+	__atomic_store_n(&capacity_, (capacity > 0) ? capacity : 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&enabled_, enabled, __ATOMIC_RELAXED);
+}
+
+
+void Trace::record(TraceEvent event, uint64_t begin, uint64_t end)
+{
+	Buffer *buffer = getBuffer();
+	uint64_t index = buffer->written;
+	TraceEntry &entry = buffer->entries[index % buffer->capacity];
+
+	__atomic_store_n(&(buffer->claimed), index + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	__atomic_store_n(&(entry.begin), begin, __ATOMIC_RELAXED);
+	__atomic_store_n(&(entry.end), end, __ATOMIC_RELAXED);
+	__atomic_store_n(&(entry.id), (buffer->thread << 8) | (uint64_t)event, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&(buffer->written), index + 1, __ATOMIC_RELEASE);
+}
+
+
+void Trace::setThreadName(const string &name)
+{
+	Buffer *buffer = getBuffer();
+
+	MutexLock lock(&nameMutex);
+	threadNames[buffer->thread] = name;
+}
+
+
+void Trace::write(ostream &output, double seconds)
+{
+	uint64_t cutoff = 0;
+	if (seconds > 0) {
+		uint64_t now = Metrics::now();
+		uint64_t length = (uint64_t)(seconds * 1e9);
+		cutoff = (now > length) ? now - length : 0;
+	}
+
+	map<uint64_t, string> names;
+	{
+		MutexLock lock(&nameMutex);
+		names = threadNames;
+	}
+
+	vector<TraceEntry> events;
+	vector<TraceEntry> copy;
+
+	for (Buffer *buffer = ThreadRegistry<Buffer>::getAll(); buffer != NULL;
+		buffer = buffer->next) {
+		uint64_t written = __atomic_load_n(&(buffer->written), __ATOMIC_ACQUIRE);
+		uint64_t first = (written > buffer->capacity) ? written - buffer->capacity : 0;
+
+		copy.clear();
+		for (uint64_t i = first; i < written; i++) {
+			const TraceEntry &entry = buffer->entries[i % buffer->capacity];
+			TraceEntry event;
+			event.begin = __atomic_load_n(&(entry.begin), __ATOMIC_RELAXED);
+			event.end   = __atomic_load_n(&(entry.end), __ATOMIC_RELAXED);
+			event.id    = __atomic_load_n(&(entry.id), __ATOMIC_RELAXED);
+			copy.push_back(event);
+		}
+
+		// Drop the slots the thread started to overwrite while they were
+		// copied.
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		uint64_t claimed = __atomic_load_n(&(buffer->claimed), __ATOMIC_RELAXED);
+		uint64_t valid = (claimed > buffer->capacity) ? claimed - buffer->capacity : 0;
+
+		for (uint64_t i = (valid > first) ? valid : first; i < written; i++) {
+			if (copy[i - first].end >= cutoff) events.push_back(copy[i - first]);
+		}
+	}
+
+	int pid = getpid();
+	set<uint64_t> threads;
+
+	output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << endl;
+	output << fixed << setprecision(3);
+
+	for (unsigned i = 0; i < events.size(); i++) {
+		const TraceEntry &event = events[i];
+		uint64_t thread = event.id >> 8;
+		threads.insert(thread);
+
+		output << "{\"name\": \"" << getName((TraceEvent)(event.id & 0xff)) << "\"" <<
+			", \"cat\": \"waterfall\", \"ph\": \"X\"" <<
+			", \"ts\": " << (event.begin / 1000.0) <<
+			", \"dur\": " << ((event.end - event.begin) / 1000.0) <<
+			", \"pid\": " << pid << ", \"tid\": " << thread << "}," << endl;
+	}
+
+	for (set<uint64_t>::iterator i = threads.begin(); i != threads.end(); ++i) {
+		map<uint64_t, string>::iterator name = names.find(*i);
+
+		output << "{\"name\": \"thread_name\", \"ph\": \"M\"" <<
+			", \"pid\": " << pid << ", \"tid\": " << *i <<
+			", \"args\": {\"name\": \"";
+		if (name != names.end()) {
+			output << name->second << " ";
+		}
+		output << *i << "\"}}," << endl;
+	}
+
+	output << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << pid <<
+		", \"args\": {\"name\": \"waterfall\"}}" << endl;
+	output << "]}" << endl;
+}
+
+
+const char* Trace::getName(TraceEvent event)
+{
+	switch (event) {
+	case TRACE_JACK_CALLBACK:  return "jack_callback";
+	case TRACE_PROCESS:        return "process";
+	case TRACE_WINDOW:         return "window";
+	case TRACE_FFT:            return "fft";
+	case TRACE_MAGNITUDE:      return "magnitude";
+	case TRACE_SINK_PUSH:      return "sink_push";
+	case TRACE_SINK_WAIT:      return "sink_wait";
+	case TRACE_SINK_ROW:       return "sink_row";
+	case TRACE_SNAPSHOT_WRITE: return "snapshot_write";
+	default:                   return "unknown";
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRACE WRITER
+////////////////////////////////////////////////////////////////////////////////
+
+
+TraceWriter *TraceWriter::instance_ = NULL;
+
+
+void TraceWriter::handleSignal(int signal)
+{
+	// Only async-signal-safe calls here.
+	if (instance_ != NULL) sem_post(&(instance_->semaphore_));
+}
+
+
+void* TraceWriter::threadMethod()
+{
+	while (true) {
+		if ((sem_wait(&semaphore_) != 0) && (errno == EINTR)) continue;
+		if (!__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) break;
+
+		writeFile();
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Writes the trace to a temporary file and renames it over the trace file,
+ * so readers never see it half-written.
+ */
+void TraceWriter::writeFile()
+{
+	string temporary = fileName_ + ".tmp";
+
+	{
+		ofstream output(temporary.c_str());
+		Trace::write(output, seconds_);
+		if (!output) {
+			LOG_ERROR("Failed to write trace to \"" << temporary << "\".");
+			return;
+		}
+	}
+
+	if (rename(temporary.c_str(), fileName_.c_str()) != 0) {
+		LOG_ERROR("Failed to replace \"" << fileName_ << "\": " << strerror(errno));
+		return;
+	}
+
+	LOG_INFO("Trace written to \"" << fileName_ << "\".");
+}
+
+
+/**
+ * Constructor.
+ */
+TraceWriter::TraceWriter(const string &fileName, double seconds) :
+	fileName_(fileName),
+	seconds_((seconds > 0) ? seconds : 0),
+	thread_(NULL),
+	running_(false)
+{
+	sem_init(&semaphore_, 0, 0);
+}
+
+
+/**
+ * Destructor.
+ */
+TraceWriter::~TraceWriter()
+{
+	stop();
+	sem_destroy(&semaphore_);
+}
+
+
+void TraceWriter::start()
+{
+	if (thread_ != NULL) return;
+
+	instance_ = this;
+	signal(SIGUSR2, handleSignal);
+
+	__atomic_store_n(&running_, true, __ATOMIC_RELEASE);
+	thread_ = new Thread(this, &TraceWriter::threadMethod);
+}
+
+
+void TraceWriter::stop()
+{
+	if (thread_ == NULL) return;
+
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+	sem_post(&semaphore_);
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+
+	signal(SIGUSR2, SIG_DFL);
+	instance_ = NULL;
+
+	writeFile();
+}
+
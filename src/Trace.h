@@ -0,0 +1,186 @@
+/**
+ * \file   Trace.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the Trace and TraceWriter classes.
+ */
+
+#ifndef TRACE_P8HW3NQD
+#define TRACE_P8HW3NQD
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+#include <cppapp/cppapp.h>
+
+using namespace cppapp;
+
+#include <semaphore.h>
+
+#include "Metrics.h"
+
+
+/**
+ * \brief Traced activities of the pipeline.
+ */
+enum TraceEvent {
+	/// The JACK process callback.
+	TRACE_JACK_CALLBACK,
+	/// Processing of a block of samples by the backend.
+	TRACE_PROCESS,
+	/// Conversion and windowing of an FFT frame.
+	TRACE_WINDOW,
+	/// The FFT of a frame.
+	TRACE_FFT,
+	/// Magnitudes of a spectrum.
+	TRACE_MAGNITUDE,
+	/// Handing a row to the sinks.
+	TRACE_SINK_PUSH,
+	/// Waiting for the lock (and for space) of a sink queue.
+	TRACE_SINK_WAIT,
+	/// Processing of a row by a sink.
+	TRACE_SINK_ROW,
+	/// Writing a snapshot file.
+	TRACE_SNAPSHOT_WRITE,
+
+	TRACE_EVENT_COUNT
+};
+
+
+/**
+ * \brief Process-wide recorder of the activity of the threads, exported as
+ *        Chrome trace JSON (viewable in chrome://tracing or Perfetto).
+ *
+ * Each thread records its events into its own ring buffer without locks,
+ * so only the last events of each thread are kept and the tracing can stay
+ * enabled in production. When disabled (the default), recording an event
+ * costs a single load of a flag.
+ */
+class Trace {
+public:
+	/// Ring buffer of the events of a single thread (see Trace.cpp).
+	struct Buffer;
+
+private:
+	static bool enabled_;
+	static int  capacity_;
+
+	static Buffer* getBuffer();
+
+public:
+	/**
+	 * \brief Enables or disables the recording.
+	 *
+	 * \param capacity number of events kept per thread (applies to the
+	 *                 threads recording their first event afterwards)
+	 */
+	static void setEnabled(bool enabled, int capacity = 65536);
+
+	static bool isEnabled()
+	{
+		return __atomic_load_n(&enabled_, __ATOMIC_RELAXED);
+	}
+
+	/**
+	 * \brief Records an event of the calling thread.
+	 *
+	 * \param begin Metrics::now() at the start of the event
+	 * \param end   Metrics::now() at its end
+	 */
+	static void record(TraceEvent event, uint64_t begin, uint64_t end);
+
+	/// Sets the name of the calling thread shown in the trace.
+	static void setThreadName(const string &name);
+
+	/**
+	 * \brief Writes the kept events which ended in the last \c seconds (all
+	 *        of them if 0) as Chrome trace JSON.
+	 */
+	static void write(ostream &output, double seconds = 0);
+
+	static const char* getName(TraceEvent event);
+};
+
+
+/**
+ * \brief Records an event from its construction to its destruction (or
+ *        stop()) if the tracing is enabled.
+ */
+class TraceScope {
+private:
+	TraceEvent event_;
+	uint64_t   begin_;
+	bool       running_;
+
+public:
+	TraceScope(TraceEvent event) :
+		event_(event), begin_(0), running_(Trace::isEnabled())
+	{
+		if (running_) begin_ = Metrics::now();
+	}
+
+	~TraceScope() { stop(); }
+
+	void stop()
+	{
+		if (!running_) return;
+		Trace::record(event_, begin_, Metrics::now());
+		running_ = false;
+	}
+};
+
+
+/**
+ * \brief Thread writing the trace of the last seconds to a file on SIGUSR2
+ *        and when stopped.
+ *
+ * The file is replaced atomically.
+ */
+class TraceWriter : public Object {
+private:
+	typedef MethodThread<void, TraceWriter> Thread;
+
+	/// The writer woken by SIGUSR2.
+	static TraceWriter *instance_;
+
+	string       fileName_;
+	double       seconds_;
+
+	Thread      *thread_;
+	sem_t        semaphore_;
+	bool         running_;
+
+	TraceWriter(const TraceWriter& other);
+
+	void* threadMethod();
+	void  writeFile();
+
+	static void handleSignal(int signal);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param fileName file the trace is written to
+	 * \param seconds  length of the written trace (0 for all of the kept
+	 *                 events)
+	 */
+	TraceWriter(const string &fileName, double seconds);
+	virtual ~TraceWriter();
+
+	/**
+	 * \brief Starts the thread and installs the SIGUSR2 handler.
+	 */
+	void start();
+	/**
+	 * \brief Writes the trace and stops the thread.
+	 */
+	void stop();
+};
+
+#endif /* end of include guard: TRACE_P8HW3NQD */
+
@@ -0,0 +1,349 @@
+/**
+ * \file   UDPFrontend.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Implementation file for the UDPFrontend class.
+ */
+
+#include "UDPFrontend.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+/**
+ * Returns a little-endian integer of \c size bytes.
+ */
+static uint64_t readLittleEndian(const char *data, int size)
+{
+	uint64_t value = 0;
+	for (int i = size - 1; i >= 0; i--)
+		value = (value << 8) | (unsigned char)data[i];
+	return value;
+}
+
+
+/**
+ * The receiver thread. Receives batches of packets straight into the ring,
+ * or into the scratch slots (dropping them) when the ring is full.
+ */
+void* UDPFrontend::threadMethod()
+{
+	vector<struct mmsghdr> messages(batchSize_);
+	vector<struct iovec>   vectors(batchSize_);
+	vector<Packet>         scratch(batchSize_);
+
+	while (__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) {
+		Packet *slots;
+		int count = ring_.reserve(&slots);
+		bool dropping = (count < 1);
+
+		if (dropping) slots = &(scratch[0]);
+		if ((count < 1) || (count > batchSize_)) count = batchSize_;
+
+		for (int i = 0; i < count; i++) {
+			vectors[i].iov_base = slots[i].data;
+			vectors[i].iov_len  = UDP_MAX_PACKET_SIZE;
+			memset(&(messages[i].msg_hdr), 0, sizeof(struct msghdr));
+			messages[i].msg_hdr.msg_iov    = &(vectors[i]);
+			messages[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// Waits for the first packet (up to the receive timeout of the
+		// socket), then takes whatever else is queued.
+		int received = recvmmsg(fd_, &(messages[0]), count, MSG_WAITFORONE, NULL);
+		if (received < 1) continue;
+
+		if (dropping) {
+			__atomic_add_fetch(&overflowCount_, received, __ATOMIC_RELAXED);
+			continue;
+		}
+
+		for (int i = 0; i < received; i++)
+			slots[i].length = messages[i].msg_len;
+
+		ring_.commit(received);
+		sem_post(&dataSemaphore_);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Passes \c count zero samples to the backend.
+ */
+void UDPFrontend::fillGap(long count)
+{
+	int sampleSize = getSampleSize(format_);
+	int blockSize  = zeros_.size() / sampleSize;
+
+	while (count > 0) {
+		int n = (count > blockSize) ? blockSize : count;
+		process(SampleSpan(format_, &(zeros_[0]), n));
+		count -= n;
+	}
+}
+
+
+void UDPFrontend::processPacket(const Packet &packet)
+{
+	int headerSize = sizeof(UDPPacketHeader);
+	int sampleSize = getSampleSize(format_);
+
+	if ((packet.length < headerSize) ||
+	    (readLittleEndian(packet.data, 4) != UDP_PACKET_MAGIC))
+		return;
+
+	uint64_t index = readLittleEndian(packet.data + 8, 8);
+	int count = (packet.length - headerSize) / sampleSize;
+
+	packetCount_++;
+
+	// The time of the first sample is the time it arrived unless set.
+	if (!started_) {
+		streamInfo_ = StreamInfo();
+		streamInfo_.sampleRate = sampleRate_;
+		streamInfo_.realTime = true;
+		streamInfo_.timeOffset = hasStartTime_ ? startTime_ : Clock::getDefault()->now();
+		startStream();
+
+		started_ = true;
+		nextIndex_ = index;
+	}
+
+	if (index < nextIndex_) {
+		// Within the window of reordering, the packet is late. Further
+		// back, the sender has restarted and counts from a new position.
+		if (nextIndex_ - index <= (uint64_t)maxGapFill_) {
+			latePacketCount_++;
+			return;
+		}
+
+		LOG_WARNING("UDP frontend: sender restarted (position " << index <<
+				  " after " << nextIndex_ << ").");
+		restartCount_++;
+		nextIndex_ = index;
+	}
+
+	if (index > nextIndex_) {
+		long gap = index - nextIndex_;
+		lostSampleCount_ += gap;
+
+		if (gap <= maxGapFill_) {
+			fillGap(gap);
+		} else {
+			LOG_WARNING("UDP frontend: skipping a gap of " << gap << " samples.");
+			skip(gap);
+		}
+	}
+
+	if (count > 0)
+		process(SampleSpan(format_, packet.data + headerSize, count));
+
+	nextIndex_ = index + count;
+}
+
+
+/**
+ * Constructor.
+ */
+UDPFrontend::UDPFrontend(const string &address, int port, SampleFormat format,
+					int sampleRate, int ringSize) :
+	address_(address),
+	port_(port),
+	socketBufferSize_(32 << 20),
+	fd_(-1),
+	format_(format),
+	sampleRate_(sampleRate),
+	timeout_(0),
+	maxGapFill_(sampleRate),
+	ring_(ringSize),
+	batchSize_(64),
+	thread_(NULL),
+	running_(false),
+	nextIndex_(0),
+	started_(false),
+	zeros_(65536 * getSampleSize(format), 0),
+	packetCount_(0),
+	lostSampleCount_(0),
+	latePacketCount_(0),
+	restartCount_(0),
+	overflowCount_(0)
+{
+	sem_init(&dataSemaphore_, 0, 0);
+
+	// Zero of the offset binary samples.
+	if (format == SAMPLE_COMPLEX_UINT8)
+		memset(&(zeros_[0]), 128, zeros_.size());
+}
+
+
+/**
+ * Destructor.
+ */
+UDPFrontend::~UDPFrontend()
+{
+	if (thread_ != NULL) {
+		__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+		thread_->join();
+		delete thread_;
+	}
+
+	sem_destroy(&dataSemaphore_);
+
+	if (fd_ >= 0) close(fd_);
+}
+
+
+bool UDPFrontend::open()
+{
+	if (fd_ >= 0) return true;
+
+	struct sockaddr_in local;
+	memset(&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_port = htons(port_);
+	if (inet_pton(AF_INET, address_.c_str(), &(local.sin_addr)) != 1) {
+		LOG_ERROR("Invalid UDP address \"" << address_ << "\".");
+		return false;
+	}
+
+	fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd_ < 0) {
+		LOG_ERROR("Failed to create UDP socket: " << strerror(errno));
+		return false;
+	}
+
+	// A large buffer covers the stalls of the receiver thread. The forced
+	// size (above the system limit) needs CAP_NET_ADMIN.
+	int size = socketBufferSize_;
+#ifdef SO_RCVBUFFORCE
+	if (setsockopt(fd_, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0)
+#endif
+		setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+	socklen_t length = sizeof(size);
+	if (getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, &length) == 0) {
+		LOG_DEBUG("UDP socket buffer size: " << size << " bytes.");
+	}
+
+	// The receiver thread checks whether it should stop this often.
+	struct timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 100000;
+	setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	if (bind(fd_, (struct sockaddr*)&local, sizeof(local)) != 0) {
+		LOG_ERROR("Failed to bind UDP socket to " << address_ << ":" << port_ <<
+				": " << strerror(errno));
+		close(fd_);
+		fd_ = -1;
+		return false;
+	}
+
+	return true;
+}
+
+
+int UDPFrontend::getPort() const
+{
+	struct sockaddr_in local;
+	socklen_t length = sizeof(local);
+	if ((fd_ < 0) || (getsockname(fd_, (struct sockaddr*)&local, &length) != 0))
+		return port_;
+	return ntohs(local.sin_port);
+}
+
+
+void UDPFrontend::stop()
+{
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+	sem_post(&dataSemaphore_);
+}
+
+
+long UDPFrontend::getOverflowCount() const
+{
+	return __atomic_load_n(&overflowCount_, __ATOMIC_RELAXED);
+}
+
+
+void UDPFrontend::run()
+{
+	if (!open()) return;
+
+	LOG_INFO("Receiving IQ packets on UDP port " << getPort() << "...");
+
+	started_ = false;
+	__atomic_store_n(&running_, true, __ATOMIC_RELEASE);
+	thread_ = new Thread(this, &UDPFrontend::threadMethod);
+
+	WFTime lastPacket = WFTime::now();
+
+	while (true) {
+		struct timespec wakeUp;
+		clock_gettime(CLOCK_REALTIME, &wakeUp);
+		wakeUp.tv_nsec += 100000000;
+		if (wakeUp.tv_nsec >= 1000000000) {
+			wakeUp.tv_sec++;
+			wakeUp.tv_nsec -= 1000000000;
+		}
+		sem_timedwait(&dataSemaphore_, &wakeUp);
+
+		bool finish = !__atomic_load_n(&running_, __ATOMIC_ACQUIRE);
+
+		const Packet *packets;
+		int  count;
+		bool received = false;
+		while ((count = ring_.peek(&packets)) > 0) {
+			for (int i = 0; i < count; i++)
+				processPacket(packets[i]);
+			ring_.consume(count);
+			received = true;
+		}
+
+		WFTime now = WFTime::now();
+		if (received) {
+			lastPacket = now;
+		} else if ((timeout_ > 0) && started_ &&
+		           ((now.seconds() - lastPacket.seconds()) * 1000000.0 +
+		            (now.microseconds() - lastPacket.microseconds()) >
+		            timeout_ * 1000000.0)) {
+			LOG_INFO("UDP frontend: no packets for " << timeout_ << " s.");
+			finish = true;
+		}
+
+		if (finish) break;
+	}
+
+	__atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+	thread_->join();
+	delete thread_;
+	thread_ = NULL;
+
+	// Packets received while the thread was stopping.
+	const Packet *packets;
+	int count;
+	while ((count = ring_.peek(&packets)) > 0) {
+		for (int i = 0; i < count; i++)
+			processPacket(packets[i]);
+		ring_.consume(count);
+	}
+
+	if (started_) endStream();
+
+	LOG_INFO("UDP frontend: " << packetCount_ << " packets, " <<
+		    lostSampleCount_ << " samples lost, " <<
+		    latePacketCount_ << " late packets, " <<
+		    restartCount_ << " sender restarts, " <<
+		    getOverflowCount() << " packets dropped (buffer full).");
+}
+
@@ -0,0 +1,162 @@
+/**
+ * \file   UDPFrontend.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Header file for the UDPFrontend class.
+ */
+
+#ifndef UDPFRONTEND_K4RX9MCE
+#define UDPFRONTEND_K4RX9MCE
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "Frontend.h"
+#include "RingBuffer.h"
+
+#include <semaphore.h>
+
+
+/// Value of UDPPacketHeader::magic ("WFIQ").
+#define UDP_PACKET_MAGIC 0x51494657
+/// Largest packet received (jumbo frames included).
+#define UDP_MAX_PACKET_SIZE 9216
+
+
+/**
+ * \brief Header of the IQ packets received by the UDPFrontend.
+ *
+ * All of the fields are little-endian. The header is followed by the
+ * interleaved samples of the stream. Like the VITA-49 data packets, each
+ * packet carries its position in the stream, so lost, late and duplicate
+ * packets can be told apart and the samples keep their exact time.
+ */
+struct UDPPacketHeader {
+	/// UDP_PACKET_MAGIC
+	uint32_t magic;
+	/// Packet counter (increments by one, wraps around). Informational,
+	/// the gaps are detected from \c sampleIndex.
+	uint32_t sequence;
+	/// Position of the first sample of the packet in the stream.
+	uint64_t sampleIndex;
+};
+
+
+/**
+ * \brief Frontend receiving IQ samples in UDP packets (see UDPPacketHeader).
+ *
+ * A receiver thread reads the packets with \c recvmmsg() in batches,
+ * directly into the slots of a lock-free ring of packets. The thread
+ * calling run() takes the packets from the ring and passes their samples
+ * to the backend without copying them.
+ *
+ * Gaps in the sample positions (lost packets, or packets dropped because
+ * the ring was full) are filled with zeros, so the time of the following
+ * samples stays exact. Gaps longer than the configured limit are skipped
+ * instead. Late and duplicate packets (up to the same limit behind) are
+ * dropped. A packet further behind means that the sender has restarted, the
+ * stream goes on from its position. All of these are counted.
+ *
+ * The stream ends when stop() is called or when no packet arrives for the
+ * configured timeout.
+ */
+class UDPFrontend : public Frontend {
+private:
+	typedef MethodThread<void, UDPFrontend> Thread;
+
+	/**
+	 * \brief Slot of the packet ring.
+	 */
+	struct Packet {
+		/// Number of bytes received.
+		int  length;
+		char data[UDP_MAX_PACKET_SIZE];
+	};
+
+	string        address_;
+	int           port_;
+	int           socketBufferSize_;
+	int           fd_;
+
+	SampleFormat  format_;
+	int           sampleRate_;
+	/// Seconds without packets after which the stream ends, 0 for never.
+	float         timeout_;
+	/// Longest gap (in samples) filled with zeros, also the window of late
+	/// packets.
+	long          maxGapFill_;
+
+	SPSCRingBuffer<Packet> ring_;
+	/// Number of packets received by a single \c recvmmsg() call.
+	int           batchSize_;
+
+	Thread       *thread_;
+	/// Posted by the receiver thread after each batch.
+	sem_t         dataSemaphore_;
+	bool          running_;
+
+	/// Position of the next expected sample.
+	uint64_t      nextIndex_;
+	bool          started_;
+	vector<char>  zeros_;
+
+	long          packetCount_;
+	long          lostSampleCount_;
+	long          latePacketCount_;
+	/// Jumps back by more than the longest gap (sender restarts).
+	long          restartCount_;
+	/// Packets dropped by the receiver thread because the ring was full.
+	long          overflowCount_;
+
+	UDPFrontend(const UDPFrontend& other);
+
+	void* threadMethod();
+	void  processPacket(const Packet &packet);
+	void  fillGap(long count);
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * \param address    local address to receive on ("0.0.0.0" for any)
+	 * \param port       local UDP port (0 for any, see getPort())
+	 * \param format     format of the samples
+	 * \param sampleRate sample rate in Hz
+	 * \param ringSize   number of packets buffered between the threads
+	 */
+	UDPFrontend(const string &address, int port, SampleFormat format,
+			  int sampleRate, int ringSize = 1024);
+	virtual ~UDPFrontend();
+
+	void setTimeout(float timeout) { timeout_ = timeout; }
+	void setMaxGapFill(long samples) { maxGapFill_ = samples; }
+	void setSocketBufferSize(int size) { socketBufferSize_ = size; }
+
+	/**
+	 * \brief Creates and binds the socket (done by run() if not called
+	 *        before).
+	 */
+	bool open();
+	/// Returns the local port of the socket.
+	int  getPort() const;
+
+	/**
+	 * \brief Makes run() process the received packets and end the stream.
+	 */
+	void stop();
+
+	long getPacketCount() const { return packetCount_; }
+	long getLostSampleCount() const { return lostSampleCount_; }
+	long getLatePacketCount() const { return latePacketCount_; }
+	long getRestartCount() const { return restartCount_; }
+	long getOverflowCount() const;
+
+	virtual void run();
+};
+
+#endif /* end of include guard: UDPFRONTEND_K4RX9MCE */
+
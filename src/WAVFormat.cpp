@@ -0,0 +1,121 @@
+/**
+ * \file   WAVFormat.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2013-04-22
+ *
+ * \brief  Implementation file for the WAVFormat structure.
+ */
+
+#include "WAVFormat.h"
+
+#include <cstring>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+
+const char *WAVFormat::CHUNK_ID = "RIFF";
+const char *WAVFormat::RF64_CHUNK_ID = "RF64";
+const char *WAVFormat::BW64_CHUNK_ID = "BW64";
+const char *WAVFormat::CHUNK_FORMAT = "WAVE";
+
+const char *WAVFormat::FORMAT_SUBCHUNK_ID = "fmt ";
+const char *WAVFormat::INF1_SUBCHUNK_ID = "inf1";
+const char *WAVFormat::DATA_SUBCHUNK_ID = "data";
+const char *WAVFormat::DS64_SUBCHUNK_ID = "ds64";
+
+const unsigned char WAVFormat::W64_RIFF_GUID[16] = {
+	'r', 'i', 'f', 'f', 0x2E, 0x91, 0xCF, 0x11,
+	0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00
+};
+const unsigned char WAVFormat::W64_WAVE_GUID[16] = {
+	'w', 'a', 'v', 'e', 0xF3, 0xAC, 0xD3, 0x11,
+	0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A
+};
+const unsigned char WAVFormat::W64_FMT_GUID[16] = {
+	'f', 'm', 't', ' ', 0xF3, 0xAC, 0xD3, 0x11,
+	0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A
+};
+const unsigned char WAVFormat::W64_DATA_GUID[16] = {
+	'd', 'a', 't', 'a', 0xF3, 0xAC, 0xD3, 0x11,
+	0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A
+};
+
+
+template<class T>
+static inline T readScalar(const char *data)
+{
+	T result;
+	memcpy(&result, data, sizeof(T));
+	return result;
+}
+
+
+WAVFormat::WAVFormat() :
+	audioFormat(0),
+	channelCount(0),
+	sampleRate(0),
+	byteRate(0),
+	blockAlign(0),
+	bitsPerSample(0),
+	formatCode(0)
+{
+}
+
+
+bool WAVFormat::parse(const char *chunk, uint64_t size)
+{
+	if (size < 16) return false;
+	
+	audioFormat   = readScalar<uint16_t>(chunk);
+	channelCount  = readScalar<uint16_t>(chunk + 2);
+	sampleRate    = readScalar<int32_t>(chunk + 4);
+	byteRate      = readScalar<int32_t>(chunk + 8);
+	blockAlign    = readScalar<uint16_t>(chunk + 12);
+	bitsPerSample = readScalar<uint16_t>(chunk + 14);
+	formatCode    = audioFormat;
+	
+	// WAVE_FORMAT_EXTENSIBLE: the format code is in the first two bytes of
+	// the sub-format GUID.
+	if ((audioFormat == FORMAT_EXTENSIBLE) && (size >= 26))
+		formatCode = readScalar<uint16_t>(chunk + 24);
+	
+	return true;
+}
+
+
+bool WAVFormat::getSampleFormat(SampleFormat *format) const
+{
+	if (channelCount < 2) return false;
+	// Times are computed from the sample rate, and frames by the block size.
+	if ((sampleRate <= 0) || (blockAlign == 0)) return false;
+	
+	if (formatCode == FORMAT_PCM) {
+		switch (bitsPerSample) {
+		case 16: *format = SAMPLE_COMPLEX_INT16; break;
+		case 24: *format = SAMPLE_COMPLEX_INT24; break;
+		case 32: *format = SAMPLE_COMPLEX_INT32; break;
+		default: return false;
+		}
+	} else if (formatCode == FORMAT_IEEE_FLOAT) {
+		switch (bitsPerSample) {
+		case 32: *format = SAMPLE_COMPLEX_FLOAT;  break;
+		case 64: *format = SAMPLE_COMPLEX_DOUBLE; break;
+		default: return false;
+		}
+	} else {
+		return false;
+	}
+	
+	return (blockAlign >= getSampleSize(*format));
+}
+
+
+WFTime WAVFormat::estimateStartTime(time_t modificationTime, long frames, int sampleRate)
+{
+	WFTime result(modificationTime - frames / sampleRate, 0);
+	LOG_INFO("Start time of the recording estimated from the file " <<
+		    "modification time: " << result.format("%Y-%m-%d %H:%M:%S UTC"));
+	return result;
+}
+
@@ -0,0 +1,84 @@
+/**
+ * \file   WAVFormat.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2013-04-22
+ *
+ * \brief  Header file for the WAVFormat structure.
+ */
+
+#ifndef WAVFORMAT_C3PK9TZE
+#define WAVFORMAT_C3PK9TZE
+
+#include <stdint.h>
+
+#include "Backend.h"
+#include "WFTime.h"
+
+
+/**
+ * \brief Identifiers of the WAV file variants and the contents of the format
+ *        ("fmt ") chunk.
+ *
+ * Besides the classic RIFF files (limited to 4 GiB), the RF64/BW64 files
+ * (RIFF with 64-bit sizes in the "ds64" chunk) and the Sony Wave64 files
+ * (GUIDs instead of chunk IDs and 64-bit sizes) are recognized.
+ */
+struct WAVFormat {
+	static const char *CHUNK_ID;
+	static const char *RF64_CHUNK_ID;
+	static const char *BW64_CHUNK_ID;
+	static const char *CHUNK_FORMAT;
+	
+	static const char *FORMAT_SUBCHUNK_ID;
+	static const char *INF1_SUBCHUNK_ID;
+	static const char *DATA_SUBCHUNK_ID;
+	static const char *DS64_SUBCHUNK_ID;
+	
+	static const unsigned char W64_RIFF_GUID[16];
+	static const unsigned char W64_WAVE_GUID[16];
+	static const unsigned char W64_FMT_GUID[16];
+	static const unsigned char W64_DATA_GUID[16];
+	
+	/// Size of a chunk that doesn't fit into 32 bits in RF64 files.
+	static const uint32_t RF64_SIZE = 0xFFFFFFFF;
+	
+	static const int FORMAT_SUBCHUNK_SIZE = 76;
+	
+	static const int FORMAT_PCM        = 0x0001;
+	static const int FORMAT_IEEE_FLOAT = 0x0003;
+	static const int FORMAT_EXTENSIBLE = 0xFFFE;
+	
+	int audioFormat;
+	int channelCount;
+	int sampleRate;
+	int byteRate;
+	int blockAlign;
+	int bitsPerSample;
+	/// audioFormat, or the sub-format of WAVE_FORMAT_EXTENSIBLE files.
+	int formatCode;
+	
+	WAVFormat();
+	
+	/**
+	 * \brief Reads the format from the body of the format chunk.
+	 */
+	bool parse(const char *chunk, uint64_t size);
+	
+	/**
+	 * \brief Returns the sample format of the first two channels (the real
+	 *        and imaginary parts), \c false if it is not supported or the
+	 *        sample rate or block size is not valid.
+	 */
+	bool getSampleFormat(SampleFormat *format) const;
+	
+	/**
+	 * \brief Estimates the time of the first sample of a recording of
+	 *        \c frames frames from the time its file was last written to
+	 *        (the end of the recording), for the files that carry no time.
+	 */
+	static WFTime estimateStartTime(time_t modificationTime, long frames, int sampleRate);
+};
+
+
+#endif /* end of include guard: WAVFORMAT_C3PK9TZE */
+
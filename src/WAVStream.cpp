@@ -8,13 +8,7 @@
 
 #include "WAVStream.h"
 
-
-const char *WAVFormat::CHUNK_ID = "RIFF";
-const char *WAVFormat::CHUNK_FORMAT = "WAVE";
-
-const char *WAVFormat::FORMAT_SUBCHUNK_ID = "fmt ";
-const char *WAVFormat::INF1_SUBCHUNK_ID = "inf1";
-const char *WAVFormat::DATA_SUBCHUNK_ID = "data";
+#include <sys/stat.h>
 
 
 /**
@@ -50,14 +44,27 @@ string WAVStream::readString(int length)
 /**
  *
  */
-void WAVStream::readFormatSubchunk(int size)
+void WAVStream::readFormatSubchunk(uint32_t size)
 {
-	format_.audioFormat = readInt16();
-	format_.channelCount = readInt16();
-	format_.sampleRate = readInt32();
-	format_.byteRate = readInt32();
-	format_.blockAlign = readInt16();
-	format_.bitsPerSample = readInt16();
+	vector<char> chunk(size + 1);
+	input_->getStream()->read(&(chunk[0]), size);
+	
+	if (!format_.parse(&(chunk[0]), size)) {
+		LOG_ERROR("Invalid WAV format chunk (" << size << " bytes).");
+		return;
+	}
+	formatRead_ = format_.getSampleFormat(&sampleFormat_);
+	
+	if (!formatRead_) {
+		LOG_ERROR("Unsupported WAV format (format " << format_.formatCode <<
+				", " << format_.channelCount << " channels, " <<
+				format_.bitsPerSample << " bits per sample, " <<
+				format_.sampleRate << " Hz, block of " <<
+				format_.blockAlign << " bytes).");
+	} else if (format_.channelCount > 2) {
+		LOG_WARNING("WAV file has " << format_.channelCount <<
+				  " channels, only the first two are used.");
+	}
 	
 	streamInfo_.sampleRate = format_.sampleRate;
 }
@@ -66,88 +73,111 @@ void WAVStream::readFormatSubchunk(int size)
 /**
  *
  */
-void WAVStream::readInf1Subchunk(int size)
+void WAVStream::readInf1Subchunk(uint32_t size)
 {
 	inf1_ = readString(size);
 	cerr << inf1_ << endl;
 }
 
 
+/**
+ * Reads the 64-bit sizes of RF64 files.
+ */
+void WAVStream::readDS64Subchunk(uint32_t size)
+{
+	if (size < 16) {
+		readUnknownSubchunk(size);
+		return;
+	}
+	
+	readScalar<uint64_t>(); // RIFF size
+	dataSize64_ = readScalar<uint64_t>();
+	readUnknownSubchunk(size - 16);
+}
+
+
 /**
  *
  */
-void WAVStream::readDataSubchunk(int size)
+void WAVStream::readDataSubchunk(uint64_t size)
 {
-	int rawBufferSize = dataBufferSize_ * format_.blockAlign;
-	int bufferCount = size / rawBufferSize;
-	int bufferRemainder = size % rawBufferSize;
+	if (!formatRead_) {
+		readUnknownSubchunk(size);
+		return;
+	}
 	
-	dataBuffer_.resize(dataBufferSize_ * format_.channelCount);
-	outputBuffer_.resize(dataBufferSize_);
+	long frames = size / format_.blockAlign;
 	
-	for (int i = 0; i < bufferCount; i++) {
-		input_->getStream()->read((char*)&(dataBuffer_[0]), rawBufferSize);
+	// Frames of the chunk in the stream range (see Frontend::setRange())
+	// followed by the overlap the backend needs to finish the last FFT
+	// frames of the range.
+	long first = 0, last = frames;
+	if (hasRange()) {
+		long end = streamInfo_.startOffset + streamInfo_.length;
+		if (backend_.isNotNull()) end += backend_->getSegmentOverlap();
 		
-		for (int sample = 0; sample < dataBufferSize_; sample++) {
-			outputBuffer_[sample].real = (double)dataBuffer_[sample * 2];
-			outputBuffer_[sample].imag = (double)dataBuffer_[sample * 2 + 1];
-		}
-		
-		process(outputBuffer_);
-		//if (backend_.isNotNull()) {
-		//	backend_->process(outputBuffer_, dataInfo_);
-		//}
-		
-		//dataInfo_.offset += outputBuffer_.size();
-		//dataInfo_.timeOffset = dataInfo_.timeOffset.addSamples(
-		//	outputBuffer_.size(),
-		//	streamInfo_.sampleRate
-		//);
+		first = streamInfo_.startOffset - position_;
+		last  = end - position_;
+		if (first < 0) first = 0;
+		if (first > frames) first = frames;
+		if (last > frames) last = frames;
+		if (last < first) last = first;
 	}
+	position_ += frames;
 	
-	if (bufferRemainder > 0) {
-		int blockCount = bufferRemainder / format_.blockAlign;
-		int sampleCount = blockCount * format_.channelCount;
-		
-		input_->getStream()->read((char*)&(dataBuffer_[0]), bufferRemainder);
+	readUnknownSubchunk((uint64_t)first * format_.blockAlign);
+	
+	dataBuffer_.resize((long)dataBufferSize_ * format_.blockAlign);
+	
+	// The samples are passed to the backend as they are read, the backend
+	// converts them while windowing them. Only the first two channels are
+	// used, the rest is skipped using the stride of the span.
+	long i;
+	for (i = first; i < last; i += dataBufferSize_) {
+		int count = dataBufferSize_;
+		if (count > last - i) count = last - i;
 		
-		outputBuffer_.resize(sampleCount);
-		for (int sample = 0; sample < sampleCount; sample++) {
-			outputBuffer_[sample].real = (double)dataBuffer_[sample * 2];
-			outputBuffer_[sample].imag = (double)dataBuffer_[sample * 2 + 1];
-		}
-
-		process(outputBuffer_);
+		input_->getStream()->read(&(dataBuffer_[0]), (long)count * format_.blockAlign);
+		count = input_->getStream()->gcount() / format_.blockAlign;
+		if (count < 1) break;
 		
-		//if (backend_.isNotNull()) {
-		//	backend_->process(outputBuffer_, dataInfo_);
-		//}
-
-		//dataInfo_.offset += outputBuffer_.size();
-		//dataInfo_.timeOffset = dataInfo_.timeOffset.addSamples(
-		//	outputBuffer_.size(),
-		//	streamInfo_.sampleRate
-		//);
+		process(SampleSpan(sampleFormat_, &(dataBuffer_[0]), count, format_.blockAlign));
 	}
+	if (i > last) i = last;
+	
+	readUnknownSubchunk(size - (uint64_t)i * format_.blockAlign);
 }
 
 
 /**
  *
  */
-void WAVStream::readUnknownSubchunk(int size)
+void WAVStream::readUnknownSubchunk(uint64_t size)
 {
-	input_->getStream()->ignore(size);
+	if (size == 0) return;
+	
+	// Files are skipped by seeking, pipes by reading.
+	istream *stream = input_->getStream();
+	if (stream->seekg((streamoff)size, ios::cur)) return;
+	stream->clear();
+	
+	while (size > 0) {
+		uint64_t count = (size > 0x40000000) ? 0x40000000 : size;
+		input_->getStream()->ignore(count);
+		size -= count;
+	}
 }
 
 
 /**
- *
+ * \returns the size of the subchunk including its header
  */
-int WAVStream::readSubchunk()
+uint64_t WAVStream::readSubchunk()
 {
 	string subchunkId = readString(4);
-	int size = readInt32();
+	uint32_t size = readScalar<uint32_t>();
+	
+	if (!input_->getStream()->good()) return 8;
 	
 	//cerr << "CHUNK " << subchunkId << ", SIZE = " << size << endl;
 	
@@ -155,27 +185,59 @@ int WAVStream::readSubchunk()
 		readFormatSubchunk(size);
 	} else if (subchunkId.compare(WAVFormat::INF1_SUBCHUNK_ID) == 0) {
 		readInf1Subchunk(size);
+	} else if (subchunkId.compare(WAVFormat::DS64_SUBCHUNK_ID) == 0) {
+		readDS64Subchunk(size);
 	} else if (subchunkId.compare(WAVFormat::DATA_SUBCHUNK_ID) == 0) {
-		if (!dataRead_) {
+		uint64_t dataSize = size;
+		if ((size == WAVFormat::RF64_SIZE) && (dataSize64_ > 0))
+			dataSize = dataSize64_;
+		
+		// Without a supported format the data is skipped (see
+		// readDataSubchunk()) and the stream never starts.
+		if (!dataRead_ && formatRead_) {
+			// The file carries no time. Unless set, the start is estimated
+			// like by the MappedWAVFrontend, and taken as the time it is
+			// read for the input that is not a file.
+			struct stat st;
+			if (hasStartTime_) {
+				streamInfo_.timeOffset = startTime_;
+			} else if (!fileName_.empty() && (stat(fileName_.c_str(), &st) == 0)) {
+				streamInfo_.timeOffset = WAVFormat::estimateStartTime(
+					st.st_mtime, dataSize / format_.blockAlign, format_.sampleRate);
+			} else {
+				streamInfo_.timeOffset = Clock::getDefault()->now();
+			}
+			if (hasRange()) {
+				streamInfo_.length = dataSize / format_.blockAlign;
+				applyRange(backend_);
+			}
 			startStream();
 			//if (backend_.isNotNull())
 			//	backend_->startStream(streamInfo_);
 			dataRead_ = true;
 		}
-		readDataSubchunk(size);
+		
+		readDataSubchunk(dataSize);
+		
+		if (dataSize & 1) input_->getStream()->ignore(1);
+		return 8 + dataSize + (dataSize & 1);
 	} else {
 		readUnknownSubchunk(size);
 	}
 	
-	return size + 4;
+	// Chunks are padded to an even size.
+	if (size & 1) input_->getStream()->ignore(1);
+	
+	return 8 + (uint64_t)size + (size & 1);
 }
 
 
 /**
  * Constructor.
  */
-WAVStream::WAVStream(Ref<Input> input) :
-	input_(input), dataBufferSize_(1024)
+WAVStream::WAVStream(Ref<Input> input, const string &fileName) :
+	input_(input), fileName_(fileName), sampleFormat_(SAMPLE_COMPLEX_INT16), dataSize64_(0),
+	dataBufferSize_(1024), position_(0)
 {
 }
 
@@ -194,12 +256,22 @@ void WAVStream::run()
 	streamInfo_ = StreamInfo();
 	
 	string chunkId = readString(4);
-	if (chunkId.compare(WAVFormat::CHUNK_ID) != 0) {
-		cerr << "ERROR: Invalid chunk ID. Stream may not be in WAV format." << endl;
+	bool rf64 = ((chunkId.compare(WAVFormat::RF64_CHUNK_ID) == 0) ||
+			   (chunkId.compare(WAVFormat::BW64_CHUNK_ID) == 0));
+	if ((chunkId.compare(WAVFormat::CHUNK_ID) != 0) && !rf64) {
+		if (chunkId.compare(0, 4, (const char*)WAVFormat::W64_RIFF_GUID, 4) == 0) {
+			cerr << "ERROR: Wave64 files can only be read by the memory-mapped " <<
+				"reader (wav_reader = mmap)." << endl;
+		} else {
+			cerr << "ERROR: Invalid chunk ID. Stream may not be in WAV format." << endl;
+		}
 		return;
 	}
 	
-	int32_t chunkSize = readInt32();
+	// The size of RF64 files is in the "ds64" chunk, they are read until
+	// the end of the stream.
+	uint64_t chunkSize = readScalar<uint32_t>();
+	if (rf64) chunkSize = (uint64_t)-1;
 	
 	string chunkFormat = readString(4);
 	if (chunkFormat.compare(WAVFormat::CHUNK_FORMAT) != 0) {
@@ -211,14 +283,16 @@ void WAVStream::run()
 	
 	formatRead_ = false;
 	dataRead_ = false;
+	dataSize64_ = 0;
 	
 	dataInfo_ = DataInfo();
 	
-	while (chunkSize > 0) {
-		chunkSize -= readSubchunk();
+	while ((chunkSize > 8) && input_->getStream()->good()) {
+		uint64_t size = readSubchunk();
+		chunkSize = (size < chunkSize) ? (chunkSize - size) : 0;
 	}
 	
-	endStream();
+	if (dataRead_) endStream();
 	//if (backend_.isNotNull())
 	//	backend_->endStream();
 }
@@ -23,25 +23,7 @@ using namespace cppapp;
 
 #include "Frontend.h"
 #include "Backend.h"
-
-
-struct WAVFormat {
-	static const char *CHUNK_ID;
-	static const char *CHUNK_FORMAT;
-	
-	static const char *FORMAT_SUBCHUNK_ID;
-	static const char *INF1_SUBCHUNK_ID;
-	static const char *DATA_SUBCHUNK_ID;
-	
-	static const int FORMAT_SUBCHUNK_SIZE = 76;
-	
-	int audioFormat;
-	int channelCount;
-	int sampleRate;
-	int byteRate;
-	int blockAlign;
-	int bitsPerSample;
-};
+#include "WAVFormat.h"
 
 
 /**
@@ -50,6 +32,8 @@ struct WAVFormat {
 class WAVStream : public Frontend {
 private:
 	Ref<Input>      input_;
+	/// File the input reads, empty if it is not a file.
+	string          fileName_;
 
 	vector<char>    stringBuffer_;
 	
@@ -57,11 +41,17 @@ private:
 	bool            dataRead_;
 	
 	WAVFormat       format_;
+	SampleFormat    sampleFormat_;
 	string          inf1_;
 	
+	/// Size of the data chunk from the "ds64" chunk of RF64 files.
+	uint64_t        dataSize64_;
+	
 	int             dataBufferSize_;
-	vector<int16_t> dataBuffer_;
-	vector<Complex> outputBuffer_;
+	vector<char>    dataBuffer_;
+	
+	/// Number of frames in the data chunks read so far.
+	long            position_;
 	
 	template<class T>
 	T readScalar()
@@ -75,16 +65,24 @@ private:
 	int16_t readInt16();
 	string readString(int length);
 	
-	void readFormatSubchunk(int size);
-	void readInf1Subchunk(int size);
-	void readDataSubchunk(int size);
-	void readUnknownSubchunk(int size);
-	int readSubchunk();
+	void readFormatSubchunk(uint32_t size);
+	void readInf1Subchunk(uint32_t size);
+	void readDS64Subchunk(uint32_t size);
+	void readDataSubchunk(uint64_t size);
+	void readUnknownSubchunk(uint64_t size);
+	uint64_t readSubchunk();
 	
 	WAVStream(const WAVStream& other);
 	
 public:
-	WAVStream(Ref<Input> input);
+	/**
+	 * Constructor.
+	 *
+	 * \param input    the WAV data
+	 * \param fileName file \c input reads, for the estimate of the start
+	 *                 time (see WAVFormat::estimateStartTime())
+	 */
+	WAVStream(Ref<Input> input, const string &fileName = "");
 	virtual ~WAVStream() {}
 	
 	void setBackend(Ref<Backend> backend) { backend_ = backend; }
@@ -8,6 +8,9 @@
 
 #include "WFTime.h"
 
+#include <cstring>
+#include <cstdlib>
+
 
 /**
  * \note This function uses the `strftime` function as declared in the
@@ -34,3 +37,26 @@ string WFTime::format(const char *fmt, bool local) const
 }
 
 
+bool WFTime::parse(const string &text, WFTime *result)
+{
+	struct tm tm;
+	memset(&tm, 0, sizeof(tm));
+	
+	const char *end = strptime(text.c_str(), "%Y-%m-%d %H:%M:%S", &tm);
+	if (end == NULL) return false;
+	
+	long microseconds = 0;
+	if (*end == '.') {
+		char *fractionEnd;
+		double fraction = strtod(end, &fractionEnd);
+		if (fractionEnd == end + 1) return false;
+		microseconds = (long)(fraction * US_IN_SECOND + 0.5);
+		if (microseconds >= US_IN_SECOND) microseconds = US_IN_SECOND - 1;
+		end = fractionEnd;
+	}
+	if (*end != '\0') return false;
+	
+	*result = WFTime(timegm(&tm), microseconds);
+	return true;
+}
+
@@ -10,7 +10,9 @@
 #define WFTIME_20LZQV24
 
 #include <ostream>
+#include <string>
 #include <ctime>
+#include <stdint.h>
 
 using namespace std;
 
@@ -55,7 +57,7 @@ public:
 		time.tv_usec = (miliseconds % MS_IN_SECOND) * US_IN_MS;
 	}
 	
-	inline WFTime addMicroseconds(time_t us)
+	inline WFTime addMicroseconds(time_t us) const
 	{
 		WFTime result(time.tv_sec, time.tv_usec + us);
 		result.time.tv_sec += result.time.tv_usec / US_IN_SECOND;
@@ -63,15 +65,19 @@ public:
 		return result;
 	}
 	
-	inline WFTime addSamples(int sampleCount, int sampleRate)
+	/**
+	 * Returns the time \c sampleCount samples later.
+	 *
+	 * The time is computed in integers, floats lose the microsecond
+	 * precision after a few seconds of samples.
+	 */
+	inline WFTime addSamples(int64_t sampleCount, int sampleRate) const
 	{
-		long microseconds = (((float)sampleCount / (float)sampleRate) *
-						 (float)US_IN_SECOND);
-		return addMicroseconds(microseconds);
-		//return WFTime(
-		//	microseconds / US_IN_SECOND,
-		//	microseconds % US_IN_SECOND
-		//);
+		int64_t seconds = sampleCount / sampleRate;
+		int64_t rest    = sampleCount % sampleRate;
+		
+		WFTime result(time.tv_sec + seconds, time.tv_usec);
+		return result.addMicroseconds(rest * US_IN_SECOND / sampleRate);
 	}
 	
 	/**
@@ -86,6 +92,14 @@ public:
 	 */
 	string format(const char *fmt, bool local = false) const;
 	
+	/**
+	 * Parses a UTC time in the form "YYYY-MM-DD HH:MM:SS" with optional
+	 * fractional seconds.
+	 *
+	 * \returns \c false if the text is not a valid time
+	 */
+	static bool parse(const string &text, WFTime *result);
+	
 	inline static WFTime now()
 	{
 		WFTime result;
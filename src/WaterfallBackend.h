@@ -12,7 +12,9 @@
 
 #include "FFTBackend.h"
 #include "FITSWriter.h"
+#include "SpectrumSink.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
@@ -34,13 +36,15 @@ struct WaterfallBuffer {
 	vector<WFTime> times;
 	
 	int            mark;
+	/// Position (FFT frame number) of the first row, see placeRow().
+	long           start;
 	
 	WaterfallBuffer() :
-		size(0), bins(0), mark(0)
+		size(0), bins(0), mark(0), start(0)
 	{}
 	
 	WaterfallBuffer(int size, int bins) :
-		size(size), bins(bins), mark(0)
+		size(size), bins(bins), mark(0), start(0)
 	{
 		resize(size, bins);
 	}
@@ -100,6 +104,40 @@ struct WaterfallBuffer {
 		return row;
 	}
 	
+	/**
+	 * \brief Adds the row at position \c index of the stream (the FFT frame
+	 *        number, see DataInfo::offset).
+	 *
+	 * The first row of an empty buffer is at its start. The rows missing
+	 * before \c index (e.g. dropped) are filled with NaN, so each row stays
+	 * at its position and time.
+	 *
+	 * \param index   position of the row
+	 * \param time    time of the row
+	 * \param rowRate number of rows per second (for the times of the
+	 *                missing rows)
+	 * \returns the row to be filled, \c NULL if it is before the last row or
+	 *          after the end of the buffer (the buffer has to be written out
+	 *          and rewound first)
+	 */
+	float* placeRow(long index, WFTime time, float rowRate)
+	{
+		if (mark == 0) start = index;
+		
+		long row = index - start;
+		if ((row < mark) || (row >= size)) return NULL;
+		
+		for (; mark < row; mark++) {
+			times[mark] = times[0].addMicroseconds(
+				(time_t)((double)mark * US_IN_SECOND / rowRate));
+			fill(data.begin() + (long)bins * mark,
+				data.begin() + (long)bins * (mark + 1),
+				NAN);
+		}
+		
+		return addRow(time);
+	}
+	
 	float* getRow(int index)
 	{
 		assert(index >= 0);
@@ -176,68 +214,45 @@ public:
 
 
 /**
- * \todo Write documentation for class WaterfallBackend.
+ * \brief FFT backend computing magnitude rows and distributing them to the
+ *        subscribed sinks.
+ *
+ * The magnitude of each FFT result is computed once, with the halves of
+ * the spectrum swapped (the lowest frequency first). The row is then
+ * copied into the queue of every subscribed SpectrumSink (the snapshot
+ * writer, for example). Each sink is driven by its own thread, so a slow
+ * sink doesn't stall the FFT thread or the other sinks.
  */
 class WaterfallBackend : public FFTBackend {
 private:
 	WaterfallBackend(const WaterfallBackend& other);
 	
-	string           origin_;
-	
-	/// Snapshot length in seconds (determines the size of the buffer).
-	float            snapshotLength_;
-	
-	WaterfallBuffer  inBuffer_;
-	WaterfallBuffer  outBuffer_;
-	
-	float            leftFrequency_;
-	float            rightFrequency_;
-	int              leftBin_;
-	int              rightBin_;
-	
-	MethodThread<void, WaterfallBackend> *snapshotThread_;
-	Mutex                                 mutex_;
-	Condition                             snapshotCondition_;
-	bool                                  endSnapshotThread_;
-	
-	void writeHeader(fitsfile   *file,
-				  const char *keyword,
-				  int         type,
-				  void       *value,
-				  const char *comment,
-				  int        *status);
-	void writeHeader(fitsfile   *file,
-				  const char *keyword,
-				  const char *value,
-				  const char *comment,
-				  int        *status);
-	void writeHeader(fitsfile   *file,
-				  const char *keyword,
-				  float       value,
-				  const char *comment,
-				  int        *status);
-	void writeHeader(fitsfile   *file,
-				  const char *keyword,
-				  int         value,
-				  const char *comment,
-				  int        *status);
-	
-	void* snapshotThread();
-	void  makeSnapshot();
-	void  startSnapshot();
+	vector<float>           row_;
+	vector<Ref<SinkWorker> > sinks_;
+	
+	SpectrumInfo getSpectrumInfo(const StreamInfo &info);
 
 protected:
 	virtual void processFFT(const fftw_complex *data, int size, DataInfo info);
 	
 public:
-	WaterfallBackend(int bins,
-				  int overlap,
-				  string origin,
-				  float snapshotLength,
-				  float leftFrequency,
-				  float rightFrequency);
+	WaterfallBackend(int bins, int overlap);
 	virtual ~WaterfallBackend();
 	
+	/**
+	 * \brief Subscribes a sink to the magnitude rows.
+	 *
+	 * Sinks must be added before the stream is started.
+	 *
+	 * \param sink        the subscribed sink
+	 * \param queueLength length of the sink's queue in seconds
+	 */
+	void addSink(Ref<SpectrumSink> sink, float queueLength);
+	int  getSinkCount() const { return sinks_.size(); }
+	Ref<SinkWorker> getSinkWorker(int index) { return sinks_[index]; }
+	
+	virtual long getSegmentAlignment(const StreamInfo &info);
+	
 	virtual void startStream(StreamInfo info);
 	virtual void endStream();
 };
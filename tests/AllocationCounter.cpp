@@ -0,0 +1,59 @@
+/**
+ * \file   AllocationCounter.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Replacement of the global operator new counting the allocations.
+ */
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+
+#if __cplusplus >= 201103L
+#define THROWS_BAD_ALLOC
+#define THROWS_NOTHING   noexcept
+#else
+#define THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define THROWS_NOTHING   throw()
+#endif
+
+
+static long allocationCount = 0;
+
+
+long getAllocationCount()
+{
+	return __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+}
+
+
+void* operator new(size_t size) THROWS_BAD_ALLOC
+{
+	__atomic_add_fetch(&allocationCount, 1, __ATOMIC_RELAXED);
+	
+	void *result = malloc((size == 0) ? 1 : size);
+	if (result == NULL) throw std::bad_alloc();
+	return result;
+}
+
+
+void* operator new[](size_t size) THROWS_BAD_ALLOC
+{
+	return operator new(size);
+}
+
+
+void operator delete(void *ptr) THROWS_NOTHING
+{
+	free(ptr);
+}
+
+
+void operator delete[](void *ptr) THROWS_NOTHING
+{
+	free(ptr);
+}
+
@@ -0,0 +1,24 @@
+/**
+ * \file   AllocationCounter.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Heap allocation counter for the tests.
+ *
+ * The global \c operator \c new is replaced in AllocationCounter.cpp, so
+ * the counter covers all of the allocations made by the test program in
+ * all of its threads.
+ */
+
+#ifndef ALLOCATIONCOUNTER_6CWQ1ZJT
+#define ALLOCATIONCOUNTER_6CWQ1ZJT
+
+
+/**
+ * \brief Returns the number of heap allocations made so far.
+ */
+long getAllocationCount();
+
+
+#endif /* end of include guard: ALLOCATIONCOUNTER_6CWQ1ZJT */
+
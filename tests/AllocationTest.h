@@ -0,0 +1,139 @@
+/**
+ * \file   AllocationTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests checking that steady-state streaming doesn't allocate.
+ */
+
+#ifndef ALLOCATIONTEST_P4HZ8D1N
+#define ALLOCATIONTEST_P4HZ8D1N
+
+#include <cmath>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "AllocationCounter.h"
+
+#include "../src/Frontend.h"
+#include "../src/MultiBackend.h"
+#include "../src/WaterfallBackend.h"
+
+
+/**
+ * \brief Frontend feeding the same block of samples over and over.
+ */
+class RepeatingFrontend : public Frontend {
+private:
+	vector<Complex> block_;
+
+public:
+	RepeatingFrontend(int blockSize) :
+		block_(blockSize)
+	{
+		for (int i = 0; i < blockSize; i++) {
+			block_[i].real = cos(0.1 * i) * 1000.0;
+			block_[i].imag = sin(0.1 * i) * 1000.0;
+		}
+	}
+	
+	void start(int sampleRate)
+	{
+		streamInfo_ = StreamInfo();
+		streamInfo_.sampleRate = sampleRate;
+		startStream();
+	}
+	
+	void feed(int blockCount)
+	{
+		for (int i = 0; i < blockCount; i++)
+			process(SampleSpan(&(block_[0]), block_.size()));
+	}
+	
+	void end()
+	{
+		endStream();
+	}
+	
+	virtual void run() {}
+};
+
+
+/**
+ * \brief Sink counting the rows.
+ */
+class CountingSink : public SpectrumSink {
+public:
+	long rows;
+	
+	CountingSink() : rows(0) {}
+	
+	virtual void processRow(const float *row, DataInfo info) { rows++; }
+};
+
+
+class AllocationTest : public TestCase {
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(AllocationTest, testWaterfallBackend);
+		TEST_ADD(AllocationTest, testMultiBackend);
+	}
+	
+	/**
+	 * Feeds a few blocks to let the buffers reach their final sizes, then
+	 * checks that the following blocks don't allocate.
+	 */
+	void testSteadyState(Ref<Backend> backend)
+	{
+		RepeatingFrontend frontend(1024);
+		frontend.setBackend(backend);
+		frontend.start(48000);
+		
+		frontend.feed(32);
+		long before = getAllocationCount();
+		frontend.feed(2000);
+		long after = getAllocationCount();
+		
+		frontend.end();
+		
+		TEST_EQUALS(before, after,
+				  "steady-state streaming should not allocate memory");
+	}
+	
+	void testWaterfallBackend()
+	{
+		CountingSink *sink = new CountingSink();
+		WaterfallBackend *backend = new WaterfallBackend(1024, 768);
+		backend->addSink(sink, 10);
+		
+		testSteadyState(backend);
+		
+		TEST_ASSERT(sink->rows > 0, "the sink should have received rows");
+	}
+	
+	void testMultiBackend()
+	{
+		MultiBackend *backend = new MultiBackend(8);
+		CountingSink *sinks[2];
+		
+		for (int i = 0; i < 2; i++) {
+			sinks[i] = new CountingSink();
+			WaterfallBackend *child = new WaterfallBackend(512 << (i * 2), 256);
+			child->addSink(sinks[i], 10);
+			backend->addBackend(child);
+		}
+		
+		testSteadyState(backend);
+		
+		TEST_ASSERT(sinks[0]->rows > sinks[1]->rows,
+				  "the smaller FFT should have produced more rows");
+	}
+};
+
+RUN_SUITE(AllocationTest);
+
+
+#endif /* end of include guard: ALLOCATIONTEST_P4HZ8D1N */
+
@@ -0,0 +1,119 @@
+/**
+ * \file   BatchTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the batch processing of files.
+ */
+
+#ifndef BATCHTEST_W2GK6TRY
+#define BATCHTEST_W2GK6TRY
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <set>
+#include <string>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "MappedWAVFrontendTest.h"
+#include "../src/Batch.h"
+
+
+class BatchTest : public TestCase {
+private:
+	class CountingBackend : public Backend {
+	private:
+		long *samples_;
+
+	public:
+		CountingBackend(long *samples) : samples_(samples) {}
+
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			__sync_fetch_and_add(samples_, (long)data.length);
+		}
+	};
+
+	/**
+	 * \brief Reads the files by mapped frontends with counting backends.
+	 */
+	class Factory : public FrontendFactory {
+	public:
+		Mutex       mutex;
+		set<string> directories;
+		long        samples;
+
+		Factory() : samples(0) {}
+
+		virtual Ref<Frontend> createFrontend(const string &fileName,
+									  const string &outputDirectory)
+		{
+			{
+				MutexLock lock(&mutex);
+				directories.insert(outputDirectory);
+			}
+
+			Ref<Frontend> frontend = new MappedWAVFrontend(fileName, 100);
+			frontend->setBackend(new CountingBackend(&samples));
+			return frontend;
+		}
+	};
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(BatchTest, testDirectory);
+	}
+
+	/**
+	 * Processes a directory of files and a missing file.
+	 */
+	void testDirectory()
+	{
+		char directory[] = "/tmp/waterfall_test_XXXXXX";
+		TEST_ASSERT(mkdtemp(directory) != NULL, "failed to create a temporary directory");
+
+		string input  = string(directory) + "/input";
+		string output = string(directory) + "/output";
+		mkdir(input.c_str(), 0755);
+
+		const char *names[] = { "a.wav", "b.WAV", "c.wav", "ignored.txt" };
+		for (int i = 0; i < 4; i++)
+			writeTestWAV(input + "/" + names[i], 1000 * (i + 1), 8000);
+
+		Factory factory;
+		Ref<Batch> batch = new Batch(&factory, 2, output);
+		TEST_ASSERT(Batch::isBatchInput(input), "a directory is a batch");
+		TEST_ASSERT(batch->addInput(input), "no files found in the directory");
+		TEST_ASSERT(batch->addInput(input + "/missing.wav"), "a file is always added");
+		TEST_EQUALS(4, batch->getFileCount(), "wrong number of files");
+
+		TEST_EQUALS(1, batch->run(), "the missing file should fail");
+
+		TEST_EQUALS(6000L, factory.samples, "wrong number of samples processed");
+		TEST_EQUALS(4, (int)factory.directories.size(), "output directories not unique");
+
+		struct stat st;
+		TEST_ASSERT((stat((output + "/b").c_str(), &st) == 0) && S_ISDIR(st.st_mode),
+				  "output directory not created");
+
+		for (int i = 0; i < 4; i++)
+			unlink((input + "/" + names[i]).c_str());
+		rmdir(input.c_str());
+		const char *outputs[] = { "a", "b", "c", "missing" };
+		for (int i = 0; i < 4; i++)
+			rmdir((output + "/" + outputs[i]).c_str());
+		rmdir(output.c_str());
+		rmdir(directory);
+	}
+};
+
+RUN_SUITE(BatchTest);
+
+
+#endif /* end of include guard: BATCHTEST_W2GK6TRY */
+
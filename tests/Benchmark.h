@@ -0,0 +1,125 @@
+/**
+ * \file   Benchmark.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Helpers for the microbenchmarks.
+ */
+
+#ifndef BENCHMARK_5MZR8KWA
+#define BENCHMARK_5MZR8KWA
+
+#include <time.h>
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+/**
+ * \brief Monotonic stopwatch.
+ */
+class Stopwatch {
+private:
+	struct timespec start_;
+
+public:
+	Stopwatch() { restart(); }
+	
+	void restart() { clock_gettime(CLOCK_MONOTONIC, &start_); }
+	
+	/// Returns the number of seconds since the (re)start.
+	double seconds() const
+	{
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return ((double)(now.tv_sec - start_.tv_sec) +
+			   (double)(now.tv_nsec - start_.tv_nsec) * 1e-9);
+	}
+};
+
+
+/// Number of times each of the shorter benchmarks is repeated.
+#define BENCHMARK_RUNS 5
+
+
+/**
+ * \brief Returns whether the results are printed as JSON lines (see
+ *        reportBenchmark()).
+ */
+inline bool& benchmarkJSON()
+{
+	static bool json = false;
+	return json;
+}
+
+
+/**
+ * \brief Returns the median of the durations of repeated runs.
+ */
+inline double medianSeconds(vector<double> runs)
+{
+	if (runs.empty()) return 0;
+	sort(runs.begin(), runs.end());
+	return runs[runs.size() / 2];
+}
+
+
+/**
+ * \brief Returns \c text quoted as a JSON string.
+ */
+inline string quoteJSON(const string &text)
+{
+	string result = "\"";
+	for (unsigned i = 0; i < text.size(); i++) {
+		if ((text[i] == '"') || (text[i] == '\\')) result += '\\';
+		result += text[i];
+	}
+	return result + "\"";
+}
+
+
+/**
+ * \brief Prints the result of a benchmark as a single line, a table row or
+ *        a JSON object (see benchmarkJSON()).
+ *
+ * \param name      name of the benchmark
+ * \param items     number of processed items
+ * \param itemSize  size of an item in bytes
+ * \param seconds   duration of the benchmark (the median of the runs)
+ * \param runs      number of runs the duration is the median of
+ */
+inline void reportBenchmark(const string &name, long items, int itemSize, double seconds,
+					   int runs = 1)
+{
+	double itemRate = (double)items / seconds;
+	double byteRate = (double)items * itemSize / seconds;
+	
+	if (benchmarkJSON()) {
+		cout << setprecision(6)
+		     << "{\"name\": " << quoteJSON(name)
+		     << ", \"items\": " << items
+		     << ", \"item_size\": " << itemSize
+		     << ", \"runs\": " << runs
+		     << ", \"seconds\": " << seconds
+		     << ", \"items_per_second\": " << itemRate
+		     << ", \"bytes_per_second\": " << byteRate
+		     << ", \"ns_per_item\": " << (seconds * 1e9 / items)
+		     << "}" << endl;
+		return;
+	}
+	
+	cout << left << setw(40) << name << right << fixed << setprecision(1)
+	     << setw(12) << (itemRate / 1e6) << " Mitems/s"
+	     << setw(12) << (byteRate / 1e6) << " MB/s"
+	     << setw(12) << setprecision(2) << (seconds * 1e9 / items) << " ns/item"
+	     << endl;
+}
+
+
+#endif /* end of include guard: BENCHMARK_5MZR8KWA */
+
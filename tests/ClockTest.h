@@ -0,0 +1,157 @@
+/**
+ * \file   ClockTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the replay clock and the paced replay of WAV files.
+ */
+
+#ifndef CLOCKTEST_W5HN8DQT
+#define CLOCKTEST_W5HN8DQT
+
+#include <ctime>
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/Clock.h"
+#include "../src/MappedWAVFrontend.h"
+#include "MappedWAVFrontendTest.h"
+
+
+class ClockTest : public TestCase {
+private:
+	/**
+	 * \brief Checks that no block arrives before the clock reaches the time
+	 *        of its last sample.
+	 */
+	class CheckingBackend : public Backend {
+	public:
+		Ref<Clock> clock;
+		bool       realTime;
+		bool       early;
+		long       samples;
+
+		CheckingBackend(Ref<Clock> clock) :
+			clock(clock), realTime(false), early(false), samples(0) {}
+
+		virtual void startStream(StreamInfo info)
+		{
+			Backend::startStream(info);
+			realTime = info.realTime;
+		}
+
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			WFTime end = info.timeOffset.addSamples(data.length, streamInfo_.sampleRate);
+			WFTime now = clock->now();
+			if ((now.seconds() < end.seconds()) ||
+			    ((now.seconds() == end.seconds()) &&
+			     (now.microseconds() < end.microseconds())))
+				early = true;
+			samples += data.length;
+		}
+	};
+
+	static double secondsSince(const struct timespec &start)
+	{
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) * 1e-9;
+	}
+
+	/**
+	 * Replays a one second long file and returns the wall time it took.
+	 */
+	double replay(Ref<ReplayClock> clock, Ref<Backend> backend)
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		if (fd < 0) return -1;
+		close(fd);
+
+		writeTestWAV(fileName, 48000, 48000);
+
+		Ref<MappedWAVFrontend> frontend = new MappedWAVFrontend(fileName, 4800);
+		frontend->setBackend(backend);
+		frontend->setStartTime(WFTime(1000000000, 0));
+		frontend->setPacingClock(clock);
+
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		frontend->run();
+		double seconds = secondsSince(start);
+
+		unlink(fileName);
+		return seconds;
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(ClockTest, testReplayClock);
+		TEST_ADD(ClockTest, testReplay);
+		TEST_ADD(ClockTest, testUnlimitedReplay);
+	}
+
+	void testReplayClock()
+	{
+		Ref<ReplayClock> unlimited = new ReplayClock(0);
+		unlimited->synchronize(WFTime(100, 0));
+		unlimited->sleepUntil(WFTime(3600, 500));
+		TEST_EQUALS(3600, unlimited->now().seconds(), "the clock did not jump");
+		TEST_EQUALS(500, unlimited->now().microseconds(), "the clock did not jump");
+		unlimited->sleepUntil(WFTime(200, 0));
+		TEST_EQUALS(3600, unlimited->now().seconds(), "the clock went back");
+
+		Ref<ReplayClock> fast = new ReplayClock(20);
+		fast->synchronize(WFTime(100, 0));
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		fast->sleepUntil(WFTime(101, 0));
+		double seconds = secondsSince(start);
+		TEST_ASSERT((seconds >= 0.045) && (seconds < 0.5), "wrong sleep at 20x");
+		TEST_ASSERT(fast->now().seconds() >= 101, "the clock is behind");
+	}
+
+	/**
+	 * A second of samples replayed at 10x takes a tenth of a second.
+	 */
+	void testReplay()
+	{
+		Ref<ReplayClock> clock = new ReplayClock(10);
+		CheckingBackend *backend = new CheckingBackend(clock);
+		Ref<Backend> backendRef = backend;
+
+		double seconds = replay(clock, backendRef);
+
+		TEST_ASSERT(backend->realTime, "a replayed stream should be real-time");
+		TEST_ASSERT(!backend->early, "a block arrived early");
+		TEST_EQUALS(48000, backend->samples, "wrong number of samples");
+		TEST_ASSERT((seconds >= 0.09) && (seconds < 0.9), "the replay was not paced");
+	}
+
+	/**
+	 * At unlimited speed, the clock follows the samples.
+	 */
+	void testUnlimitedReplay()
+	{
+		Ref<ReplayClock> clock = new ReplayClock(0);
+		CheckingBackend *backend = new CheckingBackend(clock);
+		Ref<Backend> backendRef = backend;
+
+		replay(clock, backendRef);
+
+		TEST_ASSERT(!backend->early, "a block arrived early");
+		TEST_EQUALS(48000, backend->samples, "wrong number of samples");
+		TEST_EQUALS(1000000001, clock->now().seconds(), "the clock does not follow the samples");
+		TEST_EQUALS(0, clock->now().microseconds(), "the clock does not follow the samples");
+	}
+};
+
+RUN_SUITE(ClockTest);
+
+
+#endif /* end of include guard: CLOCKTEST_W5HN8DQT */
+
@@ -0,0 +1,172 @@
+/**
+ * \file   DSPBench.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Benchmarks of the FFT frame loop, the magnitudes and the
+ *         waterfall buffer.
+ */
+
+#ifndef DSPBENCH_T6GW1MRC
+#define DSPBENCH_T6GW1MRC
+
+#include <stdint.h>
+
+#include <sstream>
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/FFTBackend.h"
+#include "../src/WaterfallBackend.h"
+#include "Benchmark.h"
+
+
+/**
+ * \brief Waterfall backend without sinks with the magnitude computation
+ *        exposed.
+ */
+class MagnitudeBench : public WaterfallBackend {
+public:
+	MagnitudeBench(int bins) : WaterfallBackend(bins, 0) {}
+	
+	void run(const fftw_complex *data, int size)
+	{
+		processFFT(data, size, DataInfo());
+	}
+};
+
+
+/**
+ * Returns the description of a 48 kHz stream.
+ */
+inline StreamInfo makeBenchStream()
+{
+	StreamInfo info;
+	info.sampleRate = 48000;
+	info.timeOffset = WFTime(1000000000, 0);
+	return info;
+}
+
+
+/**
+ * The whole frame loop of FFTBackend::process() (copying, windowing, FFT)
+ * for 16-bit samples in blocks of 8192, across FFT sizes and overlaps.
+ */
+inline void benchmarkFFTBackend()
+{
+	const long samples = 16L * 1024 * 1024;
+	const int  blockSize = 8192;
+	
+	vector<int16_t> block(2 * blockSize);
+	uint32_t random = 1;
+	for (unsigned i = 0; i < block.size(); i++) {
+		random = random * 1664525 + 1013904223;
+		block[i] = (int16_t)((i % 64) * 256 + (random >> 24));
+	}
+	
+	int    binCounts[] = { 1024, 4096, 32768 };
+	double overlaps[]  = { 0, 0.5, 0.75 };
+	
+	for (unsigned i = 0; i < sizeof(binCounts) / sizeof(binCounts[0]); i++) {
+		for (unsigned j = 0; j < sizeof(overlaps) / sizeof(overlaps[0]); j++) {
+			int bins = binCounts[i];
+			int overlap = (int)(bins * overlaps[j]);
+			
+			Ref<FFTBackend> backend = new FFTBackend(bins, overlap);
+			vector<double> runs;
+			
+			for (int run = 0; run < BENCHMARK_RUNS; run++) {
+				backend->startStream(makeBenchStream());
+				
+				DataInfo info;
+				Stopwatch stopwatch;
+				for (long k = 0; k < samples; k += blockSize) {
+					info.offset = k;
+					backend->process(SampleSpan(SAMPLE_COMPLEX_INT16, &(block[0]), blockSize),
+								  info);
+				}
+				runs.push_back(stopwatch.seconds());
+				
+				backend->endStream();
+			}
+			
+			ostringstream name;
+			name << "FFTBackend/bins=" << bins << "/overlap=" << overlap;
+			reportBenchmark(name.str(), samples, 2 * sizeof(int16_t), medianSeconds(runs),
+						 BENCHMARK_RUNS);
+		}
+	}
+}
+
+
+/**
+ * WaterfallBackend::processFFT() (magnitudes and the swap of the halves)
+ * without sinks.
+ */
+inline void benchmarkMagnitude()
+{
+	int binCounts[] = { 1024, 32768 };
+	
+	for (unsigned i = 0; i < sizeof(binCounts) / sizeof(binCounts[0]); i++) {
+		int  bins = binCounts[i];
+		long frames = (64L * 1024 * 1024) / bins;
+		
+		vector<double> spectrum(2 * bins);
+		for (int j = 0; j < 2 * bins; j++)
+			spectrum[j] = (double)(j % 97) - 48.0;
+		
+		Ref<MagnitudeBench> backend = new MagnitudeBench(bins);
+		vector<double> runs;
+		
+		for (int run = 0; run < BENCHMARK_RUNS; run++) {
+			Stopwatch stopwatch;
+			for (long k = 0; k < frames; k++)
+				backend->run((const fftw_complex*)&(spectrum[0]), bins);
+			runs.push_back(stopwatch.seconds());
+		}
+		
+		ostringstream name;
+		name << "processFFT/bins=" << bins;
+		reportBenchmark(name.str(), frames * bins, sizeof(fftw_complex), medianSeconds(runs),
+					 BENCHMARK_RUNS);
+	}
+}
+
+
+/**
+ * Filling the WaterfallBuffer of a snapshot row by row (as
+ * SnapshotSink::processRow() does) and swapping it with another buffer.
+ */
+inline void benchmarkWaterfallBuffer()
+{
+	const int bins = 4096;
+	const int rows = 512;
+	const int fills = 200;
+	
+	vector<float> row(bins, 1.0f);
+	WaterfallBuffer buffer(rows, bins);
+	WaterfallBuffer other(rows, bins);
+	vector<double> runs;
+	
+	for (int run = 0; run < BENCHMARK_RUNS; run++) {
+		Stopwatch stopwatch;
+		for (int i = 0; i < fills; i++) {
+			while (!buffer.isFull()) {
+				float *target = buffer.addRow(WFTime(i, buffer.mark));
+				memcpy(target, &(row[0]), bins * sizeof(float));
+			}
+			buffer.swap(other);
+			buffer.rewind();
+		}
+		runs.push_back(stopwatch.seconds());
+	}
+	
+	reportBenchmark("WaterfallBuffer/addRow+swap/bins=4096", (long)fills * rows,
+				 bins * sizeof(float), medianSeconds(runs), BENCHMARK_RUNS);
+}
+
+
+#endif /* end of include guard: DSPBENCH_T6GW1MRC */
+
@@ -0,0 +1,141 @@
+/**
+ * \file   DeadlineMonitorTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the deadline monitor.
+ */
+
+#ifndef DEADLINEMONITORTEST_B8QF3NVS
+#define DEADLINEMONITORTEST_B8QF3NVS
+
+#include <sstream>
+#include <string>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/DeadlineMonitor.h"
+
+
+class DeadlineMonitorTest : public TestCase {
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(DeadlineMonitorTest, testUtilization);
+		TEST_ADD(DeadlineMonitorTest, testXruns);
+		TEST_ADD(DeadlineMonitorTest, testCheck);
+		TEST_ADD(DeadlineMonitorTest, testIntervalMax);
+	}
+
+	/**
+	 * Periods of 1024 frames at 48 kHz (21.33 ms).
+	 */
+	void testUtilization()
+	{
+		DeadlineMonitor monitor(0.8, 0.5);
+		monitor.setSampleRate(48000);
+		uint64_t period = 1024ULL * 1000000000ULL / 48000;
+
+		// 990 callbacks at 10 %, 9 at 90 % and one at 150 %.
+		uint64_t time = 1000000000ULL;
+		for (int i = 0; i < 1000; i++) {
+			uint64_t length = period / 10;
+			if (i >= 990) length = period * 9 / 10;
+			if (i == 999) length = period * 3 / 2;
+			monitor.record(time, time + length, 1024);
+			time += period;
+		}
+
+		DeadlineStats stats;
+		monitor.getStats(&stats);
+
+		TEST_EQUALS(1000, stats.count, "wrong count");
+		TEST_EQUALS(10, stats.nearMisses, "wrong near misses");
+		TEST_EQUALS(1, stats.misses, "wrong misses");
+		TEST_ASSERT((stats.getPercentile(0.5) > 0.09) && (stats.getPercentile(0.5) <= 0.105),
+				  "wrong median");
+		TEST_ASSERT((stats.getPercentile(0.995) > 0.89) &&
+				  (stats.getPercentile(0.995) <= 0.905), "wrong 99.5th percentile");
+		TEST_ASSERT((stats.getMax() > 1.49) && (stats.getMax() < 1.51), "wrong maximum");
+		TEST_ASSERT(stats.getPercentile(1.0) == stats.getMax(), "wrong 100th percentile");
+	}
+
+	void testXruns()
+	{
+		DeadlineMonitor monitor(0.8, 0.5);
+		monitor.setSampleRate(48000);
+		uint64_t period = 1024ULL * 1000000000ULL / 48000;
+
+		// An xrun without a near miss.
+		monitor.record(1000000000ULL, 1000000000ULL + period / 10, 1024);
+		monitor.recordXrun(1000000000ULL + period);
+
+		// A near miss followed by an xrun, and another one much later.
+		uint64_t time = 2000000000ULL;
+		monitor.record(time, time + period * 95 / 100, 1024);
+		monitor.recordXrun(time + 2 * period);
+		monitor.recordXrun(time + 100 * period);
+
+		DeadlineStats stats;
+		monitor.getStats(&stats);
+
+		TEST_EQUALS(3, stats.xruns, "wrong xruns");
+		TEST_EQUALS(1, stats.correlatedXruns, "wrong correlated xruns");
+	}
+
+	/**
+	 * Only the callbacks since the last check are considered.
+	 */
+	void testCheck()
+	{
+		DeadlineMonitor monitor(0.8, 0.5);
+		monitor.setSampleRate(48000);
+		uint64_t period = 1024ULL * 1000000000ULL / 48000;
+		DeadlineStats previous;
+
+		TEST_ASSERT(!monitor.check(&previous), "warning without callbacks");
+
+		for (int i = 0; i < 100; i++)
+			monitor.record(0, period * 6 / 10, 1024);
+		TEST_ASSERT(monitor.check(&previous), "no warning over the threshold");
+
+		for (int i = 0; i < 100; i++)
+			monitor.record(0, period / 10, 1024);
+		TEST_ASSERT(!monitor.check(&previous), "warning under the threshold");
+
+		stringstream text;
+		previous.write(text);
+		TEST_ASSERT(text.str().find("200 callbacks") == 0, "wrong summary");
+	}
+	
+	/**
+	 * The maximum of an interval is not that of the earlier ones.
+	 */
+	void testIntervalMax()
+	{
+		DeadlineMonitor monitor(0.8, 0.5);
+		monitor.setSampleRate(48000);
+		uint64_t period = 1024ULL * 1000000000ULL / 48000;
+		DeadlineStats previous, interval;
+
+		monitor.record(0, period * 3 / 2, 1024);
+		monitor.check(&previous, &interval);
+		TEST_ASSERT(interval.getMax() > 1.49, "wrong maximum of the spike");
+
+		for (int i = 0; i < 100; i++)
+			monitor.record(0, period / 10, 1024);
+		monitor.check(&previous, &interval);
+		TEST_ASSERT((interval.getMax() > 0.09) && (interval.getMax() < 0.11),
+				  "maximum of an earlier interval");
+		TEST_ASSERT(interval.getPercentile(1.0) == interval.getMax(),
+				  "wrong 100th percentile");
+		TEST_ASSERT(previous.getMax() > 1.49, "wrong lifetime maximum");
+	}
+};
+
+RUN_SUITE(DeadlineMonitorTest);
+
+
+#endif /* end of include guard: DEADLINEMONITORTEST_B8QF3NVS */
+
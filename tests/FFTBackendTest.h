@@ -0,0 +1,89 @@
+/**
+ * \file   FFTBackendTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the framing of the FFT backend.
+ */
+
+#ifndef FFTBACKENDTEST_W2HQ8NCD
+#define FFTBACKENDTEST_W2HQ8NCD
+
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/FFTBackend.h"
+
+
+class FFTBackendTest : public TestCase {
+private:
+	/**
+	 * \brief Collects the positions and times of the frames.
+	 */
+	class CollectingBackend : public FFTBackend {
+	public:
+		vector<long>   offsets;
+		vector<WFTime> times;
+
+		CollectingBackend(int bins, int overlap) : FFTBackend(bins, overlap) {}
+
+	protected:
+		virtual void processFFT(const fftw_complex *data, int size, DataInfo info)
+		{
+			offsets.push_back(info.offset);
+			times.push_back(info.timeOffset);
+		}
+	};
+
+	void processBlock(Ref<FFTBackend> backend, long offset, int length)
+	{
+		vector<float> samples(2 * length, 1.0f);
+		DataInfo info;
+		info.offset = offset;
+		backend->process(SampleSpan(SAMPLE_COMPLEX_FLOAT, &(samples[0]), length), info);
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(FFTBackendTest, testGap);
+	}
+
+	/**
+	 * Frames of 8 samples with a hop of 4, samples 10 to 16 are missing.
+	 * The samples before the gap are not joined with those after it, and
+	 * the frames after it stay on the grid of the hop.
+	 */
+	void testGap()
+	{
+		CollectingBackend *backend = new CollectingBackend(8, 4);
+		Ref<FFTBackend> backendRef = backend;
+
+		StreamInfo info;
+		info.sampleRate = 1000;
+		info.timeOffset = WFTime(1000, 0);
+		info.realTime = true;
+		backend->startStream(info);
+
+		processBlock(backendRef, 0, 10);
+		processBlock(backendRef, 17, 20);
+		processBlock(backendRef, 37, 3);
+		backend->endStream();
+
+		long expected[] = { 0, 5, 6, 7, 8 };
+		TEST_EQUALS(5, backend->offsets.size(), "wrong number of frames");
+		for (unsigned i = 0; (i < 5) && (i < backend->offsets.size()); i++) {
+			TEST_EQUALS(expected[i], backend->offsets[i], "wrong frame position");
+			TEST_EQUALS(1000, backend->times[i].seconds(), "wrong frame time");
+			TEST_EQUALS(expected[i] * 4000, backend->times[i].microseconds(),
+					  "wrong frame time");
+		}
+	}
+};
+
+RUN_SUITE(FFTBackendTest);
+
+
+#endif /* end of include guard: FFTBACKENDTEST_W2HQ8NCD */
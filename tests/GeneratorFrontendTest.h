@@ -0,0 +1,200 @@
+/**
+ * \file   GeneratorFrontendTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the signal generator frontend.
+ */
+
+#ifndef GENERATORFRONTENDTEST_M6PJ2VXA
+#define GENERATORFRONTENDTEST_M6PJ2VXA
+
+#include <cmath>
+#include <ctime>
+
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/GeneratorFrontend.h"
+#include "../src/Metrics.h"
+
+
+class GeneratorFrontendTest : public TestCase {
+private:
+	class CollectingBackend : public Backend {
+	public:
+		vector<float> samples;
+		bool          realTime;
+		bool          offsetsOk;
+
+		CollectingBackend() : realTime(true), offsetsOk(true) {}
+
+		virtual void startStream(StreamInfo info)
+		{
+			Backend::startStream(info);
+			realTime = info.realTime;
+		}
+
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			if ((data.format != SAMPLE_COMPLEX_FLOAT) ||
+			    (info.offset != (long)samples.size() / 2))
+				offsetsOk = false;
+
+			const float *values = (const float*)data.data;
+			samples.insert(samples.end(), values, values + 2 * data.length);
+		}
+	};
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(GeneratorFrontendTest, testParse);
+		TEST_ADD(GeneratorFrontendTest, testTone);
+		TEST_ADD(GeneratorFrontendTest, testPulse);
+		TEST_ADD(GeneratorFrontendTest, testRealTime);
+		TEST_ADD(GeneratorFrontendTest, testClockDrift);
+	}
+
+	void testParse()
+	{
+		GeneratorFrontend::Signal signal;
+
+		TEST_ASSERT(GeneratorFrontend::parseSignal("chirp 1000 -500 0.3 2 0.8", &signal),
+				  "valid chirp not parsed");
+		TEST_EQUALS(GeneratorFrontend::Signal::SIGNAL_CHIRP, signal.type, "wrong type");
+		TEST_EQUALS(-500.0, signal.endFrequency, "wrong end frequency");
+		TEST_EQUALS(0.8, signal.amplitude, "wrong amplitude");
+
+		TEST_ASSERT(GeneratorFrontend::parseSignal(" noise ", &signal), "noise not parsed");
+		TEST_EQUALS(0.5, signal.amplitude, "wrong default amplitude");
+
+		TEST_ASSERT(!GeneratorFrontend::parseSignal("tone", &signal),
+				  "tone without a frequency accepted");
+		TEST_ASSERT(!GeneratorFrontend::parseSignal("tone 1000 0.5 1", &signal),
+				  "too many values accepted");
+		TEST_ASSERT(!GeneratorFrontend::parseSignal("tone 1kHz", &signal),
+				  "invalid number accepted");
+		TEST_ASSERT(!GeneratorFrontend::parseSignal("pulse 1000 0 1", &signal),
+				  "empty pulse accepted");
+		TEST_ASSERT(!GeneratorFrontend::parseSignal("sweep 1000", &signal),
+				  "unknown signal accepted");
+
+		Ref<GeneratorFrontend> frontend = new GeneratorFrontend(48000);
+		TEST_ASSERT(frontend->addSignals("tone 1000; noise 0.1;"), "valid list not parsed");
+		TEST_ASSERT(!frontend->addSignals("tone 1000; nois 0.1"), "invalid list accepted");
+	}
+
+	/**
+	 * The tone is continuous across the blocks.
+	 */
+	void testTone()
+	{
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+
+		Ref<GeneratorFrontend> frontend = new GeneratorFrontend(10000, 999);
+		frontend->setBackend(backendRef);
+		frontend->addSignals("tone -1250 0.5");
+		frontend->setDuration(0.5);
+		frontend->setRealTime(false);
+		frontend->run();
+
+		TEST_ASSERT(!backend->realTime, "the stream should not be real-time");
+		TEST_ASSERT(backend->offsetsOk, "wrong format or offset of a block");
+		TEST_EQUALS(2 * 5000, backend->samples.size(), "wrong number of samples");
+		TEST_EQUALS(5000, frontend->getProcessedLength(), "wrong processed length");
+
+		double error = 0;
+		for (int i = 0; i < 5000; i++) {
+			double phase = -2.0 * M_PI * 1250.0 * i / 10000.0;
+			error = fmax(error, fabs(backend->samples[2 * i] - 0.5 * cos(phase)));
+			error = fmax(error, fabs(backend->samples[2 * i + 1] - 0.5 * sin(phase)));
+		}
+		TEST_ASSERT(error < 1e-5, "the tone differs");
+	}
+
+	/**
+	 * The pulses are where they should be.
+	 */
+	void testPulse()
+	{
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+
+		Ref<GeneratorFrontend> frontend = new GeneratorFrontend(10000, 4096);
+		frontend->setBackend(backendRef);
+		frontend->addSignals("pulse 500 0.01 0.1 1");
+		frontend->setDuration(1);
+		frontend->setRealTime(false);
+		frontend->run();
+
+		TEST_EQUALS(2 * 10000, backend->samples.size(), "wrong number of samples");
+
+		bool ok = true;
+		for (int i = 0; i < 10000; i++) {
+			double magnitude = hypot(backend->samples[2 * i], backend->samples[2 * i + 1]);
+			bool inPulse = (i % 1000) < 100;
+			if (fabs(magnitude - (inPulse ? 1.0 : 0.0)) > 1e-5) ok = false;
+		}
+		TEST_ASSERT(ok, "the pulses differ");
+	}
+
+	/**
+	 * A paced stream takes (at least) its duration.
+	 */
+	void testRealTime()
+	{
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+
+		Ref<GeneratorFrontend> frontend = new GeneratorFrontend(10000, 500);
+		frontend->setBackend(backendRef);
+		frontend->addSignals("noise");
+		frontend->setDuration(0.2);
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		frontend->run();
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+		TEST_ASSERT(backend->realTime, "the stream should be real-time");
+		TEST_EQUALS(2 * 2000, backend->samples.size(), "wrong number of samples");
+		TEST_ASSERT(seconds >= 0.2, "the samples were not paced");
+	}
+
+	/**
+	 * A live stream which started 100 s ago by the wall clock but has only
+	 * 20 s of samples is 80 s behind the clock.
+	 */
+	void testClockDrift()
+	{
+		Ref<GeneratorFrontend> frontend = new GeneratorFrontend(100, 100);
+		frontend->setBackend(new CollectingBackend());
+		frontend->addSignals("noise");
+		frontend->setDuration(20);
+		frontend->setRealTime(false);
+		// Paced to a clock that jumps to the samples, so the stream is live
+		// but takes no time.
+		frontend->setPacingClock(new ReplayClock(0));
+		frontend->setStartTime(WFTime(WFTime::now().seconds() - 100, 0));
+		frontend->run();
+
+		MetricsSnapshot *snapshot = new MetricsSnapshot();
+		Metrics::getSnapshot(snapshot);
+		int64_t drift = snapshot->gauges[GAUGE_CLOCK_DRIFT];
+		delete snapshot;
+
+		TEST_ASSERT((drift > 79000000) && (drift < 82000000), "wrong clock drift");
+	}
+};
+
+RUN_SUITE(GeneratorFrontendTest);
+
+
+#endif /* end of include guard: GENERATORFRONTENDTEST_M6PJ2VXA */
+
@@ -0,0 +1,426 @@
+/**
+ * \file   MappedWAVFrontendTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the memory-mapped WAV frontend.
+ */
+
+#ifndef MAPPEDWAVFRONTENDTEST_F8LC3ZRA
+#define MAPPEDWAVFRONTENDTEST_F8LC3ZRA
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <utime.h>
+
+#include <string>
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/MappedWAVFrontend.h"
+#include "../src/WAVStream.h"
+#include "../src/SampleConversion.h"
+
+
+/**
+ * \brief Writes a 16-bit stereo WAV file with \c frames frames and an extra
+ *        odd-sized chunk before the data.
+ */
+inline bool writeTestWAV(const string &fileName, long frames, int sampleRate,
+					vector<int16_t> *samples = NULL)
+{
+	FILE *file = fopen(fileName.c_str(), "wb");
+	if (file == NULL) return false;
+	
+	uint32_t dataSize   = frames * 4;
+	uint32_t listSize   = 3;
+	uint32_t fmtSize    = 16;
+	uint32_t riffSize   = 4 + (8 + fmtSize) + (8 + listSize + 1) + (8 + dataSize);
+	int16_t  audioFormat = 1, channels = 2, blockAlign = 4, bits = 16;
+	int32_t  byteRate = sampleRate * blockAlign;
+	
+	fwrite("RIFF", 1, 4, file); fwrite(&riffSize, 4, 1, file);
+	fwrite("WAVE", 1, 4, file);
+	
+	fwrite("fmt ", 1, 4, file); fwrite(&fmtSize, 4, 1, file);
+	fwrite(&audioFormat, 2, 1, file); fwrite(&channels, 2, 1, file);
+	fwrite(&sampleRate, 4, 1, file); fwrite(&byteRate, 4, 1, file);
+	fwrite(&blockAlign, 2, 1, file); fwrite(&bits, 2, 1, file);
+	
+	fwrite("LIST", 1, 4, file); fwrite(&listSize, 4, 1, file);
+	fwrite("ab\0\0", 1, listSize + 1, file);
+	
+	fwrite("data", 1, 4, file); fwrite(&dataSize, 4, 1, file);
+	
+	vector<int16_t> block(2048);
+	for (long i = 0; i < frames * 2; i += block.size()) {
+		long count = frames * 2 - i;
+		if (count > (long)block.size()) count = block.size();
+		
+		for (long j = 0; j < count; j++) {
+			block[j] = (int16_t)(((i + j) * 7919) & 0xffff);
+			if (samples != NULL) samples->push_back(block[j]);
+		}
+		fwrite(&(block[0]), 2, count, file);
+	}
+	
+	return (fclose(file) == 0);
+}
+
+
+/**
+ * \brief Builds WAV files of all of the supported variants in memory.
+ */
+class TestWAVWriter {
+public:
+	enum Container { RIFF, RF64, W64 };
+	
+	vector<char> bytes;
+	
+	template<class T>
+	void put(T value)
+	{
+		bytes.insert(bytes.end(), (const char*)&value, (const char*)&value + sizeof(T));
+	}
+	
+	void put(const void *data, int size)
+	{
+		bytes.insert(bytes.end(), (const char*)data, (const char*)data + size);
+	}
+	
+	/// Encodes \c value in the given format (bits and float flag).
+	void putSample(double value, int bits, bool isFloat)
+	{
+		if (isFloat && (bits == 32)) {
+			put((float)value);
+		} else if (isFloat) {
+			put(value);
+		} else if (bits == 16) {
+			put((int16_t)value);
+		} else if (bits == 24) {
+			int32_t v = (int32_t)value;
+			put(&v, 3);
+		} else {
+			put((int32_t)value);
+		}
+	}
+	
+	void putChunk(Container container, const char *id, const unsigned char *guid,
+			    const vector<char> &body, bool rf64Size = false)
+	{
+		if (container == W64) {
+			put(guid, 16);
+			put((uint64_t)(24 + body.size()));
+			put(&(body[0]), body.size());
+			while (bytes.size() % 8) bytes.push_back(0);
+		} else {
+			put(id, 4);
+			put((uint32_t)(rf64Size ? WAVFormat::RF64_SIZE : body.size()));
+			put(&(body[0]), body.size());
+			if (body.size() & 1) bytes.push_back(0);
+		}
+	}
+	
+	/**
+	 * Writes \c frames frames of \c channels channels, the first two
+	 * channels are \c values, the rest are filled with a constant.
+	 */
+	void write(Container container, int bits, bool isFloat, int channels,
+			 const vector<double> &values)
+	{
+		int frames = values.size() / 2;
+		int bytesPerSample = bits / 8;
+		
+		TestWAVWriter fmt;
+		// 24-bit samples are written as WAVE_FORMAT_EXTENSIBLE.
+		bool extensible = (bits == 24);
+		fmt.put((uint16_t)(extensible ? WAVFormat::FORMAT_EXTENSIBLE :
+					    (isFloat ? WAVFormat::FORMAT_IEEE_FLOAT : WAVFormat::FORMAT_PCM)));
+		fmt.put((uint16_t)channels);
+		fmt.put((int32_t)48000);
+		fmt.put((int32_t)(48000 * channels * bytesPerSample));
+		fmt.put((uint16_t)(channels * bytesPerSample));
+		fmt.put((uint16_t)bits);
+		if (extensible) {
+			fmt.put((uint16_t)22);
+			fmt.put((uint16_t)bits);
+			fmt.put((uint32_t)0);
+			fmt.put((uint16_t)WAVFormat::FORMAT_PCM);
+			fmt.put(WAVFormat::W64_WAVE_GUID + 2, 14);
+		}
+		
+		TestWAVWriter data;
+		for (int i = 0; i < frames; i++) {
+			data.putSample(values[2 * i], bits, isFloat);
+			data.putSample(values[2 * i + 1], bits, isFloat);
+			for (int c = 2; c < channels; c++)
+				data.putSample(1234, bits, isFloat);
+		}
+		
+		TestWAVWriter chunks;
+		if (container == RF64) {
+			TestWAVWriter ds64;
+			ds64.put((uint64_t)0);
+			ds64.put((uint64_t)data.bytes.size());
+			ds64.put((uint64_t)frames);
+			ds64.put((uint32_t)0);
+			chunks.putChunk(container, "ds64", NULL, ds64.bytes);
+		}
+		chunks.putChunk(container, "fmt ", WAVFormat::W64_FMT_GUID, fmt.bytes);
+		chunks.putChunk(container, "data", WAVFormat::W64_DATA_GUID, data.bytes,
+					 container == RF64);
+		
+		bytes.clear();
+		if (container == W64) {
+			put(WAVFormat::W64_RIFF_GUID, 16);
+			put((uint64_t)(40 + chunks.bytes.size()));
+			put(WAVFormat::W64_WAVE_GUID, 16);
+		} else {
+			put(container == RF64 ? "RF64" : "RIFF", 4);
+			put((uint32_t)(container == RF64 ? WAVFormat::RF64_SIZE : 4 + chunks.bytes.size()));
+			put("WAVE", 4);
+		}
+		put(&(chunks.bytes[0]), chunks.bytes.size());
+	}
+	
+	bool save(const string &fileName)
+	{
+		FILE *file = fopen(fileName.c_str(), "wb");
+		if (file == NULL) return false;
+		fwrite(&(bytes[0]), 1, bytes.size(), file);
+		return (fclose(file) == 0);
+	}
+};
+
+
+class MappedWAVFrontendTest : public TestCase {
+private:
+	/**
+	 * \brief Converts the received samples to doubles.
+	 */
+	class ConvertingBackend : public Backend {
+	public:
+		vector<double> values;
+		
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			vector<char>  stored(data.length * sizeof(Complex));
+			vector<float> window(data.length, 1.0f);
+			
+			copySamples(data, 0, &(stored[0]), data.length);
+			
+			values.resize(values.size() + 2 * data.length);
+			windowSamples(getStorageFormat(data.format), &(stored[0]), &(window[0]),
+					    (fftw_complex*)&(values[values.size() - 2 * data.length]),
+					    data.length);
+		}
+	};
+	
+	class CollectingBackend : public Backend {
+	public:
+		vector<int16_t> samples;
+		int             sampleRate;
+		WFTime          startTime;
+		bool            offsetsOk;
+		int             blocks;
+		
+		CollectingBackend() : sampleRate(0), offsetsOk(true), blocks(0) {}
+		
+		virtual void startStream(StreamInfo info)
+		{
+			Backend::startStream(info);
+			sampleRate = info.sampleRate;
+			startTime = info.timeOffset;
+		}
+		
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			if ((data.format != SAMPLE_COMPLEX_INT16) ||
+			    (info.offset != (long)samples.size() / 2))
+				offsetsOk = false;
+			
+			const int16_t *values = (const int16_t*)data.data;
+			samples.insert(samples.end(), values, values + 2 * data.length);
+			blocks++;
+		}
+	};
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(MappedWAVFrontendTest, testRead);
+		TEST_ADD(MappedWAVFrontendTest, testFormats);
+		TEST_ADD(MappedWAVFrontendTest, testStartTime);
+		TEST_ADD(MappedWAVFrontendTest, testZeroSampleRate);
+	}
+	
+	void testRead()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		if (fd < 0) return;
+		close(fd);
+		
+		vector<int16_t> expected;
+		TEST_ASSERT(writeTestWAV(fileName, 1000, 44100, &expected),
+				  "failed to write the test file");
+		
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+		
+		Ref<MappedWAVFrontend> frontend = new MappedWAVFrontend(fileName, 300);
+		frontend->setBackend(backendRef);
+		frontend->run();
+		
+		unlink(fileName);
+		
+		TEST_EQUALS(44100, backend->sampleRate, "wrong sample rate");
+		TEST_EQUALS(4, backend->blocks, "wrong number of blocks");
+		TEST_ASSERT(backend->offsetsOk, "wrong format or offset of a block");
+		TEST_EQUALS(expected.size(), backend->samples.size(), "wrong number of samples");
+		TEST_ASSERT(expected == backend->samples, "samples differ");
+	}
+	
+	/**
+	 * Both readers estimate the start of a recording from the time its file
+	 * was last written to.
+	 */
+	void testStartTime()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		if (fd < 0) return;
+		close(fd);
+		
+		TEST_ASSERT(writeTestWAV(fileName, 3000, 1000), "failed to write the test file");
+		
+		struct utimbuf times;
+		times.actime = 1000000;
+		times.modtime = 1000000;
+		TEST_ASSERT(utime(fileName, &times) == 0, "failed to set the modification time");
+		
+		for (int reader = 0; reader < 2; reader++) {
+			CollectingBackend *backend = new CollectingBackend();
+			Ref<Backend> backendRef = backend;
+			
+			Ref<Frontend> frontend;
+			if (reader == 0)
+				frontend = new MappedWAVFrontend(fileName, 256);
+			else
+				frontend = new WAVStream(new FileInput(fileName), fileName);
+			frontend->setBackend(backendRef);
+			frontend->run();
+			
+			TEST_EQUALS(1000000 - 3, backend->startTime.seconds(), "wrong start time");
+			TEST_EQUALS(0, backend->startTime.microseconds(), "wrong start time");
+		}
+		
+		unlink(fileName);
+	}
+	
+	/**
+	 * A header with a zero sample rate is rejected by both of the readers.
+	 */
+	void testZeroSampleRate()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		if (fd < 0) return;
+		close(fd);
+		
+		TEST_ASSERT(writeTestWAV(fileName, 3000, 0), "failed to write the test file");
+		
+		for (int reader = 0; reader < 2; reader++) {
+			CollectingBackend *backend = new CollectingBackend();
+			Ref<Backend> backendRef = backend;
+			
+			Ref<Frontend> frontend;
+			if (reader == 0)
+				frontend = new MappedWAVFrontend(fileName, 256);
+			else
+				frontend = new WAVStream(new FileInput(fileName), fileName);
+			frontend->setBackend(backendRef);
+			frontend->run();
+			
+			TEST_EQUALS(0, backend->samples.size(), "samples of an invalid file");
+		}
+		
+		unlink(fileName);
+	}
+	
+	/**
+	 * Reads all combinations of the containers and sample formats, with
+	 * both of the readers (Wave64 only with the mapped one).
+	 */
+	void testFormats()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		if (fd < 0) return;
+		close(fd);
+		
+		vector<double> expected(2 * 999);
+		for (unsigned i = 0; i < expected.size(); i++)
+			expected[i] = (double)((int)(i * 7919) % 20001 - 10000);
+		
+		int    bits[]      = { 16,      24,        32,         32,   64 };
+		bool   isFloat[]   = { false,   false,     false,      true, true };
+		// The integers are converted to the full scale of the floats.
+		double fullScale[] = { 32768.0, 8388608.0, 2147483648.0, 1.0, 1.0 };
+		
+		for (int container = 0; container < 3; container++) {
+			for (int format = 0; format < 5; format++) {
+				vector<double> scaled(expected.size());
+				for (unsigned i = 0; i < expected.size(); i++)
+					scaled[i] = expected[i] / fullScale[format];
+				
+				for (int channels = 2; channels <= 3; channels++) {
+					TestWAVWriter writer;
+					writer.write((TestWAVWriter::Container)container,
+							   bits[format], isFloat[format], channels,
+							   expected);
+					writer.save(fileName);
+					
+					for (int reader = 0; reader < 2; reader++) {
+						if ((reader == 1) && (container == TestWAVWriter::W64))
+							continue;
+						
+						ConvertingBackend *backend = new ConvertingBackend();
+						Ref<Backend> backendRef = backend;
+						
+						Ref<Frontend> frontend;
+						if (reader == 0)
+							frontend = new MappedWAVFrontend(fileName, 256);
+						else
+							frontend = new WAVStream(new FileInput(fileName));
+						frontend->setBackend(backendRef);
+						frontend->run();
+						
+						ostringstream message;
+						message << "container " << container << ", " << bits[format] <<
+							(isFloat[format] ? " bit float" : " bit int") << ", " <<
+							channels << " channels, reader " << reader;
+						
+						TEST_ASSERT(scaled == backend->values, message.str());
+					}
+				}
+			}
+		}
+		
+		unlink(fileName);
+	}
+};
+
+RUN_SUITE(MappedWAVFrontendTest);
+
+
+#endif /* end of include guard: MAPPEDWAVFRONTENDTEST_F8LC3ZRA */
+
@@ -0,0 +1,138 @@
+/**
+ * \file   MetricsTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the metrics.
+ */
+
+#ifndef METRICSTEST_Q3BZ6YKE
+#define METRICSTEST_Q3BZ6YKE
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/Metrics.h"
+
+
+class MetricsTest : public TestCase {
+private:
+	/**
+	 * \brief Updates the metrics from its own thread.
+	 */
+	class Worker {
+	public:
+		void* work()
+		{
+			for (int i = 0; i < 100000; i++) {
+				Metrics::count(METRIC_SNAPSHOTS);
+				Metrics::record(LATENCY_FITS_WRITE, i);
+			}
+			return NULL;
+		}
+	};
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(MetricsTest, testHistogram);
+		TEST_ADD(MetricsTest, testThreads);
+		TEST_ADD(MetricsTest, testReporter);
+	}
+
+	void testHistogram()
+	{
+		bool bucketsOk = true;
+		for (uint64_t value = 0; value < (1ULL << 40); value = value * 3 / 2 + 1) {
+			int bucket = Histogram::getBucket(value);
+			if ((Histogram::getBucketStart(bucket) > value) ||
+			    (Histogram::getBucketStart(bucket + 1) <= value))
+				bucketsOk = false;
+		}
+		TEST_ASSERT(bucketsOk, "a value is outside of its bucket");
+
+		Histogram histogram;
+		for (uint64_t value = 1; value <= 10000; value++) {
+			histogram.buckets[Histogram::getBucket(value)]++;
+			histogram.count++;
+			histogram.sum += value;
+			histogram.max = value;
+		}
+
+		TEST_EQUALS(5000.5, histogram.getMean(), "wrong mean");
+		uint64_t median = histogram.getPercentile(0.5);
+		TEST_ASSERT((median >= 5000) && (median <= 5000 * 1.125), "wrong median");
+		uint64_t p99 = histogram.getPercentile(0.99);
+		TEST_ASSERT((p99 >= 9900) && (p99 <= 10000), "wrong 99th percentile");
+		TEST_EQUALS(10000, histogram.getPercentile(1.0), "wrong maximum");
+	}
+
+	/**
+	 * The metrics of all threads are summed, including the finished ones
+	 * (whose shards are then reused).
+	 */
+	void testThreads()
+	{
+		MetricsSnapshot *before = new MetricsSnapshot();
+		MetricsSnapshot *after = new MetricsSnapshot();
+		Metrics::getSnapshot(before);
+
+		Worker worker;
+		{
+			MethodThread<void, Worker> first(&worker, &Worker::work);
+			MethodThread<void, Worker> second(&worker, &Worker::work);
+			first.join();
+			second.join();
+		}
+		{
+			MethodThread<void, Worker> third(&worker, &Worker::work);
+			third.join();
+		}
+
+		Metrics::getSnapshot(after);
+
+		TEST_EQUALS(300000, after->counters[METRIC_SNAPSHOTS] - before->counters[METRIC_SNAPSHOTS],
+				  "wrong counter");
+		TEST_EQUALS(300000, after->latencies[LATENCY_FITS_WRITE].count -
+				  before->latencies[LATENCY_FITS_WRITE].count,
+				  "wrong histogram count");
+		TEST_ASSERT(after->latencies[LATENCY_FITS_WRITE].max >= 99999, "wrong maximum");
+
+		delete before;
+		delete after;
+	}
+
+	void testReporter()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		close(fd);
+
+		Ref<MetricsReporter> reporter = new MetricsReporter(fileName, 0.05);
+		reporter->start();
+		Metrics::count(METRIC_SAMPLES_IN, 1000);
+		usleep(150000);
+		reporter->stop();
+
+		ifstream input(fileName);
+		string contents((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+		unlink(fileName);
+
+		TEST_ASSERT(contents.find("counter samples_in ") != string::npos,
+				  "samples missing from the stats file");
+		TEST_ASSERT(contents.find("latency fft count=") != string::npos,
+				  "FFT latency missing from the stats file");
+	}
+};
+
+RUN_SUITE(MetricsTest);
+
+
+#endif /* end of include guard: METRICSTEST_Q3BZ6YKE */
+
@@ -0,0 +1,233 @@
+/**
+ * \file   ParallelWAVFrontendTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the parallel WAV frontend.
+ */
+
+#ifndef PARALLELWAVFRONTENDTEST_M5WT2HQE
+#define PARALLELWAVFRONTENDTEST_M5WT2HQE
+
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "MappedWAVFrontendTest.h"
+#include "../src/ParallelWAVFrontend.h"
+#include "../src/WaterfallBackend.h"
+
+
+class ParallelWAVFrontendTest : public TestCase {
+private:
+	struct Row {
+		WFTime        time;
+		vector<float> values;
+	};
+
+	/**
+	 * \brief Output of several sinks merged by the row number.
+	 */
+	struct Rows {
+		Mutex           mutex;
+		map<long, Row>  rows;
+		int             duplicates;
+
+		Rows() : duplicates(0) {}
+	};
+
+	class CollectingSink : public SpectrumSink {
+	private:
+		Rows *rows_;
+
+	public:
+		CollectingSink(Rows *rows) : rows_(rows) {}
+
+		virtual void processRow(const float *row, DataInfo info)
+		{
+			MutexLock lock(&rows_->mutex);
+
+			if (rows_->rows.count(info.offset) > 0) rows_->duplicates++;
+
+			Row &stored = rows_->rows[info.offset];
+			stored.time = info.timeOffset;
+			stored.values.assign(row, row + info_.bins);
+		}
+
+		/// Rows are collected in groups of three, like snapshots.
+		virtual int getRowAlignment(const SpectrumInfo &info) { return 3; }
+	};
+
+	Ref<Backend> makeBackend(Rows *rows)
+	{
+		WaterfallBackend *backend = new WaterfallBackend(256, 192);
+		backend->addSink(new CollectingSink(rows), 10);
+		return backend;
+	}
+	
+	/**
+	 * Checks that \c part contains exactly the rows \c first to \c last of
+	 * \c full.
+	 */
+	void testRows(Rows &full, Rows &part, long first, long last, const char *name)
+	{
+		bool rowsOk = (part.rows.size() == (unsigned long)(last - first + 1)) &&
+			(part.rows.begin()->first == first) &&
+			(part.rows.rbegin()->first == last);
+		
+		bool valuesOk = true;
+		map<long, Row>::iterator it = part.rows.begin();
+		for (; it != part.rows.end(); it++) {
+			Row &other = full.rows[it->first];
+			
+			if ((other.time.seconds() != it->second.time.seconds()) ||
+			    (other.time.microseconds() != it->second.time.microseconds()) ||
+			    (other.values != it->second.values))
+				valuesOk = false;
+		}
+		
+		TEST_ASSERT(rowsOk, (string("wrong rows of a range: ") + name).c_str());
+		TEST_ASSERT(valuesOk, (string("rows of a range differ: ") + name).c_str());
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(ParallelWAVFrontendTest, testSameAsSequential);
+		TEST_ADD(ParallelWAVFrontendTest, testRange);
+	}
+
+	/**
+	 * Processes the same file sequentially and in parallel segments, the
+	 * rows and their times must be the same.
+	 */
+	void testSameAsSequential()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		if (fd < 0) return;
+		close(fd);
+
+		TEST_ASSERT(writeTestWAV(fileName, 50000, 8000),
+				  "failed to write the test file");
+
+		WFTime startTime(1500000000, 0);
+
+		Rows sequential;
+		Ref<MappedWAVFrontend> frontend = new MappedWAVFrontend(fileName, 1000);
+		frontend->setStartTime(startTime);
+		frontend->setBackend(makeBackend(&sequential));
+		frontend->run();
+
+		Rows parallel;
+		Ref<ParallelWAVFrontend> parallelFrontend =
+			new ParallelWAVFrontend(fileName, 1000);
+		parallelFrontend->setStartTime(startTime);
+		for (int i = 0; i < 3; i++)
+			parallelFrontend->addBackend(makeBackend(&parallel));
+		parallelFrontend->run();
+
+		unlink(fileName);
+
+		TEST_ASSERT(sequential.rows.size() > 100, "too few rows");
+		TEST_EQUALS(0, parallel.duplicates, "rows produced by several segments");
+		TEST_EQUALS(sequential.rows.size(), parallel.rows.size(),
+				  "wrong number of rows");
+
+		bool timesOk = true, valuesOk = true;
+		map<long, Row>::iterator it = sequential.rows.begin();
+		for (; it != sequential.rows.end(); it++) {
+			Row &other = parallel.rows[it->first];
+
+			if ((other.time.seconds() != it->second.time.seconds()) ||
+			    (other.time.microseconds() != it->second.time.microseconds()))
+				timesOk = false;
+			if (other.values != it->second.values)
+				valuesOk = false;
+		}
+
+		TEST_ASSERT(timesOk, "row times differ");
+		TEST_ASSERT(valuesOk, "row values differ");
+
+		// 64 samples per row at 8 kHz.
+		Row &row = sequential.rows[100];
+		TEST_EQUALS(1500000000L, (long)row.time.seconds(), "wrong row time");
+		TEST_EQUALS(800000L, (long)row.time.microseconds(), "wrong row time");
+	}
+	
+	/**
+	 * Processes a part of a file, the rows must be the same as the rows of
+	 * the whole file.
+	 */
+	void testRange()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		if (fd < 0) return;
+		close(fd);
+		
+		TEST_ASSERT(writeTestWAV(fileName, 50000, 8000),
+				  "failed to write the test file");
+		
+		// 2017-07-14 02:40:00 UTC
+		WFTime startTime(1500000000, 0);
+		
+		Rows full;
+		Ref<MappedWAVFrontend> frontend = new MappedWAVFrontend(fileName, 1000);
+		frontend->setStartTime(startTime);
+		frontend->setBackend(makeBackend(&full));
+		frontend->run();
+		
+		// Samples 20000 to 32000, the start is moved back to a multiple of
+		// 3 rows of 64 samples (19968).
+		StreamPosition start, end;
+		TEST_ASSERT(StreamPosition::parse("2017-07-14 02:40:02.5", &start),
+				  "failed to parse a time");
+		TEST_ASSERT(StreamPosition::parse("32000", &end),
+				  "failed to parse a sample offset");
+		
+		Rows mapped;
+		frontend = new MappedWAVFrontend(fileName, 1000);
+		frontend->setStartTime(startTime);
+		frontend->setRange(start, end);
+		frontend->setBackend(makeBackend(&mapped));
+		frontend->run();
+		testRows(full, mapped, 312, 499, "mapped");
+		
+		Rows parallel;
+		Ref<ParallelWAVFrontend> parallelFrontend =
+			new ParallelWAVFrontend(fileName, 1000);
+		parallelFrontend->setStartTime(startTime);
+		parallelFrontend->setRange(start, end);
+		for (int i = 0; i < 3; i++)
+			parallelFrontend->addBackend(makeBackend(&parallel));
+		parallelFrontend->run();
+		testRows(full, parallel, 312, 499, "parallel");
+		
+		TEST_ASSERT(StreamPosition::parse("2.5s", &start),
+				  "failed to parse seconds");
+		
+		Rows stream;
+		Ref<WAVStream> streamFrontend = new WAVStream(new FileInput(fileName));
+		streamFrontend->setStartTime(startTime);
+		streamFrontend->setRange(start, end);
+		streamFrontend->setBackend(makeBackend(&stream));
+		streamFrontend->run();
+		testRows(full, stream, 312, 499, "stream");
+		
+		unlink(fileName);
+	}
+};
+
+RUN_SUITE(ParallelWAVFrontendTest);
+
+
+#endif /* end of include guard: PARALLELWAVFRONTENDTEST_M5WT2HQE */
+
@@ -0,0 +1,93 @@
+/**
+ * \file   PerfCountersTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the hardware performance counters.
+ */
+
+#ifndef PERFCOUNTERSTEST_D6LS4WXA
+#define PERFCOUNTERSTEST_D6LS4WXA
+
+#include <sstream>
+#include <string>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/PerfCounters.h"
+
+
+class PerfCountersTest : public TestCase {
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(PerfCountersTest, testWrite);
+		TEST_ADD(PerfCountersTest, testMeasure);
+	}
+
+	void testWrite()
+	{
+		PerfTotals previous;
+		PerfTotals current;
+		current.calls[PERF_FFT] = 4;
+		current.values[PERF_FFT][PERF_CYCLES] = 4000;
+		current.values[PERF_FFT][PERF_INSTRUCTIONS] = 6000;
+		current.values[PERF_FFT][PERF_LLC_MISSES] = 40;
+		previous.calls[PERF_FFT] = 2;
+		previous.values[PERF_FFT][PERF_CYCLES] = 2000;
+		previous.values[PERF_FFT][PERF_INSTRUCTIONS] = 2000;
+
+		stringstream output;
+		PerfCounters::write(output, current, &previous);
+		string text = output.str();
+
+		TEST_ASSERT(text.find("perf fft calls=2 cycles=1000 instructions=2000 "
+						  "llc_misses=20 branch_misses=0 ipc=2.00") != string::npos,
+				  "wrong averages per call");
+		TEST_ASSERT(text.find("perf write calls=0 ") != string::npos,
+				  "stage without calls missing");
+	}
+
+	/**
+	 * Where perf isn't allowed, the counters stay disabled and the
+	 * measurements do nothing.
+	 */
+	void testMeasure()
+	{
+		PerfTotals before;
+		PerfTotals after;
+		PerfCounters::getTotals(&before);
+
+		bool enabled = PerfCounters::enable();
+		TEST_EQUALS(enabled, PerfCounters::isEnabled(), "wrong state");
+
+		volatile double sum = 0;
+		{
+			PerfScope scope(PERF_MAGNITUDE);
+			for (int i = 0; i < 100000; i++) sum += i;
+		}
+
+		PerfCounters::getTotals(&after);
+		PerfCounters::disable();
+
+		if (enabled) {
+			TEST_EQUALS(1, after.calls[PERF_MAGNITUDE] - before.calls[PERF_MAGNITUDE],
+					  "measurement not recorded");
+			TEST_ASSERT(after.values[PERF_MAGNITUDE][PERF_INSTRUCTIONS] -
+					  before.values[PERF_MAGNITUDE][PERF_INSTRUCTIONS] >= 100000,
+					  "too few instructions");
+		} else {
+			PerfSample sample;
+			TEST_ASSERT(!PerfCounters::read(&sample), "read while disabled");
+			TEST_EQUALS(0, after.calls[PERF_MAGNITUDE] - before.calls[PERF_MAGNITUDE],
+					  "measurement recorded while disabled");
+		}
+	}
+};
+
+RUN_SUITE(PerfCountersTest);
+
+
+#endif /* end of include guard: PERFCOUNTERSTEST_D6LS4WXA */
+
@@ -0,0 +1,124 @@
+/**
+ * \file   RawIQFrontendTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the raw IQ frontend.
+ */
+
+#ifndef RAWIQFRONTENDTEST_C9RM3JWU
+#define RAWIQFRONTENDTEST_C9RM3JWU
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/RawIQFrontend.h"
+
+
+class RawIQFrontendTest : public TestCase {
+private:
+	/**
+	 * \brief Writes a buffer to a pipe in small, odd-sized pieces.
+	 */
+	class Writer {
+	private:
+		int                 fd_;
+		const vector<char> &data_;
+
+	public:
+		Writer(int fd, const vector<char> &data) : fd_(fd), data_(data) {}
+
+		void* write()
+		{
+			for (unsigned i = 0; i < data_.size(); i += 7) {
+				unsigned count = data_.size() - i;
+				if (count > 7) count = 7;
+				if (::write(fd_, &(data_[i]), count) != (ssize_t)count) break;
+				if (i % 700 == 0) usleep(100);
+			}
+			close(fd_);
+			return NULL;
+		}
+	};
+
+	class CollectingBackend : public Backend {
+	public:
+		vector<int16_t> samples;
+		bool            realTime;
+		int             sampleRate;
+		bool            offsetsOk;
+
+		CollectingBackend() : realTime(false), sampleRate(0), offsetsOk(true) {}
+
+		virtual void startStream(StreamInfo info)
+		{
+			Backend::startStream(info);
+			realTime = info.realTime;
+			sampleRate = info.sampleRate;
+		}
+
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			if ((data.format != SAMPLE_COMPLEX_INT16) ||
+			    (info.offset != (long)samples.size() / 2))
+				offsetsOk = false;
+
+			const int16_t *values = (const int16_t*)data.data;
+			samples.insert(samples.end(), values, values + 2 * data.length);
+		}
+	};
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(RawIQFrontendTest, testPipe);
+	}
+
+	/**
+	 * Reads samples split into pieces not aligned to the samples from a
+	 * pipe.
+	 */
+	void testPipe()
+	{
+		vector<int16_t> expected(2 * 5000);
+		for (unsigned i = 0; i < expected.size(); i++)
+			expected[i] = (int16_t)(i * 7919);
+
+		vector<char> data((const char*)&(expected[0]),
+					   (const char*)&(expected[0]) + expected.size() * 2);
+
+		int fds[2];
+		TEST_ASSERT(pipe(fds) == 0, "failed to create a pipe");
+
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+
+		Ref<RawIQFrontend> frontend =
+			new RawIQFrontend(fds[0], SAMPLE_COMPLEX_INT16, 250000, 1000);
+		frontend->setBackend(backendRef);
+
+		Writer writer(fds[1], data);
+		MethodThread<void, Writer> thread(&writer, &Writer::write);
+
+		frontend->run();
+		thread.join();
+		close(fds[0]);
+
+		TEST_EQUALS(250000, backend->sampleRate, "wrong sample rate");
+		TEST_ASSERT(backend->realTime, "the stream should be real-time");
+		TEST_ASSERT(backend->offsetsOk, "wrong format or offset of a block");
+		TEST_EQUALS(expected.size(), backend->samples.size(), "wrong number of samples");
+		TEST_ASSERT(expected == backend->samples, "samples differ");
+	}
+};
+
+RUN_SUITE(RawIQFrontendTest);
+
+
+#endif /* end of include guard: RAWIQFRONTENDTEST_C9RM3JWU */
+
@@ -0,0 +1,164 @@
+/**
+ * \file   RingBufferBench.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Throughput microbenchmarks of the ring buffers.
+ */
+
+#ifndef RINGBUFFERBENCH_H0SL4YEC
+#define RINGBUFFERBENCH_H0SL4YEC
+
+#include <sched.h>
+#include <string.h>
+
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/RingBuffer.h"
+#include "Benchmark.h"
+
+
+/**
+ * \brief Moves floats from a producer to a consumer thread through an
+ *        SPSCRingBuffer in blocks of given size (a JACK period, for
+ *        example).
+ */
+class SPSCRingBufferBench {
+private:
+	typedef MethodThread<void, SPSCRingBufferBench> Thread;
+	
+	SPSCRingBuffer<float> buffer_;
+	long                  itemCount_;
+	int                   blockSize_;
+	
+	void* producerThread()
+	{
+		vector<float> block(blockSize_, 1.0f);
+		long written = 0;
+		
+		while (written < itemCount_) {
+			int count = blockSize_;
+			if (count > itemCount_ - written) count = itemCount_ - written;
+			
+			int n = buffer_.write(&(block[0]), count);
+			written += n;
+			if (n == 0) sched_yield();
+		}
+		
+		return NULL;
+	}
+	
+	void* consumerThread()
+	{
+		vector<float> block(blockSize_);
+		long read = 0;
+		
+		while (read < itemCount_) {
+			int n = buffer_.read(&(block[0]), blockSize_);
+			read += n;
+			if (n == 0) sched_yield();
+		}
+		
+		return NULL;
+	}
+
+public:
+	SPSCRingBufferBench(int capacity, int blockSize, long itemCount) :
+		buffer_(capacity), itemCount_(itemCount), blockSize_(blockSize)
+	{
+	}
+	
+	/// Returns the duration in seconds.
+	double run()
+	{
+		Stopwatch stopwatch;
+		
+		Thread consumer(this, &SPSCRingBufferBench::consumerThread);
+		Thread producer(this, &SPSCRingBufferBench::producerThread);
+		producer.join();
+		consumer.join();
+		
+		return stopwatch.seconds();
+	}
+};
+
+
+inline void benchmarkRingBuffers()
+{
+	const long itemCount = 100000000;
+	int blockSizes[] = { 1, 64, 1024, 8192 };
+	
+	for (unsigned i = 0; i < sizeof(blockSizes) / sizeof(blockSizes[0]); i++) {
+		int blockSize = blockSizes[i];
+		long count = (blockSize == 1) ? itemCount / 10 : itemCount;
+		
+		SPSCRingBufferBench bench(65536, blockSize, count);
+		double seconds = bench.run();
+		
+		ostringstream name;
+		name << "SPSCRingBuffer/threads/block=" << blockSize;
+		reportBenchmark(name.str(), count, sizeof(float), seconds);
+	}
+	
+	// Single-threaded push/pop of the old RingBuffer for comparison.
+	{
+		RingBuffer<float> buffer(65536);
+		long count = itemCount / 10;
+		float value;
+		
+		Stopwatch stopwatch;
+		for (long i = 0; i < count; i++) {
+			buffer.push(1.0f);
+			buffer.tryPop(&value);
+		}
+		reportBenchmark("RingBuffer/push+pop", count, sizeof(float), stopwatch.seconds());
+	}
+}
+
+
+/**
+ * \brief Rows of spectra through the FragmentedRingBuffer2D: pushing
+ *        (copying a row in), popping, and reading rows by index.
+ */
+inline void benchmarkFragmentedRingBuffer()
+{
+	const int  width = 4096;
+	const int  capacity = 4096;
+	const long rows = 1000000;
+	
+	FragmentedRingBuffer2D<float> buffer(width, 1024 * 1024, capacity);
+	vector<float> row(width, 1.0f);
+	vector<double> runs;
+	
+	for (int run = 0; run < BENCHMARK_RUNS; run++) {
+		Stopwatch stopwatch;
+		for (long i = 0; i < rows; i++) {
+			memcpy(buffer.push(), &(row[0]), width * sizeof(float));
+			if (buffer.getSize() > capacity / 2) buffer.tryPop(NULL);
+		}
+		runs.push_back(stopwatch.seconds());
+	}
+	reportBenchmark("FragmentedRingBuffer2D/push+pop/width=4096", rows,
+				 width * sizeof(float), medianSeconds(runs), BENCHMARK_RUNS);
+	
+	runs.clear();
+	float sum = 0;
+	for (int run = 0; run < BENCHMARK_RUNS; run++) {
+		Stopwatch stopwatch;
+		for (long i = 0; i < rows; i++)
+			sum += *buffer.at((int)((i * 7919) % buffer.getSize()));
+		runs.push_back(stopwatch.seconds());
+	}
+	reportBenchmark("FragmentedRingBuffer2D/at", rows, sizeof(float),
+				 medianSeconds(runs), BENCHMARK_RUNS);
+	
+	// Keeps the reads from being optimized out.
+	if (sum < 0) cout << sum << endl;
+}
+
+
+#endif /* end of include guard: RINGBUFFERBENCH_H0SL4YEC */
+
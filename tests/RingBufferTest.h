@@ -20,16 +20,14 @@ using namespace cppapp;
  */
 class RingBufferTest : public TestCase {
 public:
-	/**
-	 * Constructor.
-	 */
-	//RingBufferTest(const char *name) : TestCase(name)
-	//{
-	//	TEST_ADD(RingBufferTest, testConstructor);
-	//	TEST_ADD(RingBufferTest, testCopyConstructor);
-	//	TEST_ADD(RingBufferTest, testCopyConstructorOverlap);
-	//	TEST_ADD(RingBufferTest, testPush);
-	//}
+	virtual void initTests()
+	{
+		TEST_ADD(RingBufferTest, testConstructor);
+		TEST_ADD(RingBufferTest, testCopyConstructor);
+		TEST_ADD(RingBufferTest, testCopyConstructorOverlap);
+		TEST_ADD(RingBufferTest, testPush);
+		TEST_ADD(RingBufferTest, testTryPop);
+	}
 	
 	void testConstructor()
 	{
@@ -0,0 +1,230 @@
+/**
+ * \file   SPSCRingBufferTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the SPSCRingBuffer class.
+ *
+ * The stress tests run a producer and a consumer thread concurrently and
+ * are meant to be run also under ThreadSanitizer (\c make \c tsan).
+ */
+
+#ifndef SPSCRINGBUFFERTEST_9GJX3W0T
+#define SPSCRINGBUFFERTEST_9GJX3W0T
+
+#include <sched.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/RingBuffer.h"
+
+
+class SPSCRingBufferTest : public TestCase {
+private:
+	typedef MethodThread<void, SPSCRingBufferTest> Thread;
+	
+	SPSCRingBuffer<long> *buffer_;
+	long                  itemCount_;
+	bool                  useSegments_;
+	long                  errors_;
+	
+	/**
+	 * Writes the sequence 0, 1, 2, ... in blocks of varying size.
+	 */
+	void* producerThread()
+	{
+		long items[128];
+		long next = 0;
+		
+		while (next < itemCount_) {
+			int count = (next % 127) + 1;
+			if (count > itemCount_ - next) count = itemCount_ - next;
+			
+			int written;
+			if (useSegments_) {
+				long *segment;
+				written = buffer_->reserve(&segment);
+				if (written > count) written = count;
+				for (int i = 0; i < written; i++)
+					segment[i] = next + i;
+				buffer_->commit(written);
+			} else {
+				for (int i = 0; i < count; i++)
+					items[i] = next + i;
+				written = buffer_->write(items, count);
+			}
+			
+			next += written;
+			if (written == 0) sched_yield();
+		}
+		
+		return NULL;
+	}
+	
+	/**
+	 * Reads the sequence and counts the items out of order.
+	 */
+	void* consumerThread()
+	{
+		long items[100];
+		long next = 0;
+		
+		while (next < itemCount_) {
+			int count;
+			if (useSegments_) {
+				const long *segment;
+				count = buffer_->peek(&segment);
+				for (int i = 0; i < count; i++)
+					if (segment[i] != next + i) errors_++;
+				buffer_->consume(count);
+			} else {
+				count = buffer_->read(items, (next % 99) + 1);
+				for (int i = 0; i < count; i++)
+					if (items[i] != next + i) errors_++;
+			}
+			
+			next += count;
+			if (count == 0) sched_yield();
+		}
+		
+		return NULL;
+	}
+	
+	void stress(int capacity, long itemCount, bool useSegments)
+	{
+		SPSCRingBuffer<long> buffer(capacity);
+		
+		buffer_      = &buffer;
+		itemCount_   = itemCount;
+		useSegments_ = useSegments;
+		errors_      = 0;
+		
+		Thread consumer(this, &SPSCRingBufferTest::consumerThread);
+		Thread producer(this, &SPSCRingBufferTest::producerThread);
+		producer.join();
+		consumer.join();
+		
+		TEST_EQUALS(0, errors_, "items should be read in the order of writing");
+		TEST_EQUALS(0, buffer.getSize(), "buffer should be empty at the end");
+		
+		buffer_ = NULL;
+	}
+
+public:
+	SPSCRingBufferTest() :
+		buffer_(NULL), itemCount_(0), useSegments_(false), errors_(0)
+	{
+	}
+	
+	virtual void initTests()
+	{
+		TEST_ADD(SPSCRingBufferTest, testConstructor);
+		TEST_ADD(SPSCRingBufferTest, testWriteRead);
+		TEST_ADD(SPSCRingBufferTest, testOverflow);
+		TEST_ADD(SPSCRingBufferTest, testSegments);
+		TEST_ADD(SPSCRingBufferTest, testStress);
+		TEST_ADD(SPSCRingBufferTest, testStressSegments);
+	}
+	
+	void testConstructor()
+	{
+		SPSCRingBuffer<int> buffer(100);
+		
+		TEST_EQUALS(128, buffer.getCapacity(),
+				  "capacity should be rounded up to a power of two");
+		TEST_EQUALS(0, buffer.getSize(), "created buffer should have size 0");
+		TEST_EQUALS(128, buffer.getWriteSpace(), "created buffer should be empty");
+		TEST_EQUALS(0, buffer.getReadSpace(), "created buffer should be empty");
+		TEST_EQUALS(0, buffer.getOverflowCount(), "there should be no overflow");
+	}
+	
+	void testWriteRead()
+	{
+		SPSCRingBuffer<int> buffer(16);
+		int items[16];
+		int next = 0;
+		int expected = 0;
+		
+		// Blocks of 5 items wrap around the end of the buffer several times.
+		for (int round = 0; round < 20; round++) {
+			for (int i = 0; i < 5; i++)
+				items[i] = next++;
+			TEST_EQUALS(5, buffer.write(items, 5), "all items should be written");
+			TEST_EQUALS(5, buffer.getSize(), "buffer has the wrong size");
+			
+			TEST_EQUALS(5, buffer.read(items, 16), "all items should be read");
+			for (int i = 0; i < 5; i++)
+				TEST_EQUALS(expected++, items[i], "read item has the wrong value");
+		}
+	}
+	
+	void testOverflow()
+	{
+		SPSCRingBuffer<int> buffer(8);
+		int items[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		
+		TEST_EQUALS(8, buffer.write(items, 10), "only 8 items should fit");
+		TEST_EQUALS(2, buffer.getOverflowCount(), "2 items should overflow");
+		
+		TEST_ASSERT(!buffer.tryWrite(items, 1), "full buffer should reject items");
+		TEST_EQUALS(3, buffer.getOverflowCount(), "rejected item should be counted");
+		
+		int read[8];
+		TEST_EQUALS(3, buffer.read(read, 3), "3 items should be read");
+		TEST_EQUALS(0, read[0], "full buffer must not be overwritten");
+		
+		TEST_ASSERT(!buffer.tryWrite(items, 4), "4 items should not fit");
+		TEST_EQUALS(7, buffer.getOverflowCount(), "all rejected items should be counted");
+		TEST_ASSERT(buffer.tryWrite(items, 3), "3 items should fit");
+		TEST_EQUALS(8, buffer.getSize(), "buffer should be full");
+	}
+	
+	void testSegments()
+	{
+		SPSCRingBuffer<int> buffer(8);
+		int items[6] = { 0, 1, 2, 3, 4, 5 };
+		int read[6];
+		
+		buffer.write(items, 6);
+		buffer.read(read, 6);
+		
+		// The head is at index 6 now, only 2 items are contiguous.
+		int *segment;
+		TEST_EQUALS(2, buffer.reserve(&segment), "first segment should end at the end of the buffer");
+		segment[0] = 10;
+		segment[1] = 11;
+		buffer.commit(2);
+		TEST_EQUALS(6, buffer.reserve(&segment), "second segment should start at the beginning");
+		segment[0] = 12;
+		buffer.commit(1);
+		
+		const int *readSegment;
+		TEST_EQUALS(2, buffer.peek(&readSegment), "first read segment should have 2 items");
+		TEST_EQUALS(10, readSegment[0], "peeked item has the wrong value");
+		TEST_EQUALS(11, readSegment[1], "peeked item has the wrong value");
+		buffer.consume(2);
+		TEST_EQUALS(1, buffer.peek(&readSegment), "second read segment should have 1 item");
+		TEST_EQUALS(12, readSegment[0], "peeked item has the wrong value");
+		buffer.consume(1);
+		TEST_EQUALS(0, buffer.getSize(), "buffer should be empty");
+	}
+	
+	void testStress()
+	{
+		stress(64, 2000000, false);
+		stress(4096, 2000000, false);
+	}
+	
+	void testStressSegments()
+	{
+		stress(64, 2000000, true);
+		stress(4096, 2000000, true);
+	}
+};
+
+RUN_SUITE(SPSCRingBufferTest);
+
+
+#endif /* end of include guard: SPSCRINGBUFFERTEST_9GJX3W0T */
+
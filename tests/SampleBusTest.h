@@ -0,0 +1,200 @@
+/**
+ * \file   SampleBusTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the shared-memory sample bus.
+ */
+
+#ifndef SAMPLEBUSTEST_C9RM4WJT
+#define SAMPLEBUSTEST_C9RM4WJT
+
+#include <stdint.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/SampleBus.h"
+#include "../src/SampleBusFrontend.h"
+
+
+class SampleBusTest : public TestCase {
+private:
+	class CollectingBackend : public Backend {
+	public:
+		vector<float> real;
+		vector<float> imag;
+		vector<long>  offsets;
+
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			offsets.push_back(info.offset);
+
+			for (int i = 0; i < data.length; i++) {
+				if (data.format == SAMPLE_PLANAR_FLOAT) {
+					real.push_back(((const float*)data.data)[i]);
+					imag.push_back(((const float*)data.imag)[i]);
+				} else {
+					const int16_t *sample = (const int16_t*)
+						((const char*)data.data + (long)i * data.frameSize());
+					real.push_back(sample[0]);
+					imag.push_back(sample[1]);
+				}
+			}
+		}
+	};
+
+	string getName(const char *test)
+	{
+		ostringstream name;
+		name << "/waterfall_bus_test_" << getpid() << "_" << test;
+		return name.str();
+	}
+
+	DataInfo getDataInfo(long offset, int sampleRate)
+	{
+		DataInfo info;
+		info.offset = offset;
+		info.timeOffset = WFTime(1000, 0).addSamples(offset, sampleRate);
+		return info;
+	}
+
+	/**
+	 * Publishes \c length planar samples, sample I of the stream is I - I j.
+	 */
+	void publishPlanar(Ref<SampleBusBackend> bus, long offset, int length)
+	{
+		vector<float> real(length), imag(length);
+		for (int i = 0; i < length; i++) {
+			real[i] = offset + i;
+			imag[i] = -(offset + i);
+		}
+		bus->process(SampleSpan(SAMPLE_PLANAR_FLOAT, &(real[0]), &(imag[0]), length),
+				   getDataInfo(offset, 1000));
+	}
+
+	/**
+	 * Publishes the first of two interleaved 16-bit channels, sample I of
+	 * the stream is I + 1 j.
+	 */
+	void publishStrided(Ref<SampleBusBackend> bus, long offset, int length)
+	{
+		vector<int16_t> samples(4 * length, 7);
+		for (int i = 0; i < length; i++) {
+			samples[4 * i] = offset + i;
+			samples[4 * i + 1] = 1;
+		}
+		bus->process(SampleSpan(SAMPLE_COMPLEX_INT16, &(samples[0]), length, 8),
+				   getDataInfo(offset, 100));
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(SampleBusTest, testBlocks);
+		TEST_ADD(SampleBusTest, testOverrun);
+	}
+
+	/**
+	 * Blocks of 100 samples in a ring of 20. The reader joins after the
+	 * first 250 samples and there is a gap of 100 samples before 500.
+	 */
+	void testBlocks()
+	{
+		CollectingBackend *local = new CollectingBackend();
+		Ref<SampleBusBackend> bus = new SampleBusBackend(getName("blocks"), 2, 100, local);
+
+		StreamInfo info;
+		info.sampleRate = 1000;
+		info.timeOffset = WFTime(1000, 0);
+		info.realTime = true;
+		bus->startStream(info);
+
+		publishPlanar(bus, 0, 250);
+
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<SampleBusFrontend> frontend = new SampleBusFrontend(getName("blocks"));
+		frontend->setBackend(backend);
+		frontend->setReportInterval(0);
+		TEST_ASSERT(frontend->open(), "failed to open the bus");
+
+		publishPlanar(bus, 250, 150);
+		publishPlanar(bus, 500, 100);
+		bus->endStream();
+
+		TEST_EQUALS(3, frontend->getLag(), "wrong lag");
+		frontend->run();
+
+		TEST_EQUALS(3, local->offsets.size(), "blocks not passed on");
+		TEST_EQUALS(500, local->real.size(), "samples not passed on");
+
+		TEST_EQUALS(1000, frontend->getStreamInfo().sampleRate, "wrong sample rate");
+		TEST_EQUALS(250, frontend->getStreamInfo().startOffset, "wrong start");
+		TEST_ASSERT(frontend->getStreamInfo().realTime, "not live");
+		TEST_EQUALS(3, frontend->getBlockCount(), "wrong number of blocks");
+		TEST_EQUALS(0, frontend->getOverrunCount(), "overruns without overwriting");
+		TEST_EQUALS(100, frontend->getLostSampleCount(), "gap not counted");
+
+		TEST_EQUALS(3, backend->offsets.size(), "wrong number of blocks processed");
+		TEST_EQUALS(250, backend->offsets[0], "wrong offset");
+		TEST_EQUALS(350, backend->offsets[1], "wrong offset of a split block");
+		TEST_EQUALS(500, backend->offsets[2], "wrong offset after the gap");
+
+		bool ok = (backend->real.size() == 250);
+		for (unsigned i = 0; ok && (i < backend->real.size()); i++) {
+			float value = (i < 150) ? 250 + i : 500 + (i - 150);
+			ok = (backend->real[i] == value) && (backend->imag[i] == -value);
+		}
+		TEST_ASSERT(ok, "samples differ");
+	}
+
+	/**
+	 * A ring of 4 blocks of 50 samples, the reader falls 10 blocks behind.
+	 */
+	void testOverrun()
+	{
+		Ref<SampleBusBackend> bus = new SampleBusBackend(getName("overrun"), 1, 50, NULL);
+
+		StreamInfo info;
+		info.sampleRate = 100;
+		info.timeOffset = WFTime(1000, 0);
+		bus->startStream(info);
+
+		publishStrided(bus, 0, 50);
+
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<SampleBusFrontend> frontend = new SampleBusFrontend(getName("overrun"));
+		frontend->setBackend(backend);
+		frontend->setReportInterval(0);
+		TEST_ASSERT(frontend->open(), "failed to open the bus");
+
+		for (int i = 1; i <= 10; i++)
+			publishStrided(bus, 50 * i, 50);
+		bus->endStream();
+
+		frontend->run();
+
+		// Blocks 1 to 7 are lost, the reader resumes at block 8 (3 blocks
+		// behind the writer).
+		TEST_EQUALS(7, frontend->getOverrunCount(), "overruns not counted");
+		TEST_EQUALS(10, frontend->getMaxLag(), "wrong lag");
+		TEST_EQUALS(3, frontend->getBlockCount(), "wrong number of blocks");
+		TEST_EQUALS(400, frontend->getStreamInfo().startOffset, "wrong start");
+
+		bool ok = (backend->real.size() == 150);
+		for (unsigned i = 0; ok && (i < backend->real.size()); i++)
+			ok = (backend->real[i] == 400 + i) && (backend->imag[i] == 1);
+		TEST_ASSERT(ok, "samples differ");
+	}
+};
+
+RUN_SUITE(SampleBusTest);
+
+
+#endif /* end of include guard: SAMPLEBUSTEST_C9RM4WJT */
+
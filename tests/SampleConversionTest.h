@@ -0,0 +1,103 @@
+/**
+ * \file   SampleConversionTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the sample format conversion.
+ */
+
+#ifndef SAMPLECONVERSIONTEST_Q2VH7R5C
+#define SAMPLECONVERSIONTEST_Q2VH7R5C
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/SampleConversion.h"
+
+
+class SampleConversionTest : public TestCase {
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(SampleConversionTest, testFormats);
+	}
+	
+	/**
+	 * Copies and windows \c span and compares the result with \c expected.
+	 */
+	void testFormat(const SampleSpan &span, const double *expected, const float *window)
+	{
+		int count = span.length;
+		vector<char> stored(count * sizeof(Complex));
+		vector<double> windowed(count * 2);
+		
+		// Copy in two parts to check the offsets.
+		int half = count / 2;
+		int size = getSampleSize(getStorageFormat(span.format));
+		copySamples(span, 0, &(stored[0]), half);
+		copySamples(span, half, &(stored[0]) + half * size, count - half);
+		
+		windowSamples(getStorageFormat(span.format), &(stored[0]), window,
+				    (fftw_complex*)&(windowed[0]), count);
+		
+		for (int i = 0; i < count * 2; i++) {
+			TEST_EQUALS(expected[i], windowed[i],
+					  "converted sample has the wrong value");
+		}
+	}
+	
+	void testFormats()
+	{
+		const int count = 37;
+		
+		vector<double>  doubles(count * 2);
+		vector<float>   floats(count * 2);
+		vector<int16_t> ints(count * 2);
+		vector<float>   real(count), imag(count);
+		vector<float>   window(count);
+		vector<double>  expected(count * 2);
+		
+		for (int i = 0; i < count; i++) {
+			int16_t re = (i * 1297) % 32768 - 16384;
+			int16_t im = -re / 2;
+			
+			doubles[2 * i] = re; doubles[2 * i + 1] = im;
+			floats[2 * i]  = re; floats[2 * i + 1]  = im;
+			ints[2 * i]    = re; ints[2 * i + 1]    = im;
+			real[i] = re;
+			imag[i] = im;
+			
+			window[i] = 0.25f * (i % 4);
+			expected[2 * i]     = (double)re * window[i];
+			expected[2 * i + 1] = (double)im * window[i];
+		}
+		
+		testFormat(SampleSpan(SAMPLE_COMPLEX_DOUBLE, &(doubles[0]), count),
+				 &(expected[0]), &(window[0]));
+		testFormat(SampleSpan(SAMPLE_COMPLEX_FLOAT, &(floats[0]), count),
+				 &(expected[0]), &(window[0]));
+		testFormat(SampleSpan(SAMPLE_PLANAR_FLOAT, &(real[0]), &(imag[0]), count),
+				 &(expected[0]), &(window[0]));
+		
+		// Integers are scaled to the full scale of the floats.
+		for (int i = 0; i < count * 2; i++)
+			expected[i] /= 32768.0;
+		testFormat(SampleSpan(SAMPLE_COMPLEX_INT16, &(ints[0]), count),
+				 &(expected[0]), &(window[0]));
+		
+		// Unsigned 8-bit samples are centered at 127.5.
+		vector<uint8_t> bytes(count * 2);
+		for (int i = 0; i < count * 2; i++) {
+			bytes[i] = (i * 37) % 256;
+			expected[i] = ((double)bytes[i] - 127.5) / 128.0 * window[i / 2];
+		}
+		testFormat(SampleSpan(SAMPLE_COMPLEX_UINT8, &(bytes[0]), count),
+				 &(expected[0]), &(window[0]));
+	}
+};
+
+RUN_SUITE(SampleConversionTest);
+
+
+#endif /* end of include guard: SAMPLECONVERSIONTEST_Q2VH7R5C */
+
@@ -0,0 +1,184 @@
+/**
+ * \file   SharedSpectrumSinkTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the shared-memory spectrum ring.
+ */
+
+#ifndef SHAREDSPECTRUMSINKTEST_H7QC2MVA
+#define SHAREDSPECTRUMSINKTEST_H7QC2MVA
+
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/SharedSpectrumSink.h"
+
+
+class SharedSpectrumSinkTest : public TestCase {
+private:
+	string getName(const char *test)
+	{
+		ostringstream name;
+		name << "/waterfall_test_" << getpid() << "_" << test;
+		return name.str();
+	}
+
+	/**
+	 * Rows of 8 bins (-8 Hz to 6 Hz), 2 per second.
+	 */
+	SpectrumInfo getInfo()
+	{
+		SpectrumInfo info;
+		info.stream.sampleRate = 8;
+		info.stream.timeOffset = WFTime(1000, 0);
+		info.bins = 8;
+		info.fftSampleRate = 2;
+		return info;
+	}
+
+	/**
+	 * A ring of 4 rows.
+	 */
+	Ref<SharedSpectrumSink> createSink(const char *test, float leftFrequency,
+								    float rightFrequency)
+	{
+		Ref<SharedSpectrumSink> sink = new SharedSpectrumSink(
+			getName(test), "test", 2, leftFrequency, rightFrequency);
+		sink->startStream(getInfo());
+		return sink;
+	}
+
+	/**
+	 * Row R bin B has the value 8 R + B.
+	 */
+	void writeRows(Ref<SharedSpectrumSink> sink, int from, int to)
+	{
+		float row[8];
+		for (int i = from; i < to; i++) {
+			for (int j = 0; j < 8; j++) row[j] = 8 * i + j;
+			DataInfo dataInfo;
+			dataInfo.offset = i;
+			dataInfo.timeOffset = WFTime(1000 + i / 2, (i % 2) * 500000);
+			sink->processRow(row, dataInfo);
+		}
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(SharedSpectrumSinkTest, testRows);
+		TEST_ADD(SharedSpectrumSinkTest, testOverrun);
+		TEST_ADD(SharedSpectrumSinkTest, testOwner);
+	}
+
+	void testRows()
+	{
+		Ref<SharedSpectrumSink> sink = createSink("rows", -4, 2);
+
+		SharedSpectrumReader reader;
+		TEST_ASSERT(reader.open(getName("rows")), "failed to open the ring");
+
+		const SharedSpectrumHeader *header = reader.getHeader();
+		TEST_EQUALS(3, header->bins, "wrong band");
+		TEST_EQUALS(4, header->capacity, "wrong capacity");
+		TEST_EQUALS(-4.0, header->leftFrequency, "wrong left frequency");
+		TEST_EQUALS(2.0, header->binFrequency, "wrong bin frequency");
+		TEST_EQUALS(string("test"), string(header->origin), "wrong origin");
+
+		SharedSpectrumRow row;
+		TEST_ASSERT(!reader.acquire(&row), "row before any was written");
+
+		writeRows(sink, 0, 2);
+		TEST_EQUALS(2, reader.getLag(), "wrong lag");
+
+		for (int i = 0; i < 2; i++) {
+			TEST_ASSERT(reader.acquire(&row), "row not read");
+			TEST_EQUALS(i, row.frame, "wrong frame");
+			TEST_EQUALS(1000000000LL + i * 500000, row.time, "wrong time");
+			TEST_EQUALS(8 * i + 2.0f, row.values[0], "wrong value");
+			TEST_EQUALS(8 * i + 4.0f, row.values[2], "wrong value");
+			TEST_ASSERT(reader.release(row), "intact row overwritten");
+		}
+		TEST_ASSERT(!reader.acquire(&row), "row read twice");
+		TEST_EQUALS(0, reader.getOverruns(), "overruns without overwriting");
+
+		// A late reader starts with the oldest rows.
+		SharedSpectrumReader late;
+		TEST_ASSERT(late.open(getName("rows"), true), "failed to open the ring");
+		TEST_ASSERT(late.acquire(&row) && (row.frame == 0), "oldest row not read");
+
+		TEST_ASSERT(!reader.isEnded(), "ended before the end");
+		sink->endStream();
+		TEST_ASSERT(reader.isEnded(), "not ended");
+	}
+
+	void testOverrun()
+	{
+		Ref<SharedSpectrumSink> sink = createSink("overrun", 0, 0);
+
+		SharedSpectrumReader reader;
+		TEST_ASSERT(reader.open(getName("overrun")), "failed to open the ring");
+		TEST_EQUALS(8, reader.getHeader()->bins, "wrong full band");
+
+		writeRows(sink, 0, 1);
+		SharedSpectrumRow row;
+		TEST_ASSERT(reader.acquire(&row), "row not read");
+
+		// Rows 1 to 9, the ring keeps 6 to 9 and row 0 is overwritten
+		// while being read.
+		writeRows(sink, 1, 10);
+		TEST_ASSERT(!reader.release(row), "overwritten row intact");
+		TEST_EQUALS(1, reader.getOverruns(), "overwritten row not counted");
+
+		TEST_ASSERT(reader.acquire(&row), "row not read");
+		TEST_EQUALS(6, row.frame, "lost rows not skipped");
+		TEST_EQUALS(8 * 6 + 7.0f, row.values[7], "wrong value");
+		TEST_ASSERT(reader.release(row), "intact row overwritten");
+		TEST_EQUALS(1 + 5, reader.getOverruns(), "lost rows not counted");
+		TEST_EQUALS(3, reader.getLag(), "wrong lag");
+
+		// A reader of the next stream finds a new ring.
+		sink->startStream(getInfo());
+		TEST_ASSERT(reader.isEnded(), "old ring not ended");
+
+		SharedSpectrumReader next;
+		TEST_ASSERT(next.open(getName("overrun"), true), "failed to open the new ring");
+		TEST_ASSERT(!next.acquire(&row), "rows of the old ring");
+	}
+
+	/**
+	 * A second sink of the same name neither replaces nor removes the ring
+	 * of the first one.
+	 */
+	void testOwner()
+	{
+		Ref<SharedSpectrumSink> sink = createSink("owner", 0, 0);
+		writeRows(sink, 0, 1);
+
+		{
+			Ref<SharedSpectrumSink> other = new SharedSpectrumSink(
+				getName("owner"), "other", 2, 0, 0);
+			other->startStream(getInfo());
+		}
+
+		SharedSpectrumReader reader;
+		TEST_ASSERT(reader.open(getName("owner"), true), "ring of the first sink removed");
+		TEST_EQUALS(string("test"), string(reader.getHeader()->origin),
+				  "ring of the first sink replaced");
+
+		SharedSpectrumRow row;
+		TEST_ASSERT(reader.acquire(&row) && (row.frame == 0), "row not read");
+	}
+};
+
+RUN_SUITE(SharedSpectrumSinkTest);
+
+
+#endif /* end of include guard: SHAREDSPECTRUMSINKTEST_H7QC2MVA */
+
@@ -0,0 +1,101 @@
+/**
+ * \file   SnapshotBench.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Benchmark of writing the FITS snapshots.
+ */
+
+#ifndef SNAPSHOTBENCH_Q3NC8DZV
+#define SNAPSHOTBENCH_Q3NC8DZV
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/SnapshotSink.h"
+#include "Benchmark.h"
+
+
+/**
+ * Removes a directory with the files in it.
+ */
+inline void removeBenchDirectory(const string &path)
+{
+	DIR *dir = opendir(path.c_str());
+	if (dir == NULL) return;
+	
+	struct dirent *entry;
+	while ((entry = readdir(dir)) != NULL) {
+		string name = entry->d_name;
+		if ((name == ".") || (name == "..")) continue;
+		unlink((path + "/" + name).c_str());
+	}
+	closedir(dir);
+	rmdir(path.c_str());
+}
+
+
+/**
+ * The SnapshotSink filling its buffer and writing the FITS files (into a
+ * temporary directory, so the result depends on the file system of
+ * \c TMPDIR). Each snapshot has 100 rows of 4096 bins.
+ */
+inline void benchmarkSnapshots()
+{
+	const int bins = 4096;
+	const int rowsPerSnapshot = 100;
+	const int snapshots = 20;
+	
+	const char *tmp = getenv("TMPDIR");
+	string pattern = string((tmp != NULL) ? tmp : "/tmp") + "/waterfall_bench_XXXXXX";
+	vector<char> path(pattern.begin(), pattern.end());
+	path.push_back('\0');
+	if (mkdtemp(&(path[0])) == NULL) {
+		cerr << "Failed to create a temporary directory for the snapshots." << endl;
+		return;
+	}
+	string directory = &(path[0]);
+	
+	SpectrumInfo info;
+	info.stream.sampleRate = 48000;
+	info.stream.timeOffset = WFTime(1000000000, 0);
+	info.bins = bins;
+	info.fftSampleRate = 10;
+	
+	vector<float> row(bins);
+	for (int i = 0; i < bins; i++) row[i] = (float)(i % 256);
+	
+	vector<double> runs;
+	for (int run = 0; run < BENCHMARK_RUNS; run++) {
+		Ref<SnapshotSink> sink = new SnapshotSink("bench", 10, 0, 0, directory);
+		sink->startStream(info);
+		
+		DataInfo data;
+		Stopwatch stopwatch;
+		for (int i = 0; i < snapshots * rowsPerSnapshot; i++) {
+			// A snapshot per second of the stream time, so the files
+			// have different names.
+			data.timeOffset = WFTime(1000000000 + i / rowsPerSnapshot, 0);
+			sink->processRow(&(row[0]), data);
+		}
+		runs.push_back(stopwatch.seconds());
+		
+		sink->endStream();
+	}
+	
+	removeBenchDirectory(directory);
+	
+	reportBenchmark("SnapshotSink/FITS/bins=4096", (long)snapshots * rowsPerSnapshot,
+				 bins * sizeof(float), medianSeconds(runs), BENCHMARK_RUNS);
+}
+
+
+#endif /* end of include guard: SNAPSHOTBENCH_Q3NC8DZV */
+
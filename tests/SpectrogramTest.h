@@ -0,0 +1,226 @@
+/**
+ * \file   SpectrogramTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the spectrogram renderer and the PNG encoding.
+ */
+
+#ifndef SPECTROGRAMTEST_T5MX8KRD
+#define SPECTROGRAMTEST_T5MX8KRD
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <zlib.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/PNGImage.h"
+#include "../src/SpectrogramRenderer.h"
+
+
+class SpectrogramTest : public TestCase {
+private:
+	static uint32_t readUInt32(const uint8_t *data)
+	{
+		return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+			((uint32_t)data[2] << 8) | (uint32_t)data[3];
+	}
+
+	/**
+	 * Returns the offset of the data of a chunk, or 0 if there is none.
+	 */
+	static size_t findChunk(const vector<uint8_t> &png, const char *type,
+					    uint32_t *length)
+	{
+		size_t offset = 8;
+		while (offset + 12 <= png.size()) {
+			*length = readUInt32(&(png[offset]));
+			if (memcmp(&(png[offset + 4]), type, 4) == 0) return offset + 8;
+			offset += 12 + *length;
+		}
+		return 0;
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(SpectrogramTest, testEncode);
+		TEST_ADD(SpectrogramTest, testScaleDown);
+		TEST_ADD(SpectrogramTest, testLevels);
+		TEST_ADD(SpectrogramTest, testLayout);
+	}
+
+	void testEncode()
+	{
+		PNGImage image(3, 2);
+		for (int y = 0; y < 2; y++) {
+			for (int x = 0; x < 3; x++)
+				image.setPixel(x, y, y * 3 + x + 10);
+		}
+
+		vector<uint8_t> png;
+		image.encode(&png);
+
+		static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+		TEST_ASSERT(memcmp(&(png[0]), signature, 8) == 0, "wrong signature");
+
+		uint32_t length;
+		size_t header = findChunk(png, "IHDR", &length);
+		TEST_ASSERT(header > 0, "no header");
+		TEST_EQUALS(3, readUInt32(&(png[header])), "wrong width");
+		TEST_EQUALS(2, readUInt32(&(png[header + 4])), "wrong height");
+		TEST_EQUALS(0, png[header + 9], "grey scale expected");
+		TEST_ASSERT(findChunk(png, "PLTE", &length) == 0, "no palette expected");
+
+		size_t data = findChunk(png, "IDAT", &length);
+		TEST_ASSERT(data > 0, "no data");
+
+		uint8_t raw[8];
+		uLongf rawLength = sizeof(raw);
+		TEST_EQUALS(Z_OK, uncompress(raw, &rawLength, &(png[data]), length),
+				  "failed to decompress the data");
+		TEST_EQUALS(8, rawLength, "wrong data length");
+
+		static const uint8_t expected[8] = { 0, 10, 11, 12, 0, 13, 14, 15 };
+		TEST_ASSERT(memcmp(raw, expected, 8) == 0, "wrong data");
+
+		uint32_t crc = crc32(0, &(png[data - 4]), length + 4);
+		TEST_EQUALS(crc, readUInt32(&(png[data + length])), "wrong CRC");
+
+		TEST_ASSERT(findChunk(png, "IEND", &length) > 0, "no end");
+
+		// Other colours than grey need a palette.
+		uint8_t palette[3 * 256];
+		memset(palette, 0, sizeof(palette));
+		palette[3 * 255] = 255;
+		image.setPalette(palette);
+		image.encode(&png);
+
+		header = findChunk(png, "IHDR", &length);
+		TEST_EQUALS(3, png[header + 9], "palette expected");
+		TEST_ASSERT(findChunk(png, "PLTE", &length) > 0, "no palette");
+		TEST_EQUALS(3 * 256, length, "wrong palette length");
+	}
+
+	void testScaleDown()
+	{
+		PNGImage image(4, 2);
+		static const uint8_t values[8] = { 0, 10, 100, 200, 20, 30, 50, 51 };
+		for (int i = 0; i < 8; i++)
+			image.setPixel(i % 4, i / 4, values[i]);
+
+		image.scaleDown(2, 1);
+
+		TEST_EQUALS(2, image.getWidth(), "wrong width");
+		TEST_EQUALS(1, image.getHeight(), "wrong height");
+		TEST_EQUALS(15, image.getPixel(0, 0), "wrong average");
+		TEST_EQUALS(100, image.getPixel(1, 0), "wrong rounded average");
+	}
+
+	void testLevels()
+	{
+		float values[6] = { 1, 51, 101, 255, NAN, 0 };
+
+		Spectrogram spectrogram;
+		spectrogram.width = 6;
+		spectrogram.height = 1;
+		spectrogram.data = values;
+
+		SpectrogramRenderer renderer;
+		renderer.setScale(SCALE_IDENTITY);
+
+		PNGImage image;
+		renderer.renderData(spectrogram, &image);
+
+		TEST_EQUALS(6, image.getWidth(), "wrong width");
+		TEST_EQUALS(1, image.getPixel(0, 0), "wrong level");
+		TEST_EQUALS(51, image.getPixel(1, 0), "wrong level");
+		TEST_EQUALS(101, image.getPixel(2, 0), "wrong level");
+		TEST_EQUALS(255, image.getPixel(3, 0), "wrong maximum");
+		TEST_EQUALS(0, image.getPixel(4, 0), "NaN is not the first level");
+		TEST_EQUALS(0, image.getPixel(5, 0), "wrong minimum");
+
+		// The logarithm of zero does not count into the minimum.
+		for (int i = 0; i < 6; i++) values[i] = exp((float)i);
+		values[5] = 0;
+		renderer.setScale(SCALE_LOG);
+		renderer.renderData(spectrogram, &image);
+
+		for (int i = 0; i < 5; i++) {
+			TEST_ASSERT(abs((int)image.getPixel(i, 0) - 255 * i / 4) <= 1,
+					  "wrong logarithmic level");
+		}
+		TEST_EQUALS(0, image.getPixel(5, 0), "wrong level of zero");
+
+		// Cut-offs.
+		renderer.setMin(exp(1.0f));
+		renderer.setMax(exp(3.0f));
+		renderer.renderData(spectrogram, &image);
+
+		TEST_EQUALS(0, image.getPixel(0, 0), "value under the minimum");
+		TEST_ASSERT(abs((int)image.getPixel(2, 0) - 127) <= 1, "wrong cut-off level");
+		TEST_EQUALS(255, image.getPixel(4, 0), "value over the maximum");
+	}
+
+	/**
+	 * 100 bins 100 Hz apart, 50 rows 0.1 s apart starting at 01:00:00 UTC.
+	 */
+	void testLayout()
+	{
+		vector<float> values(100 * 50);
+		for (int y = 0; y < 50; y++) {
+			for (int x = 0; x < 100; x++)
+				values[y * 100 + x] = x;
+		}
+
+		Spectrogram spectrogram;
+		spectrogram.width = 100;
+		spectrogram.height = 50;
+		spectrogram.data = &(values[0]);
+		spectrogram.axes[0] = SpectrogramAxis(1, 0, 100, 100, "FREQ");
+		spectrogram.axes[1] = SpectrogramAxis(1, 3600, 0.1, 50, "TIME");
+		spectrogram.origin = "test";
+
+		SpectrogramRenderer renderer;
+		renderer.setScale(SCALE_IDENTITY);
+
+		PNGImage image;
+		renderer.render(spectrogram, &image);
+
+		// Vertical axis: a "01:00:00" tick label (48 px), a margin of 3 px
+		// and the " TIME" label (30 px) on the left. Horizontal axis: a
+		// "0" tick label and the "FREQ" label (11 px each) with 3 px
+		// margins below. Legend: a line of 11 px with 2 px margins above.
+		TEST_EQUALS(84 + 100, image.getWidth(), "wrong width");
+		TEST_EQUALS(15 + 50 + 28, image.getHeight(), "wrong height");
+
+		TEST_EQUALS(255, image.getPixel(84, 40), "no vertical axis");
+		TEST_EQUALS(255, image.getPixel(150, 15 + 50), "no horizontal axis");
+		TEST_EQUALS(255 * 50 / 99, image.getPixel(84 + 50, 30), "data not in place");
+
+		int label = 0;
+		for (int y = 15; y < 26; y++) {
+			for (int x = 33; x < 81; x++)
+				if (image.getPixel(x, y) == 255) label++;
+		}
+		TEST_ASSERT(label > 20, "no time label");
+
+		int legend = 0;
+		for (int y = 0; y < 15; y++) {
+			for (int x = 84; x < 184; x++)
+				if (image.getPixel(x, y) == 255) legend++;
+		}
+		TEST_ASSERT(legend > 20, "no legend");
+	}
+};
+
+RUN_SUITE(SpectrogramTest);
+
+
+#endif /* end of include guard: SPECTROGRAMTEST_T5MX8KRD */
+
@@ -0,0 +1,201 @@
+/**
+ * \file   TileSinkTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the tile pyramid sink.
+ */
+
+#ifndef TILESINKTEST_F3KW7QZN
+#define TILESINKTEST_F3KW7QZN
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/TileSink.h"
+
+
+class TileSinkTest : public TestCase {
+private:
+	/// Tiles of 4 x 4 values.
+	static const int TILE = 4;
+
+	/**
+	 * Returns a mean (or a maximum) of tile (tileRow, column) of a level
+	 * with \c columns columns.
+	 */
+	float readTile(const string &path, int level, int columns, long tileRow,
+			     int column, int row, int bin, bool max)
+	{
+		ostringstream name;
+		name << path << "/level_" << level << ".tiles";
+
+		long offset = ((tileRow * columns + column) * 2 * TILE * TILE +
+					(max ? TILE * TILE : 0) + row * TILE + bin) * sizeof(float);
+
+		float value = -1;
+		FILE *file = fopen(name.str().c_str(), "rb");
+		if (file == NULL) return value;
+		if ((fseek(file, offset, SEEK_SET) != 0) || (fread(&value, sizeof(value), 1, file) != 1))
+			value = -1;
+		fclose(file);
+		return value;
+	}
+
+	TileIndexEntry readIndex(const string &path, int level, long tileRow)
+	{
+		ostringstream name;
+		name << path << "/level_" << level << ".index";
+
+		TileIndexEntry entry;
+		entry.time = -1;
+		entry.rows = -1;
+		FILE *file = fopen(name.str().c_str(), "rb");
+		if (file == NULL) return entry;
+		if ((fseek(file, tileRow * sizeof(entry), SEEK_SET) != 0) ||
+		    (fread(&entry, sizeof(entry), 1, file) != 1))
+			entry.rows = -1;
+		fclose(file);
+		return entry;
+	}
+
+	/**
+	 * Rows of 8 bins, row R bin B has the value 8 R + B, 2 rows per second
+	 * starting at 1000 s. Rows from \c skipFrom to \c skipTo are left out.
+	 */
+	string writeRows(const string &directory, int count, long skipFrom = -1,
+				  long skipTo = -1)
+	{
+		SpectrumInfo info;
+		info.stream.sampleRate = 8;
+		info.stream.timeOffset = WFTime(1000, 0);
+		info.bins = 8;
+		info.fftSampleRate = 2;
+
+		Ref<TileSink> sink = new TileSink("test", TILE, 3, 0, 0, directory);
+		TEST_EQUALS(16, sink->getRowAlignment(info), "wrong row alignment");
+
+		sink->startStream(info);
+
+		float row[8];
+		for (int i = 0; i < count; i++) {
+			if ((i >= skipFrom) && (i < skipTo)) continue;
+
+			for (int j = 0; j < 8; j++) row[j] = 8 * i + j;
+			DataInfo dataInfo;
+			dataInfo.offset = i;
+			dataInfo.timeOffset = WFTime(1000 + i / 2, (i % 2) * 500000);
+			sink->processRow(row, dataInfo);
+		}
+
+		sink->endStream();
+		return sink->getPath();
+	}
+
+	void removePyramid(const string &path)
+	{
+		for (int i = 0; i < 3; i++) {
+			ostringstream name;
+			name << path << "/level_" << i;
+			unlink((name.str() + ".tiles").c_str());
+			unlink((name.str() + ".index").c_str());
+		}
+		unlink((path + "/tiles.txt").c_str());
+		rmdir(path.c_str());
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(TileSinkTest, testLevels);
+		TEST_ADD(TileSinkTest, testDroppedRows);
+	}
+
+	/**
+	 * 18 rows: 4 full tile rows and a partial one in level 0, 2 tile rows
+	 * of 4 bins in level 1 and a full and a partial one of 2 bins in level 2.
+	 */
+	void testLevels()
+	{
+		char directory[] = "/tmp/waterfall_test_XXXXXX";
+		TEST_ASSERT(mkdtemp(directory) != NULL, "failed to create a temporary directory");
+
+		string path = writeRows(directory, 18);
+
+		struct stat st;
+		TEST_ASSERT(stat((path + "/tiles.txt").c_str(), &st) == 0, "no description");
+		TEST_ASSERT(path.find("tiles_test_") != string::npos, "wrong pyramid name");
+
+		// Level 0: the rows as they are.
+		TEST_EQUALS(8 * 2 + 5, readTile(path, 0, 2, 0, 1, 2, 1, false), "wrong value");
+		TEST_EQUALS(8 * 2 + 5, readTile(path, 0, 2, 0, 1, 2, 1, true), "wrong maximum");
+		TEST_EQUALS(8 * 17 + 3, readTile(path, 0, 2, 4, 0, 1, 3, false), "wrong partial value");
+		TEST_ASSERT(isnan(readTile(path, 0, 2, 4, 0, 2, 0, false)), "missing row not NaN");
+		TEST_EQUALS(4, readIndex(path, 0, 3).rows, "wrong rows of a full tile row");
+		TEST_EQUALS(2, readIndex(path, 0, 4).rows, "wrong rows of a partial tile row");
+		TEST_EQUALS(1008000000LL, readIndex(path, 0, 4).time, "wrong tile row time");
+
+		// Level 1: 2 x 2 bins, mean 16 R + 2 B + 4.5, maximum 16 R + 2 B + 9.
+		for (int row = 0; row < 4; row++) {
+			for (int bin = 0; bin < 4; bin++) {
+				TEST_EQUALS(16 * row + 2 * bin + 4.5f,
+						  readTile(path, 1, 1, 0, 0, row, bin, false), "wrong level 1 mean");
+				TEST_EQUALS(16 * row + 2 * bin + 9.0f,
+						  readTile(path, 1, 1, 0, 0, row, bin, true), "wrong level 1 maximum");
+			}
+		}
+
+		// Level 2: 4 x 4 bins, mean 32 R + 4 B + 13.5, maximum 32 R + 4 B + 27.
+		TEST_EQUALS(32 * 3 + 4 + 13.5f, readTile(path, 2, 1, 0, 0, 3, 1, false),
+				  "wrong level 2 mean");
+		TEST_EQUALS(32 * 3 + 4 + 27.0f, readTile(path, 2, 1, 0, 0, 3, 1, true),
+				  "wrong level 2 maximum");
+		TEST_ASSERT(isnan(readTile(path, 2, 1, 0, 0, 0, 2, false)), "padding not NaN");
+		TEST_EQUALS(1000000000LL, readIndex(path, 2, 0).time, "wrong level 2 time");
+
+		// The last 2 rows alone.
+		TEST_EQUALS(133.5f + 4, readTile(path, 2, 1, 1, 0, 0, 1, false),
+				  "wrong mean of the last rows");
+		TEST_EQUALS(1, readIndex(path, 2, 1).rows, "wrong rows of the last tile row");
+
+		removePyramid(path);
+		rmdir(directory);
+	}
+
+	/**
+	 * Rows 3 and 4 are missing: rows 2 and 5 go to level 1 without their
+	 * pairs.
+	 */
+	void testDroppedRows()
+	{
+		char directory[] = "/tmp/waterfall_test_XXXXXX";
+		TEST_ASSERT(mkdtemp(directory) != NULL, "failed to create a temporary directory");
+
+		string path = writeRows(directory, 8, 3, 5);
+
+		TEST_ASSERT(isnan(readTile(path, 0, 2, 0, 0, 3, 0, false)), "dropped row not NaN");
+		TEST_EQUALS(8 * 2 + 2 + 0.5f, readTile(path, 1, 1, 0, 0, 1, 1, false),
+				  "wrong mean of a row without its pair");
+		TEST_EQUALS(8 * 5 + 2 + 0.5f, readTile(path, 1, 1, 0, 0, 2, 1, false),
+				  "wrong mean of a row without its pair");
+		TEST_EQUALS(8 * 7 + 3.0f, readTile(path, 1, 1, 0, 0, 3, 1, true),
+				  "wrong maximum after the dropped rows");
+
+		removePyramid(path);
+		rmdir(directory);
+	}
+};
+
+RUN_SUITE(TileSinkTest);
+
+
+#endif /* end of include guard: TILESINKTEST_F3KW7QZN */
+
@@ -0,0 +1,131 @@
+/**
+ * \file   TraceTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the trace.
+ */
+
+#ifndef TRACETEST_W5JX2RBH
+#define TRACETEST_W5JX2RBH
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/Trace.h"
+
+
+class TraceTest : public TestCase {
+private:
+	/**
+	 * \brief Records numbered events from its own thread.
+	 */
+	class Worker {
+	public:
+		void* work()
+		{
+			Trace::setThreadName("worker");
+			// Events at 0, 1, 2... microseconds.
+			for (int i = 0; i < 100; i++)
+				Trace::record(TRACE_SNAPSHOT_WRITE, i * 1000, i * 1000 + 500);
+			return NULL;
+		}
+	};
+
+	static int countOf(const string &text, const string &pattern)
+	{
+		int count = 0;
+		for (size_t i = text.find(pattern); i != string::npos; i = text.find(pattern, i + 1))
+			count++;
+		return count;
+	}
+
+	string runWorker(double seconds)
+	{
+		Worker worker;
+		MethodThread<void, Worker> thread(&worker, &Worker::work);
+		thread.join();
+
+		stringstream output;
+		Trace::write(output, seconds);
+		return output.str();
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(TraceTest, testRing);
+		TEST_ADD(TraceTest, testCutoff);
+		TEST_ADD(TraceTest, testWriter);
+	}
+
+	/**
+	 * Only the last events of a thread are kept.
+	 */
+	void testRing()
+	{
+		Trace::setEnabled(true, 16);
+		string trace = runWorker(0);
+		Trace::setEnabled(false);
+
+		TEST_EQUALS(16, countOf(trace, "\"snapshot_write\""), "wrong number of events");
+		TEST_ASSERT(trace.find("\"ts\": 99.000, \"dur\": 0.500") != string::npos,
+				  "last event missing");
+		TEST_ASSERT(trace.find("\"ts\": 84.000") != string::npos, "first kept event missing");
+		TEST_ASSERT(trace.find("\"ts\": 83.000") == string::npos, "overwritten event written");
+		TEST_ASSERT(trace.find("\"args\": {\"name\": \"worker ") != string::npos,
+				  "thread name missing");
+		TEST_ASSERT(trace.find("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [") == 0,
+				  "wrong header");
+	}
+
+	/**
+	 * Events which ended before the requested length of the trace are left
+	 * out.
+	 */
+	void testCutoff()
+	{
+		Trace::setEnabled(true, 16);
+		string trace = runWorker(1);
+		Trace::setEnabled(false);
+
+		TEST_EQUALS(0, countOf(trace, "\"snapshot_write\""), "old events written");
+	}
+
+	void testWriter()
+	{
+		char fileName[] = "/tmp/waterfall_test_XXXXXX";
+		int fd = mkstemp(fileName);
+		TEST_ASSERT(fd >= 0, "failed to create a temporary file");
+		close(fd);
+
+		Trace::setEnabled(true, 16);
+		Ref<TraceWriter> writer = new TraceWriter(fileName, 0);
+		writer->start();
+		{
+			TraceScope scope(TRACE_FFT);
+		}
+		writer->stop();
+		Trace::setEnabled(false);
+
+		ifstream input(fileName);
+		string contents((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+		unlink(fileName);
+
+		TEST_ASSERT(contents.find("\"name\": \"fft\"") != string::npos,
+				  "event missing from the trace file");
+		TEST_ASSERT(contents.find("]}") != string::npos, "trace file not complete");
+	}
+};
+
+RUN_SUITE(TraceTest);
+
+
+#endif /* end of include guard: TRACETEST_W5JX2RBH */
+
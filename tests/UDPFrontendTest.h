@@ -0,0 +1,192 @@
+/**
+ * \file   UDPFrontendTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the UDP frontend.
+ */
+
+#ifndef UDPFRONTENDTEST_H3TW8QZB
+#define UDPFRONTENDTEST_H3TW8QZB
+
+#include <stdint.h>
+#include <cstring>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/UDPFrontend.h"
+
+
+class UDPFrontendTest : public TestCase {
+private:
+	/// Samples in a packet.
+	static const int PACKET_SAMPLES = 100;
+
+	/**
+	 * \brief Sends packets of the sample positions given to the frontend
+	 *        over loopback.
+	 */
+	class Sender {
+	private:
+		int                 port_;
+		const vector<long> &indices_;
+
+	public:
+		Sender(int port, const vector<long> &indices) :
+			port_(port), indices_(indices) {}
+
+		void* send()
+		{
+			int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+			struct sockaddr_in remote;
+			memset(&remote, 0, sizeof(remote));
+			remote.sin_family = AF_INET;
+			remote.sin_port = htons(port_);
+			remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+			vector<char> packet(sizeof(UDPPacketHeader) + PACKET_SAMPLES * 4);
+
+			for (unsigned i = 0; i < indices_.size(); i++) {
+				// Little-endian header (as is the test host).
+				UDPPacketHeader header;
+				header.magic = UDP_PACKET_MAGIC;
+				header.sequence = i;
+				header.sampleIndex = indices_[i];
+				memcpy(&(packet[0]), &header, sizeof(header));
+
+				int16_t *samples = (int16_t*)&(packet[sizeof(header)]);
+				for (int j = 0; j < PACKET_SAMPLES; j++) {
+					samples[2 * j]     = (int16_t)(indices_[i] + j);
+					samples[2 * j + 1] = 1;
+				}
+
+				sendto(fd, &(packet[0]), packet.size(), 0,
+					  (struct sockaddr*)&remote, sizeof(remote));
+				usleep(1000);
+			}
+
+			close(fd);
+			return NULL;
+		}
+	};
+
+	class CollectingBackend : public Backend {
+	public:
+		vector<int16_t> samples;
+		bool            offsetsOk;
+
+		CollectingBackend() : offsetsOk(true) {}
+
+		virtual void process(const SampleSpan &data, DataInfo info)
+		{
+			if (info.offset != (long)samples.size() / 2)
+				offsetsOk = false;
+
+			const int16_t *values = (const int16_t*)data.data;
+			samples.insert(samples.end(), values, values + 2 * data.length);
+		}
+	};
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(UDPFrontendTest, testLoss);
+		TEST_ADD(UDPFrontendTest, testRestart);
+	}
+
+	/**
+	 * Receives packets with a lost, a duplicate and a late one, checks
+	 * that the gap is filled with zeros and the counters.
+	 */
+	void testLoss()
+	{
+		// Starts at 1000 (the frontend counts from the first packet),
+		// 1300 is lost, 1100 is sent twice and 1200 late.
+		long order[] = { 1000, 1100, 1100, 1400, 1200, 1500 };
+		vector<long> indices(order, order + 6);
+
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+
+		Ref<UDPFrontend> frontend =
+			new UDPFrontend("127.0.0.1", 0, SAMPLE_COMPLEX_INT16, 100000, 16);
+		frontend->setBackend(backendRef);
+		frontend->setTimeout(0.3);
+		TEST_ASSERT(frontend->open(), "failed to open the socket");
+
+		Sender sender(frontend->getPort(), indices);
+		MethodThread<void, Sender> thread(&sender, &Sender::send);
+
+		frontend->run();
+		thread.join();
+
+		TEST_EQUALS(6, frontend->getPacketCount(), "wrong number of packets");
+		TEST_EQUALS(2, frontend->getLatePacketCount(), "wrong number of late packets");
+		TEST_EQUALS(200, frontend->getLostSampleCount(), "wrong number of lost samples");
+		TEST_ASSERT(backend->offsetsOk, "wrong offset of a block");
+		TEST_EQUALS(2 * 600, backend->samples.size(), "wrong number of samples");
+
+		bool ok = true;
+		for (int i = 0; i < 600; i++) {
+			bool lost = (i >= 200) && (i < 400);
+			int16_t re = lost ? 0 : (int16_t)(1000 + i);
+			int16_t im = lost ? 0 : 1;
+			if ((backend->samples[2 * i] != re) || (backend->samples[2 * i + 1] != im))
+				ok = false;
+		}
+		TEST_ASSERT(ok, "samples differ");
+	}
+
+	/**
+	 * The sender restarts from 0 after 1100, then 50 comes late. The
+	 * stream goes on with the new positions.
+	 */
+	void testRestart()
+	{
+		long order[] = { 1000, 1100, 0, 100, 50 };
+		vector<long> indices(order, order + 5);
+
+		CollectingBackend *backend = new CollectingBackend();
+		Ref<Backend> backendRef = backend;
+
+		Ref<UDPFrontend> frontend =
+			new UDPFrontend("127.0.0.1", 0, SAMPLE_COMPLEX_INT16, 100000, 16);
+		frontend->setBackend(backendRef);
+		frontend->setTimeout(0.3);
+		frontend->setMaxGapFill(500);
+		TEST_ASSERT(frontend->open(), "failed to open the socket");
+
+		Sender sender(frontend->getPort(), indices);
+		MethodThread<void, Sender> thread(&sender, &Sender::send);
+
+		frontend->run();
+		thread.join();
+
+		TEST_EQUALS(1, frontend->getRestartCount(), "restart not detected");
+		TEST_EQUALS(1, frontend->getLatePacketCount(), "wrong number of late packets");
+		TEST_EQUALS(0, frontend->getLostSampleCount(), "wrong number of lost samples");
+		TEST_ASSERT(backend->offsetsOk, "wrong offset of a block");
+		TEST_EQUALS(2 * 400, backend->samples.size(), "wrong number of samples");
+
+		bool ok = true;
+		for (int i = 0; i < 400; i++) {
+			int16_t re = (int16_t)((i < 200) ? 1000 + i : i - 200);
+			if (backend->samples[2 * i] != re) ok = false;
+		}
+		TEST_ASSERT(ok, "samples differ");
+	}
+};
+
+RUN_SUITE(UDPFrontendTest);
+
+
+#endif /* end of include guard: UDPFRONTENDTEST_H3TW8QZB */
+
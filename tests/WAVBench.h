@@ -0,0 +1,130 @@
+/**
+ * \file   WAVBench.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Throughput benchmarks of the WAV readers and the sample
+ *         conversion.
+ */
+
+#ifndef WAVBENCH_N4QG8HUE
+#define WAVBENCH_N4QG8HUE
+
+#include <cstdlib>
+#include <unistd.h>
+
+#include <sstream>
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/WAVStream.h"
+#include "../src/MappedWAVFrontend.h"
+#include "../src/SampleConversion.h"
+#include "Benchmark.h"
+#include "MappedWAVFrontendTest.h"
+
+
+/**
+ * \brief Backend that only sums the samples (so that all of them are read).
+ */
+class SummingBackend : public Backend {
+public:
+	long sum;
+	long frames;
+	
+	SummingBackend() : sum(0), frames(0) {}
+	
+	virtual void process(const SampleSpan &data, DataInfo info)
+	{
+		const int16_t *values = (const int16_t*)data.data;
+		for (int i = 0; i < 2 * data.length; i++)
+			sum += values[i];
+		frames += data.length;
+	}
+};
+
+
+inline void benchmarkWAVReader(const string &name, Ref<Frontend> frontend, long frames)
+{
+	SummingBackend *backend = new SummingBackend();
+	frontend->setBackend(backend);
+	
+	Stopwatch stopwatch;
+	frontend->run();
+	double seconds = stopwatch.seconds();
+	
+	if (backend->frames != frames)
+		cerr << name << ": read " << backend->frames << " of " << frames << " frames!" << endl;
+	
+	reportBenchmark(name, frames, 4, seconds);
+}
+
+
+/**
+ * The file is read right after it is written, so it is in the page cache
+ * and the benchmark measures the reading and conversion overhead, not the
+ * disk.
+ */
+inline void benchmarkWAVReaders()
+{
+	const long frames = 64L * 1024 * 1024;
+	
+	char fileName[] = "/tmp/waterfall_bench_XXXXXX";
+	int fd = mkstemp(fileName);
+	if (fd < 0) return;
+	close(fd);
+	
+	if (!writeTestWAV(fileName, frames, 48000)) {
+		cerr << "Failed to write " << fileName << endl;
+		unlink(fileName);
+		return;
+	}
+	
+	benchmarkWAVReader("WAVStream", new WAVStream(new FileInput(fileName)), frames);
+	
+	int blockSizes[] = { 1024, 65536, 1048576 };
+	for (unsigned i = 0; i < sizeof(blockSizes) / sizeof(blockSizes[0]); i++) {
+		ostringstream name;
+		name << "MappedWAVFrontend/block=" << blockSizes[i];
+		benchmarkWAVReader(name.str(), new MappedWAVFrontend(fileName, blockSizes[i]), frames);
+	}
+	
+	unlink(fileName);
+}
+
+
+/**
+ * Windowing (conversion to complex doubles) of blocks of 32768 samples.
+ */
+inline void benchmarkSampleConversion()
+{
+	const int  bins = 32768;
+	const long iterations = 4000;
+	
+	vector<char>   samples(bins * sizeof(Complex), 1);
+	vector<float>  window(bins, 0.5f);
+	vector<double> output(2 * bins);
+	
+	SampleFormat formats[] = {
+		SAMPLE_COMPLEX_INT16, SAMPLE_COMPLEX_FLOAT, SAMPLE_COMPLEX_DOUBLE
+	};
+	const char *names[] = {
+		"windowSamples/int16", "windowSamples/float", "windowSamples/double"
+	};
+	
+	for (unsigned i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+		Stopwatch stopwatch;
+		for (long j = 0; j < iterations; j++) {
+			windowSamples(formats[i], &(samples[0]), &(window[0]),
+					    (fftw_complex*)&(output[0]), bins);
+		}
+		reportBenchmark(names[i], iterations * bins, getSampleSize(formats[i]),
+					 stopwatch.seconds());
+	}
+}
+
+
+#endif /* end of include guard: WAVBENCH_N4QG8HUE */
+
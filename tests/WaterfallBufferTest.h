@@ -0,0 +1,126 @@
+/**
+ * \file   WaterfallBufferTest.h
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Tests of the placement of the rows in the snapshot buffer.
+ */
+
+#ifndef WATERFALLBUFFERTEST_T6JD2MWA
+#define WATERFALLBUFFERTEST_T6JD2MWA
+
+#include <cmath>
+#include <vector>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "../src/WaterfallBackend.h"
+
+
+class WaterfallBufferTest : public TestCase {
+private:
+	/// A snapshot written out of the buffer.
+	struct Snapshot {
+		long          start;
+		vector<float> values;
+		vector<long>  times;
+	};
+
+	/**
+	 * Adds rows of 2 bins to a buffer of 4 rows like SnapshotSink does, row
+	 * R has the value R, 2 rows per second starting at 1000 s. The rows
+	 * in \c dropped are left out.
+	 */
+	vector<Snapshot> writeRows(int count, const vector<long> &dropped)
+	{
+		WaterfallBuffer buffer(4, 2);
+		vector<Snapshot> snapshots;
+
+		for (long i = 0; i < count; i++) {
+			if (find(dropped.begin(), dropped.end(), i) != dropped.end()) continue;
+
+			WFTime time(1000 + i / 2, (i % 2) * 500000);
+			float *row = buffer.placeRow(i, time, 2);
+			if (row == NULL) {
+				writeSnapshot(&buffer, &snapshots);
+				row = buffer.placeRow(i, time, 2);
+			}
+			row[0] = row[1] = i;
+
+			if (buffer.isFull()) writeSnapshot(&buffer, &snapshots);
+		}
+
+		if (buffer.mark > 0) writeSnapshot(&buffer, &snapshots);
+		return snapshots;
+	}
+
+	void writeSnapshot(WaterfallBuffer *buffer, vector<Snapshot> *snapshots)
+	{
+		Snapshot snapshot;
+		snapshot.start = buffer->start;
+		for (int i = 0; i < buffer->mark; i++) {
+			snapshot.values.push_back(buffer->getRow(i)[0]);
+			snapshot.times.push_back(buffer->times[i].seconds() * 1000000L +
+								buffer->times[i].microseconds());
+		}
+		snapshots->push_back(snapshot);
+		buffer->rewind();
+	}
+
+public:
+	virtual void initTests()
+	{
+		TEST_ADD(WaterfallBufferTest, testContiguous);
+		TEST_ADD(WaterfallBufferTest, testDroppedRows);
+	}
+
+	void testContiguous()
+	{
+		vector<Snapshot> snapshots = writeRows(10, vector<long>());
+
+		TEST_EQUALS(3, snapshots.size(), "wrong number of snapshots");
+		TEST_EQUALS(8, snapshots[2].start, "wrong start of the last snapshot");
+		TEST_EQUALS(2, snapshots[2].values.size(), "wrong length of the last snapshot");
+		TEST_EQUALS(5, snapshots[1].values[1], "wrong row");
+	}
+
+	/**
+	 * Row 2 is dropped inside the first snapshot, rows 4 to 6 between the
+	 * first and the second one and rows 9 to 11 past the end of the second
+	 * one.
+	 */
+	void testDroppedRows()
+	{
+		long droppedRows[] = { 2, 4, 5, 6, 9, 10, 11 };
+		vector<long> dropped(droppedRows, droppedRows + 7);
+		vector<Snapshot> snapshots = writeRows(14, dropped);
+
+		TEST_EQUALS(3, snapshots.size(), "wrong number of snapshots");
+
+		// The gap is left blank, the times of all of the rows follow the
+		// first one.
+		TEST_EQUALS(0, snapshots[0].start, "wrong start");
+		TEST_EQUALS(4, snapshots[0].values.size(), "wrong length");
+		TEST_ASSERT(isnan(snapshots[0].values[2]), "dropped row not blank");
+		TEST_EQUALS(3, snapshots[0].values[3], "row after the gap moved");
+		for (int i = 0; i < 4; i++)
+			TEST_EQUALS(1000000000L + i * 500000L, snapshots[0].times[i], "wrong time");
+
+		// A snapshot starts at the first row after a gap, and ends before a
+		// row which doesn't fit into it.
+		TEST_EQUALS(7, snapshots[1].start, "wrong start after the gap");
+		TEST_EQUALS(2, snapshots[1].values.size(), "wrong length before the gap");
+		TEST_EQUALS(7, snapshots[1].values[0], "wrong first row after the gap");
+		TEST_EQUALS(1003500000L, snapshots[1].times[0], "wrong time after the gap");
+
+		TEST_EQUALS(12, snapshots[2].start, "wrong start of the last snapshot");
+		TEST_EQUALS(12, snapshots[2].values[0], "wrong first row of the last snapshot");
+		TEST_EQUALS(1006000000L, snapshots[2].times[0], "wrong time of the last snapshot");
+	}
+};
+
+RUN_SUITE(WaterfallBufferTest);
+
+
+#endif /* end of include guard: WATERFALLBUFFERTEST_T6JD2MWA */
@@ -0,0 +1,56 @@
+/**
+ * \file   bench.cpp
+ * \author Jan Milík <milikjan@fit.cvut.cz>
+ * \date   2026-10-19
+ *
+ * \brief  Benchmark program entry point.
+ *
+ * Run with \c --json to print the results as JSON lines (the first line
+ * describes the build), which can be compared by the \c benchcmp script.
+ */
+
+
+#include <string.h>
+#include <time.h>
+
+#include <cppapp/cppapp.h>
+using namespace cppapp;
+
+#include "RingBufferBench.h"
+#include "WAVBench.h"
+#include "DSPBench.h"
+#include "SnapshotBench.h"
+
+
+int main(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0) {
+			benchmarkJSON() = true;
+		} else {
+			cerr << "Usage: " << argv[0] << " [--json]" << endl;
+			return 1;
+		}
+	}
+	
+	if (benchmarkJSON()) {
+		char date[32];
+		time_t now = time(NULL);
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+		cout << "{\"date\": " << quoteJSON(date)
+		     << ", \"compiler\": " << quoteJSON(__VERSION__)
+		     << ", \"runs\": " << BENCHMARK_RUNS << "}" << endl;
+	}
+	
+	benchmarkRingBuffers();
+	benchmarkFragmentedRingBuffer();
+	benchmarkWAVReaders();
+	benchmarkSampleConversion();
+	benchmarkFFTBackend();
+	benchmarkMagnitude();
+	benchmarkWaterfallBuffer();
+	benchmarkSnapshots();
+	
+	return 0;
+}
+
@@ -11,6 +11,26 @@
 using namespace cppapp;
 
 #include "RingBufferTest.h"
+#include "SPSCRingBufferTest.h"
+#include "AllocationTest.h"
+#include "SampleConversionTest.h"
+#include "FFTBackendTest.h"
+#include "MappedWAVFrontendTest.h"
+#include "ParallelWAVFrontendTest.h"
+#include "BatchTest.h"
+#include "RawIQFrontendTest.h"
+#include "UDPFrontendTest.h"
+#include "GeneratorFrontendTest.h"
+#include "ClockTest.h"
+#include "MetricsTest.h"
+#include "TraceTest.h"
+#include "PerfCountersTest.h"
+#include "DeadlineMonitorTest.h"
+#include "SpectrogramTest.h"
+#include "TileSinkTest.h"
+#include "WaterfallBufferTest.h"
+#include "SharedSpectrumSinkTest.h"
+#include "SampleBusTest.h"
 
 
 //class App : public AppBase {